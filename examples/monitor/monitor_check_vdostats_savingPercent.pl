@@ -20,6 +20,7 @@
 #
 # monitor_check_vdostats_savingPercent.pl [--warning <warn_pct>|-w <warn_pct>]
 #                                         [--critical <crit_pct>|-c <crit_pct>]
+#                                         [--metrics-file <file>|-m <file>]
 #                                         <deviceName>
 #
 # This script parses the output of "vdostats --verbose" for a given VDO
@@ -34,7 +35,12 @@
 # -w <warn_pct>: warning threshold equal to or less than
 #                <crit_pct> percent.
 #
-# The "vdostats" program must be in the path used by "sudo".
+# -m <file>:     read the statistics from a metrics file kept up to date by
+#                "vdostats --interval <seconds> --metrics-file <file>" instead
+#                of running "vdostats --verbose" for each check.
+#
+# Unless a metrics file is given, the "vdostats" program must be in the
+# path used by "sudo".
 #
 # $Id: //eng/vdo-releases/aluminum/src/tools/monitor/monitor_check_vdostats_savingPercent.pl#2 $
 #
@@ -54,9 +60,11 @@ use constant {
 
 my $inputWarnThreshold = -1;
 my $inputCritThreshold = -1;
+my $metricsFile        = "";
 
-GetOptions("critical=i" => \$inputCritThreshold,
-           "warning=i"  => \$inputWarnThreshold);
+GetOptions("critical=i"     => \$inputCritThreshold,
+           "warning=i"      => \$inputWarnThreshold,
+           "metrics-file=s" => \$metricsFile);
 
 # Default warning and critical thresholds for "logical used percent".
 my $warnThreshold = 50;
@@ -87,6 +95,31 @@ my @statNames = (
   '1k-blocks available',
 );
 
+#############################################################################
+# Get the desired stats values for the given VDO device name from a metrics
+# file written by "vdostats --interval". Each line of the file has the form
+# 'vdo_<label>{device="<deviceName>"} <value>', or for text values,
+# 'vdo_<label>{device="<deviceName>",value="<value>"} 1'.
+##
+sub getMetrics {
+  my ($deviceName) = @_;
+  open(my $metrics, '<', $metricsFile) or return;
+  my @metricLines = <$metrics>;
+  close($metrics);
+  foreach my $statLabel (@statNames) {
+    (my $metricName = lc($statLabel)) =~ s/[^a-z0-9]+/_/g;
+    $metricName =~ s/^_+|_+$//g;
+    $metricName = "vdo_" . $metricName;
+    foreach my $inpline (@metricLines) {
+      if ($inpline =~ /^\Q$metricName\E\{device="\Q$deviceName\E"
+                       (?:,value="(.*)")?\}\s(\S+)$/x) {
+        my $statValue = defined($1) ? $1 : $2;
+        $stats{$statLabel} = ($statValue eq "NaN") ? "N/A" : $statValue;
+      }
+    }
+  }
+}
+
 #############################################################################
 # Get the statistics output for the given VDO device name, and filter the
 # desired stats values.
@@ -96,6 +129,10 @@ sub getStats {
     return;
   }
   my $deviceName = $ARGV[0];
+  if ($metricsFile) {
+    getMetrics($deviceName);
+    return;
+  }
   my @verboseStatsOutput = `sudo vdostats $deviceName --verbose`;
   foreach my $statLabel (@statNames) {
     foreach my $inpline (@verboseStatsOutput) {
@@ -115,6 +152,7 @@ if (scalar(@ARGV) != 1) {
   print("Usage: monitor_check_vdostats_savingPercent.pl\n");
   print("                [--warning |-w VALUE]\n");
   print("                [--critical|-c VALUE]\n");
+  print("                [--metrics-file|-m FILE]\n");
   print("                <deviceName>\n");
   exit(MONITOR_SERVICE_UNKNOWN);
 }
@@ -81,6 +81,16 @@ bool areUdsConfigurationsEqual(UdsConfiguration a, UdsConfiguration b)
              a->nonce, b->nonce);
     result = false;
   }
+  if (a->recordPageHints != b->recordPageHints) {
+    logError("Record page hints (%u) does not match (%u)",
+             a->recordPageHints, b->recordPageHints);
+    result = false;
+  }
+  if (a->metadataSize != b->metadataSize) {
+    logError("Metadata size (%u) does not match (%u)",
+             a->metadataSize, b->metadataSize);
+    result = false;
+  }
   return result;
 }
 
@@ -96,4 +106,6 @@ void logUdsConfiguration(UdsConfiguration conf)
   logDebug("  Bytes per page:             %10u", conf->bytesPerPage);
   logDebug("  Sparse sample rate:         %10u", conf->sparseSampleRate);
   logDebug("  Nonce:                      %" PRIu64, conf->nonce);
+  logDebug("  Record page hints:          %10u", conf->recordPageHints);
+  logDebug("  Metadata size:              %10u", conf->metadataSize);
 }
@@ -56,6 +56,10 @@ struct udsConfiguration {
   unsigned int sparseSampleRate;
   /** Index Owner's nonce */
   UdsNonce     nonce;
+  /** Whether master index entries record the record page of their name */
+  unsigned int recordPageHints;
+  /** The number of bytes of metadata stored in each record */
+  unsigned int metadataSize;
 };
 
 /**
@@ -34,12 +34,25 @@ static int initializeGeometry(Geometry    *geometry,
                               size_t       bytesPerPage,
                               unsigned int recordPagesPerChapter,
                               unsigned int chaptersPerVolume,
-                              unsigned int sparseChaptersPerVolume)
+                              unsigned int sparseChaptersPerVolume,
+                              unsigned int metadataSize)
 {
-  int result = ASSERT_WITH_ERROR_CODE(bytesPerPage >= BYTES_PER_RECORD,
-                                      UDS_BAD_STATE,
-                                      "page is smaller than a record: %zu",
-                                      bytesPerPage);
+  int result
+    = ASSERT_WITH_ERROR_CODE(((metadataSize == UDS_MAX_METADATA_SIZE)
+                              || (metadataSize == UDS_COMPACT_METADATA_SIZE)),
+                             UDS_INVALID_ARGUMENT,
+                             "metadata size (%u) must be %u or %u",
+                             metadataSize, UDS_MAX_METADATA_SIZE,
+                             UDS_COMPACT_METADATA_SIZE);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  unsigned int bytesPerRecord = UDS_CHUNK_NAME_SIZE + metadataSize;
+  result = ASSERT_WITH_ERROR_CODE(bytesPerPage >= bytesPerRecord,
+                                  UDS_BAD_STATE,
+                                  "page is smaller than a record: %zu",
+                                  bytesPerPage);
   if (result != UDS_SUCCESS) {
     return result;
   }
@@ -60,9 +73,11 @@ static int initializeGeometry(Geometry    *geometry,
   geometry->sparseChaptersPerVolume = sparseChaptersPerVolume;
   geometry->denseChaptersPerVolume  =
     chaptersPerVolume - sparseChaptersPerVolume;
+  geometry->metadataSize            = metadataSize;
+  geometry->bytesPerRecord          = bytesPerRecord;
 
   // Calculate the number of records in a page, chapter, and volume.
-  geometry->recordsPerPage = bytesPerPage / BYTES_PER_RECORD;
+  geometry->recordsPerPage = bytesPerPage / bytesPerRecord;
   geometry->recordsPerChapter
     = geometry->recordsPerPage * recordPagesPerChapter;
   geometry->recordsPerVolume
@@ -107,6 +122,7 @@ int makeGeometry(size_t       bytesPerPage,
                  unsigned int recordPagesPerChapter,
                  unsigned int chaptersPerVolume,
                  unsigned int sparseChaptersPerVolume,
+                 unsigned int metadataSize,
                  Geometry   **geometryPtr)
 {
   Geometry *geometry;
@@ -115,7 +131,8 @@ int makeGeometry(size_t       bytesPerPage,
     return result;
   }
   result = initializeGeometry(geometry, bytesPerPage, recordPagesPerChapter,
-                              chaptersPerVolume, sparseChaptersPerVolume);
+                              chaptersPerVolume, sparseChaptersPerVolume,
+                              metadataSize);
   if (result != UDS_SUCCESS) {
     freeGeometry(geometry);
     return result;
@@ -132,6 +149,7 @@ int copyGeometry(Geometry *source, Geometry **geometryPtr)
                       source->recordPagesPerChapter,
                       source->chaptersPerVolume,
                       source->sparseChaptersPerVolume,
+                      source->metadataSize,
                       geometryPtr);
 }
 
@@ -60,6 +60,8 @@ typedef struct geometry {
   unsigned int sparseChaptersPerVolume;
   /** Number of bits used to determine delta list numbers */
   unsigned int chapterDeltaListBits;
+  /** Number of bytes of metadata stored in each record */
+  unsigned int metadataSize;
 
   // These are derived properties, expressed as fields for convenience.
   /** Total number of pages in a volume, excluding header */
@@ -76,6 +78,8 @@ typedef struct geometry {
   unsigned int indexPagesPerChapter;
   /** The minimum ratio of hash slots to records in an open chapter */
   unsigned int openChapterLoadRatio;
+  /** Number of bytes in a record on a record page */
+  unsigned int bytesPerRecord;
   /** Number of records that fit on a page */
   unsigned int recordsPerPage;
   /** Number of records that fit in a chapter */
@@ -98,6 +102,9 @@ enum {
   /* The number of bytes in a record (name + metadata) */
   BYTES_PER_RECORD = (UDS_CHUNK_NAME_SIZE + UDS_MAX_BLOCK_DATA_SIZE),
 
+  /* The number of bytes in a record with compact metadata */
+  COMPACT_BYTES_PER_RECORD = (UDS_CHUNK_NAME_SIZE + UDS_COMPACT_METADATA_SIZE),
+
   /* The default length of a page in a chapter, in bytes */
   DEFAULT_BYTES_PER_PAGE = 1024 * BYTES_PER_RECORD,
 
@@ -140,6 +147,7 @@ enum {
  * @param recordPagesPerChapter   The number of pages in a chapter
  * @param chaptersPerVolume       The number of chapters in a volume
  * @param sparseChaptersPerVolume The number of sparse chapters in a volume
+ * @param metadataSize            The number of bytes of metadata in a record
  * @param geometryPtr             A pointer to hold the new geometry
  *
  * @return UDS_SUCCESS or an error code
@@ -148,6 +156,7 @@ int makeGeometry(size_t       bytesPerPage,
                  unsigned int recordPagesPerChapter,
                  unsigned int chaptersPerVolume,
                  unsigned int sparseChaptersPerVolume,
+                 unsigned int metadataSize,
                  Geometry   **geometryPtr)
   __attribute__((warn_unused_result));
 
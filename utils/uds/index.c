@@ -262,6 +262,9 @@ int makeIndex(IndexLayout                  *layout,
     return logUnrecoverable(result, "fatal error in makeIndex");
   }
 
+  loadResidentIndexPages(index->volume, index->oldestVirtualChapter,
+                         index->newestVirtualChapter);
+
   if (index->loadContext != NULL) {
     lockMutex(&index->loadContext->mutex);
     index->loadContext->status = INDEX_READY;
@@ -344,7 +347,8 @@ static int searchIndexZone(IndexZone *zone, Request *request)
 
   bool found = false;
   if (record.isFound) {
-    result = getRecordFromZone(zone, request, &found, record.virtualChapter);
+    result = getRecordFromZone(zone, request, &found, record.virtualChapter,
+                               record.recordPage);
     if (result != UDS_SUCCESS) {
       return result;
     }
@@ -374,7 +378,8 @@ static int searchIndexZone(IndexZone *zone, Request *request)
        * If the record had been deleted or dropped from the chapter index, it
        * will be back.
        */
-      result = setMasterIndexRecordChapter(&record, chapter);
+      result = setMasterIndexRecordChapter(&record, chapter,
+                                           getNextRecordPage(zone));
     } else if (request->action != REQUEST_UPDATE) {
       /* The record is already in the open chapter, so we're done */
       return UDS_SUCCESS;
@@ -407,7 +412,7 @@ static int searchIndexZone(IndexZone *zone, Request *request)
      * This needs to be done both for new records, and for records from
      * cached sparse chapters.
      */
-    result = putMasterIndexRecord(&record, chapter);
+    result = putMasterIndexRecord(&record, chapter, getNextRecordPage(zone));
   }
 
   if (result == UDS_OVERFLOW) {
@@ -453,7 +458,7 @@ static int removeFromIndexZone(IndexZone *zone, Request *request)
     // Non-collision records are hints, so resolve the name in the chapter.
     bool found;
     int result = getRecordFromZone(zone, request, &found,
-                                   record.virtualChapter);
+                                   record.virtualChapter, record.recordPage);
     if (result != UDS_SUCCESS) {
       return result;
     }
@@ -619,6 +624,7 @@ static int rebuildIndexPageMap(Index *index, uint64_t vcn)
  * @param name                 The block name of interest.
  * @param virtualChapter       The virtual chapter number to write to the
  *                             master index
+ * @param recordPage           The record page of the chapter holding the name
  * @param willBeSparseChapter  True if this entry will be in the sparse portion
  *                             of the index at the end of rebuilding
  *
@@ -627,6 +633,7 @@ static int rebuildIndexPageMap(Index *index, uint64_t vcn)
 static int replayRecord(Index              *index,
                         const UdsChunkName *name,
                         uint64_t            virtualChapter,
+                        unsigned int        recordPage,
                         bool                willBeSparseChapter)
 {
   if (willBeSparseChapter && !isMasterIndexSample(index->masterIndex, name)) {
@@ -669,8 +676,8 @@ static int replayRecord(Index              *index,
        * master index entry was for the same record or a different one.
        */
       result = searchVolumePageCache(index->volume, NULL, name,
-                                     record.virtualChapter, NULL,
-                                     &updateRecord);
+                                     record.virtualChapter, record.recordPage,
+                                     NULL, &updateRecord);
       if (result != UDS_SUCCESS) {
         return result;
       }
@@ -685,7 +692,8 @@ static int replayRecord(Index              *index,
      * If the record had been deleted or dropped from the chapter index, it
      * will be back.
      */
-    result = setMasterIndexRecordChapter(&record, virtualChapter);
+    result = setMasterIndexRecordChapter(&record, virtualChapter,
+                                         recordPage);
   } else {
     /*
      * Add a new entry to the master index referencing the open
@@ -694,7 +702,7 @@ static int replayRecord(Index              *index,
      * index but does on disk, since for a sparse record, we would want to
      * un-sparsify if it did exist.
      */
-    result = putMasterIndexRecord(&record, virtualChapter);
+    result = putMasterIndexRecord(&record, virtualChapter, recordPage);
   }
 
   if ((result == UDS_DUPLICATE_NAME) || (result == UDS_OVERFLOW)) {
@@ -818,12 +826,12 @@ int replayVolume(Index *index, uint64_t fromVCN)
       }
       unsigned int k;
       for (k = 0; k < geometry->recordsPerPage; k++) {
-        const byte *nameBytes = recordPage + (k * BYTES_PER_RECORD);
+        const byte *nameBytes = recordPage + (k * geometry->bytesPerRecord);
 
         UdsChunkName name;
         memcpy(&name.name, nameBytes, UDS_CHUNK_NAME_SIZE);
 
-        result = replayRecord(index, &name, vcn, willBeSparseChapter);
+        result = replayRecord(index, &name, vcn, j, willBeSparseChapter);
         if (result != UDS_SUCCESS) {
           char hexName[(2 * UDS_CHUNK_NAME_SIZE) + 1];
           if (chunkNameToHex(&name, hexName, sizeof(hexName)) != UDS_SUCCESS) {
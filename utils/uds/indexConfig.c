@@ -26,12 +26,17 @@
 #include "memoryAlloc.h"
 
 static const byte INDEX_CONFIG_MAGIC[]        = "ALBIC";
-static const byte INDEX_CONFIG_VERSION[]      = "06.02";
+static const byte INDEX_CONFIG_VERSION[]      = "06.03";
+static const byte INDEX_CONFIG_VERSION_6_02[] = "06.02";
 static const byte INDEX_CONFIG_VERSION_6_01[] = "06.01";
 
 enum {
   INDEX_CONFIG_MAGIC_LENGTH   = sizeof(INDEX_CONFIG_MAGIC) - 1,
-  INDEX_CONFIG_VERSION_LENGTH = sizeof(INDEX_CONFIG_VERSION) - 1
+  INDEX_CONFIG_VERSION_LENGTH = sizeof(INDEX_CONFIG_VERSION) - 1,
+  /** The encoded size of a version 6.02 configuration */
+  INDEX_CONFIG_6_02_SIZE      = 8 * sizeof(uint32_t) + sizeof(uint64_t),
+  /** The encoded size of a current configuration */
+  INDEX_CONFIG_SIZE           = INDEX_CONFIG_6_02_SIZE + 2 * sizeof(uint32_t),
 };
 
 /**********************************************************************/
@@ -74,6 +79,20 @@ static int decodeIndexConfig(Buffer *buffer, UdsConfiguration config)
   if (result != UDS_SUCCESS) {
     return result;
   }
+  // Version 6.02 configurations end before the record page hints and the
+  // metadata size.
+  config->recordPageHints = 0;
+  config->metadataSize    = UDS_MAX_METADATA_SIZE;
+  if (contentLength(buffer) > 0) {
+    result = getUInt32LEFromBuffer(buffer, &config->recordPageHints);
+    if (result != UDS_SUCCESS) {
+      return result;
+    }
+    result = getUInt32LEFromBuffer(buffer, &config->metadataSize);
+    if (result != UDS_SUCCESS) {
+      return result;
+    }
+  }
   result = ASSERT_LOG_ONLY(contentLength(buffer) == 0,
                            "%zu bytes decoded of %zu expected",
                            bufferLength(buffer) - contentLength(buffer),
@@ -95,9 +114,14 @@ static int readVersion(BufferedReader    *reader,
   if (result != UDS_SUCCESS) {
     return logErrorWithStringError(result, "cannot read index config version");
   }
-  if (memcmp(INDEX_CONFIG_VERSION, buffer, INDEX_CONFIG_VERSION_LENGTH) == 0) {
+  bool isCurrent
+    = (memcmp(INDEX_CONFIG_VERSION, buffer, INDEX_CONFIG_VERSION_LENGTH) == 0);
+  if (isCurrent
+      || (memcmp(INDEX_CONFIG_VERSION_6_02, buffer,
+                 INDEX_CONFIG_VERSION_LENGTH) == 0)) {
+    size_t size = (isCurrent ? INDEX_CONFIG_SIZE : INDEX_CONFIG_6_02_SIZE);
     Buffer *buffer;
-    result = makeBuffer(sizeof(*conf), &buffer);
+    result = makeBuffer(size, &buffer);
     if (result != UDS_SUCCESS) {
       return result;
     }
@@ -114,7 +138,7 @@ static int readVersion(BufferedReader    *reader,
       return result;
     }
     if (versionPtr != NULL) {
-      *versionPtr = "current";
+      *versionPtr = (isCurrent ? "current" : "6.02");
     }
     return result;
   } else if (memcmp(INDEX_CONFIG_VERSION_6_01, buffer,
@@ -209,9 +233,18 @@ static int encodeIndexConfig(Buffer *buffer, UdsConfiguration config)
   if (result != UDS_SUCCESS) {
     return result;
   }
-  result = ASSERT_LOG_ONLY(contentLength(buffer) == sizeof(*config),
+  result = putUInt32LEIntoBuffer(buffer, config->recordPageHints);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+  result = putUInt32LEIntoBuffer(buffer, config->metadataSize);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+  result = ASSERT_LOG_ONLY(contentLength(buffer) == INDEX_CONFIG_SIZE,
                            "%zu bytes encoded, of %zu expected",
-                           contentLength(buffer), sizeof(*config));
+                           contentLength(buffer),
+                           (size_t) INDEX_CONFIG_SIZE);
   return result;
 }
 
@@ -230,7 +263,7 @@ int writeConfigContents(BufferedWriter   *writer,
     return result;
   }
   Buffer *buffer;
-  result = makeBuffer(sizeof(*config), &buffer);
+  result = makeBuffer(INDEX_CONFIG_SIZE, &buffer);
   if (result != UDS_SUCCESS) {
     return result;
   }
@@ -264,6 +297,7 @@ int makeConfiguration(UdsConfiguration conf, Configuration **configPtr)
                         conf->recordPagesPerChapter,
                         conf->chaptersPerVolume,
                         conf->sparseChaptersPerVolume,
+                        conf->metadataSize,
                         &config->geometry);
   if (result != UDS_SUCCESS) {
     freeConfiguration(config);
@@ -273,6 +307,7 @@ int makeConfiguration(UdsConfiguration conf, Configuration **configPtr)
   config->sparseSampleRate     = conf->sparseSampleRate;
   config->cacheChapters        = conf->cacheChapters;
   config->masterIndexMeanDelta = conf->masterIndexMeanDelta;
+  config->recordPageHints      = (conf->recordPageHints != 0);
 
   *configPtr = config;
   return UDS_SUCCESS;
@@ -44,6 +44,9 @@ struct configuration {
 
   /* Sampling rate for sparse indexing */
   unsigned int sparseSampleRate;
+
+  /* Whether master index entries record the record page of their name */
+  bool recordPageHints;
 };
 
 #endif /* INDEX_CONFIG_H */
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2020 Red Hat, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA. 
+ *
+ * $Id: //eng/uds-releases/jasper/src/uds/indexPageStore.c#1 $
+ */
+
+#include "indexPageStore.h"
+
+#include "atomicDefs.h"
+#include "memoryAlloc.h"
+#include "permassert.h"
+
+/** The virtual chapter number of an empty slot */
+static const uint64_t NO_RESIDENT_CHAPTER = UINT64_MAX;
+
+/**
+ * The index pages of one dense chapter.
+ **/
+typedef struct {
+  /** The virtual chapter held in the slot, or NO_RESIDENT_CHAPTER */
+  uint64_t        virtualChapter;
+  /** The chapter index pages, which refer to the page data */
+  DeltaIndexPage *indexPages;
+} ResidentChapter;
+
+struct indexPageStore {
+  /** The number of chapter slots */
+  unsigned int     chapterCount;
+  /** The number of index pages in each chapter */
+  unsigned int     indexPagesPerChapter;
+  /** The number of bytes in each page */
+  size_t           bytesPerPage;
+  /** The page data of all the slots, in a single allocation */
+  byte            *pageData;
+  /** The chapter index pages of all the slots, in a single allocation */
+  DeltaIndexPage  *indexPages;
+  /** The chapter slots */
+  ResidentChapter  chapters[];
+};
+
+/**********************************************************************/
+unsigned int computeResidentChapterCount(const Geometry *geometry,
+                                         unsigned int    pageBudget)
+{
+  unsigned int chapterCount = pageBudget / geometry->indexPagesPerChapter;
+  if (chapterCount > geometry->denseChaptersPerVolume) {
+    return geometry->denseChaptersPerVolume;
+  }
+  return chapterCount;
+}
+
+/**********************************************************************/
+int makeIndexPageStore(const Geometry  *geometry,
+                       unsigned int     chapterCount,
+                       IndexPageStore **storePtr)
+{
+  int result = ASSERT(((chapterCount > 0)
+                       && (chapterCount <= geometry->denseChaptersPerVolume)),
+                      "resident chapter count %u is between 1 and %u",
+                      chapterCount, geometry->denseChaptersPerVolume);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  IndexPageStore *store;
+  result = ALLOCATE_EXTENDED(IndexPageStore, chapterCount, ResidentChapter,
+                             "index page store", &store);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  store->chapterCount         = chapterCount;
+  store->indexPagesPerChapter = geometry->indexPagesPerChapter;
+  store->bytesPerPage         = geometry->bytesPerPage;
+
+  size_t pageCount = (size_t) chapterCount * geometry->indexPagesPerChapter;
+  result = ALLOCATE(pageCount * geometry->bytesPerPage, byte,
+                    "resident index page data", &store->pageData);
+  if (result != UDS_SUCCESS) {
+    freeIndexPageStore(store);
+    return result;
+  }
+
+  result = ALLOCATE(pageCount, DeltaIndexPage, "resident index pages",
+                    &store->indexPages);
+  if (result != UDS_SUCCESS) {
+    freeIndexPageStore(store);
+    return result;
+  }
+
+  unsigned int i;
+  for (i = 0; i < chapterCount; i++) {
+    store->chapters[i] = (ResidentChapter) {
+      .virtualChapter = NO_RESIDENT_CHAPTER,
+      .indexPages     = &store->indexPages[i * geometry->indexPagesPerChapter],
+    };
+  }
+
+  *storePtr = store;
+  return UDS_SUCCESS;
+}
+
+/**********************************************************************/
+void freeIndexPageStore(IndexPageStore *store)
+{
+  if (store == NULL) {
+    return;
+  }
+
+  FREE(store->indexPages);
+  FREE(store->pageData);
+  FREE(store);
+}
+
+/**********************************************************************/
+unsigned int getResidentChapterCount(const IndexPageStore *store)
+{
+  return store->chapterCount;
+}
+
+/**********************************************************************/
+size_t getIndexPageStoreMemorySize(const IndexPageStore *store)
+{
+  // Count the DeltaIndexPage as store memory, but ignore all other overhead.
+  size_t pageSize = (sizeof(DeltaIndexPage) + store->bytesPerPage);
+  size_t chapterSize = (pageSize * store->indexPagesPerChapter);
+  return (store->chapterCount * chapterSize);
+}
+
+/**
+ * Get the slot of a virtual chapter. The store holds no more chapters than
+ * the volume has dense chapters, and the dense chapters are the newest ones,
+ * so each slot holds the newest of the chapters which map to it.
+ *
+ * @param store           the store
+ * @param virtualChapter  the virtual chapter number
+ *
+ * @return the slot for the chapter
+ **/
+static INLINE ResidentChapter *getChapterSlot(IndexPageStore *store,
+                                              uint64_t        virtualChapter)
+{
+  return &store->chapters[virtualChapter % store->chapterCount];
+}
+
+/**********************************************************************/
+DeltaIndexPage *getResidentIndexPage(IndexPageStore *store,
+                                     uint64_t        virtualChapter,
+                                     unsigned int    indexPageNumber)
+{
+  ResidentChapter *chapter = getChapterSlot(store, virtualChapter);
+  if (READ_ONCE(chapter->virtualChapter) != virtualChapter) {
+    return NULL;
+  }
+
+  // Pairs with the write barrier in publishResidentChapter().
+  smp_rmb();
+  return &chapter->indexPages[indexPageNumber];
+}
+
+/**********************************************************************/
+uint64_t evictResidentChapter(IndexPageStore *store, uint64_t virtualChapter)
+{
+  ResidentChapter *chapter = getChapterSlot(store, virtualChapter);
+  uint64_t evicted = chapter->virtualChapter;
+  WRITE_ONCE(chapter->virtualChapter, NO_RESIDENT_CHAPTER);
+  return evicted;
+}
+
+/**********************************************************************/
+byte *getResidentPageBuffer(IndexPageStore  *store,
+                            uint64_t         virtualChapter,
+                            unsigned int     indexPageNumber,
+                            DeltaIndexPage **indexPagePtr)
+{
+  ResidentChapter *chapter = getChapterSlot(store, virtualChapter);
+  *indexPagePtr = &chapter->indexPages[indexPageNumber];
+  size_t page = ((chapter - store->chapters) * store->indexPagesPerChapter
+                 + indexPageNumber);
+  return &store->pageData[page * store->bytesPerPage];
+}
+
+/**********************************************************************/
+void publishResidentChapter(IndexPageStore *store, uint64_t virtualChapter)
+{
+  ResidentChapter *chapter = getChapterSlot(store, virtualChapter);
+  // Make the stored pages visible before the chapter number which guards
+  // them.
+  smp_wmb();
+  WRITE_ONCE(chapter->virtualChapter, virtualChapter);
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2020 Red Hat, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA. 
+ *
+ * $Id: //eng/uds-releases/jasper/src/uds/indexPageStore.h#1 $
+ */
+
+#ifndef INDEX_PAGE_STORE_H
+#define INDEX_PAGE_STORE_H
+
+#include "deltaIndex.h"
+#include "geometry.h"
+#include "typeDefs.h"
+
+/**
+ * IndexPageStore keeps the chapter index pages of the newest dense chapters
+ * of a volume resident in memory, so that searching one of those chapters
+ * never waits for an index page read and its index pages never compete with
+ * record pages for space in the volume page cache. The store holds a fixed
+ * number of chapters, at most the number of dense chapters, which costs
+ * bytesPerPage for each of the indexPagesPerChapter pages of each chapter.
+ * Each chapter has a slot in the store chosen by its virtual chapter number,
+ * and each slot records the virtual chapter whose pages it holds.
+ *
+ * Searching the store is unsynchronized. The chapter writer is the only
+ * thread which changes the store once the index is open, and it must evict
+ * the previous occupant of a slot, and wait for any searches of it to
+ * finish, before it replaces the pages of that slot.
+ **/
+typedef struct indexPageStore IndexPageStore;
+
+/**
+ * Get the number of chapters an index page store may hold within a budget of
+ * index pages.
+ *
+ * @param geometry    the geometry governing the volume
+ * @param pageBudget  the most index pages the store may hold
+ *
+ * @return the number of chapters to store, which may be zero
+ **/
+unsigned int computeResidentChapterCount(const Geometry *geometry,
+                                         unsigned int    pageBudget)
+  __attribute__((warn_unused_result));
+
+/**
+ * Allocate an index page store large enough to hold the chapter index pages
+ * of a given number of the newest dense chapters of a volume.
+ *
+ * @param [in]  geometry      the geometry governing the volume
+ * @param [in]  chapterCount  the number of chapters to store, which must be
+ *                            from 1 to the number of dense chapters
+ * @param [out] storePtr      a pointer in which to return the new store
+ *
+ * @return UDS_SUCCESS or an error code
+ **/
+int makeIndexPageStore(const Geometry  *geometry,
+                       unsigned int     chapterCount,
+                       IndexPageStore **storePtr)
+  __attribute__((warn_unused_result));
+
+/**
+ * Free an index page store.
+ *
+ * @param store  the store to free (may be NULL)
+ **/
+void freeIndexPageStore(IndexPageStore *store);
+
+/**
+ * Get the number of chapters an index page store holds.
+ *
+ * @param store  the store
+ *
+ * @return the number of chapter slots in the store
+ **/
+unsigned int getResidentChapterCount(const IndexPageStore *store)
+  __attribute__((warn_unused_result));
+
+/**
+ * Get the number of bytes of index page memory held by an index page store.
+ *
+ * @param store  the store
+ *
+ * @return the memory size of the store
+ **/
+size_t getIndexPageStoreMemorySize(const IndexPageStore *store)
+  __attribute__((warn_unused_result));
+
+/**
+ * Get a resident chapter index page of a chapter.
+ *
+ * @param store            the store
+ * @param virtualChapter   the virtual chapter number of the chapter
+ * @param indexPageNumber  the number of the index page in the chapter
+ *
+ * @return the index page, or NULL if the chapter is not resident
+ **/
+DeltaIndexPage *getResidentIndexPage(IndexPageStore *store,
+                                     uint64_t        virtualChapter,
+                                     unsigned int    indexPageNumber)
+  __attribute__((warn_unused_result));
+
+/**
+ * Evict the chapter which shares a slot with a chapter which is about to be
+ * stored. The pages of the slot may be replaced once any searches of the
+ * evicted chapter have finished.
+ *
+ * @param store           the store
+ * @param virtualChapter  the virtual chapter number of the chapter to store
+ *
+ * @return the virtual chapter number of the evicted chapter, or UINT64_MAX
+ *         if the slot was empty
+ **/
+uint64_t evictResidentChapter(IndexPageStore *store, uint64_t virtualChapter);
+
+/**
+ * Get the buffer into which to store an index page of a chapter. The slot
+ * of the chapter must have been evicted.
+ *
+ * @param [in]  store            the store
+ * @param [in]  virtualChapter   the virtual chapter number of the chapter
+ * @param [in]  indexPageNumber  the number of the index page in the chapter
+ * @param [out] indexPagePtr     a pointer to hold the index page to
+ *                               initialize from the page data
+ *
+ * @return the buffer for the page data
+ **/
+byte *getResidentPageBuffer(IndexPageStore  *store,
+                            uint64_t         virtualChapter,
+                            unsigned int     indexPageNumber,
+                            DeltaIndexPage **indexPagePtr)
+  __attribute__((warn_unused_result));
+
+/**
+ * Make the stored index pages of a chapter visible to searches.
+ *
+ * @param store           the store
+ * @param virtualChapter  the virtual chapter number of the stored chapter
+ **/
+void publishResidentChapter(IndexPageStore *store, uint64_t virtualChapter);
+
+#endif /* INDEX_PAGE_STORE_H */
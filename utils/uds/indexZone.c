@@ -320,7 +320,8 @@ IndexRegion computeIndexRegion(const IndexZone *zone,
 int getRecordFromZone(IndexZone *zone,
                       Request   *request,
                       bool      *found,
-                      uint64_t   virtualChapter)
+                      uint64_t   virtualChapter,
+                      int        recordPageHint)
 {
   if (virtualChapter == zone->newestVirtualChapter) {
     searchOpenChapter(zone->openChapter, &request->chunkName,
@@ -340,8 +341,15 @@ int getRecordFromZone(IndexZone *zone,
   // The slow lane thread has determined the location previously. We don't need
   // to search again. Just return the location.
   if (request->slLocationKnown) {
-    *found = request->slLocation != LOC_UNAVAILABLE;
-    return UDS_SUCCESS;
+    if ((request->slLocation != LOC_UNAVAILABLE) || !request->slHintedPage) {
+      *found = request->slLocation != LOC_UNAVAILABLE;
+      return UDS_SUCCESS;
+    }
+
+    // The hinted record page did not hold the record, so the chapter index
+    // must be searched after all.
+    request->slLocationKnown = false;
+    recordPageHint           = NO_CHAPTER_INDEX_ENTRY;
   }
 
   Volume *volume = zone->index->volume;
@@ -354,7 +362,21 @@ int getRecordFromZone(IndexZone *zone,
   }
 
   return searchVolumePageCache(volume, request, &request->chunkName,
-                               virtualChapter, &request->oldMetadata, found);
+                               virtualChapter, recordPageHint,
+                               &request->oldMetadata, found);
+}
+
+/**********************************************************************/
+unsigned int getNextRecordPage(const IndexZone *zone)
+{
+  /*
+   * Closing a chapter interleaves the records of its zones, taking one from
+   * each zone in turn, so the position of a record in the written chapter
+   * follows from its position in its zone.
+   */
+  unsigned int position = ((zone->openChapter->size * zone->index->zoneCount)
+                           + zone->id);
+  return position / zone->index->volume->geometry->recordsPerPage;
 }
 
 /**********************************************************************/
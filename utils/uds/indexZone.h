@@ -133,13 +133,27 @@ IndexRegion computeIndexRegion(const IndexZone *zone,
  * @param found          A pointer to a bool which will be set to
  *                       <code>true</code> if the record was found.
  * @param virtualChapter The chapter in which to search
+ * @param recordPageHint The record page of the chapter which probably holds
+ *                       the record, or NO_CHAPTER_INDEX_ENTRY
  *
  * @return UDS_SUCCESS or an error code
  **/
 int getRecordFromZone(IndexZone *zone,
                       Request   *request,
                       bool      *found,
-                      uint64_t   virtualChapter)
+                      uint64_t   virtualChapter,
+                      int        recordPageHint)
+  __attribute__((warn_unused_result));
+
+/**
+ * Get the record page which the next new record put in the open chapter of a
+ * zone will occupy once the chapter is written.
+ *
+ * @param zone  The index zone
+ *
+ * @return the record page number of the next record in the zone
+ **/
+unsigned int getNextRecordPage(const IndexZone *zone)
   __attribute__((warn_unused_result));
 
 /**
@@ -21,6 +21,7 @@
 #include "masterIndex005.h"
 
 #include "buffer.h"
+#include "chapterIndex.h"
 #include "compiler.h"
 #include "errors.h"
 #include "hashUtils.h"
@@ -72,6 +73,8 @@ typedef struct {
   unsigned int addressMask;        // Mask to get address within delta list
   unsigned int chapterBits;        // Number of bits in chapter number
   unsigned int chapterMask;        // Largest storable chapter number
+  unsigned int hintBits;           // Number of bits in record page hint
+  unsigned int hintMask;           // Largest storable record page hint
   unsigned int numChapters;        // Number of chapters used
   unsigned int numDeltaLists;      // The number of delta lists
   unsigned int numZones;           // The number of zones
@@ -136,6 +139,55 @@ static INLINE unsigned int extractDListNum(const MasterIndex5 *mi5,
   return (bits >> mi5->addressBits) % mi5->numDeltaLists;
 }
 
+/**
+ * Get the index chapter number stored in a delta index entry.
+ *
+ * @param mi5         The master index
+ * @param deltaEntry  The delta index entry
+ *
+ * @return the index chapter number
+ **/
+static INLINE unsigned int getEntryChapter(const MasterIndex5 *mi5,
+                                           const DeltaIndexEntry *deltaEntry)
+{
+  return getDeltaEntryValue(deltaEntry) >> mi5->hintBits;
+}
+
+/**
+ * Get the record page hint stored in a delta index entry.
+ *
+ * @param mi5         The master index
+ * @param deltaEntry  The delta index entry
+ *
+ * @return the record page hint, or NO_CHAPTER_INDEX_ENTRY if the master
+ *         index does not record hints
+ **/
+static INLINE int getEntryRecordPage(const MasterIndex5 *mi5,
+                                     const DeltaIndexEntry *deltaEntry)
+{
+  if (mi5->hintBits == 0) {
+    return NO_CHAPTER_INDEX_ENTRY;
+  }
+  return getDeltaEntryValue(deltaEntry) & mi5->hintMask;
+}
+
+/**
+ * Encode an index chapter number and record page hint as the value of a
+ * delta index entry.
+ *
+ * @param mi5           The master index
+ * @param indexChapter  The index chapter number
+ * @param recordPage    The record page number of the name in the chapter
+ *
+ * @return the delta index entry value
+ **/
+static INLINE unsigned int encodeEntryValue(const MasterIndex5 *mi5,
+                                            unsigned int indexChapter,
+                                            unsigned int recordPage)
+{
+  return (indexChapter << mi5->hintBits) | (recordPage & mi5->hintMask);
+}
+
 /**
  * Get the master index zone containing a given master index record
  *
@@ -222,7 +274,7 @@ static INLINE int flushInvalidEntries(MasterIndexRecord *record,
     return result;
   }
   while (!record->deltaEntry.atEnd) {
-    unsigned int indexChapter = getDeltaEntryValue(&record->deltaEntry);
+    unsigned int indexChapter = getEntryChapter(mi5, &record->deltaEntry);
     unsigned int relativeChapter = ((indexChapter - flushRange->chapterStart)
                                     & mi5->chapterMask);
     if (likely(relativeChapter >= flushRange->chapterCount)) {
@@ -964,7 +1016,7 @@ static int lookupMasterIndexSampledName_005(const MasterIndex *masterIndex,
   triage->inSampledChapter = !deltaEntry.atEnd && (deltaEntry.key == address);
   if (triage->inSampledChapter) {
     const MasterIndexZone *masterZone = &mi5->masterZones[triage->zone];
-    unsigned int indexChapter = getDeltaEntryValue(&deltaEntry);
+    unsigned int indexChapter = getEntryChapter(mi5, &deltaEntry);
     unsigned int rollingChapter = ((indexChapter
                                     - masterZone->virtualChapterLow)
                                    & mi5->chapterMask);
@@ -1042,8 +1094,11 @@ static int getMasterIndexRecord_005(MasterIndex *masterIndex,
   record->isFound = (!record->deltaEntry.atEnd
                      && (record->deltaEntry.key == address));
   if (record->isFound) {
-    unsigned int indexChapter = getDeltaEntryValue(&record->deltaEntry);
+    unsigned int indexChapter = getEntryChapter(mi5, &record->deltaEntry);
     record->virtualChapter = convertIndexToVirtual(record, indexChapter);
+    record->recordPage = getEntryRecordPage(mi5, &record->deltaEntry);
+  } else {
+    record->recordPage = NO_CHAPTER_INDEX_ENTRY;
   }
   record->isCollision = record->deltaEntry.isCollision;
   return UDS_SUCCESS;
@@ -1055,10 +1110,14 @@ static int getMasterIndexRecord_005(MasterIndex *masterIndex,
  *
  * @param record          The master index record found by getRecord()
  * @param virtualChapter  The chapter number where block info is found
+ * @param recordPage      The record page of the chapter which will hold the
+ *                        block info
  *
  * @return UDS_SUCCESS or an error code
  **/
-int putMasterIndexRecord(MasterIndexRecord *record, uint64_t virtualChapter)
+int putMasterIndexRecord(MasterIndexRecord *record,
+                         uint64_t           virtualChapter,
+                         unsigned int       recordPage)
 {
   const MasterIndex5 *mi5 = container_of(record->masterIndex, MasterIndex5,
                                          common);
@@ -1080,8 +1139,10 @@ int putMasterIndexRecord(MasterIndexRecord *record, uint64_t virtualChapter)
   if (unlikely(record->mutex != NULL)) {
     lockMutex(record->mutex);
   }
-  int result = putDeltaIndexEntry(&record->deltaEntry, address,
-                                  convertVirtualToIndex(mi5, virtualChapter),
+  unsigned int value
+    = encodeEntryValue(mi5, convertVirtualToIndex(mi5, virtualChapter),
+                       recordPage);
+  int result = putDeltaIndexEntry(&record->deltaEntry, address, value,
                                   record->isFound ? record->name->name : NULL);
   if (unlikely(record->mutex != NULL)) {
     unlockMutex(record->mutex);
@@ -1089,6 +1150,7 @@ int putMasterIndexRecord(MasterIndexRecord *record, uint64_t virtualChapter)
   switch (result) {
   case UDS_SUCCESS:
     record->virtualChapter = virtualChapter;
+    record->recordPage     = getEntryRecordPage(mi5, &record->deltaEntry);
     record->isCollision    = record->deltaEntry.isCollision;
     record->isFound        = true;
     break;
@@ -1149,11 +1211,14 @@ int removeMasterIndexRecord(MasterIndexRecord *record)
  *
  * @param record         The master index record found by getRecord()
  * @param virtualChapter The chapter number where the block info is now found.
+ * @param recordPage     The record page of the chapter which will hold the
+ *                       block info
  *
  * @return UDS_SUCCESS or an error code
  **/
 int setMasterIndexRecordChapter(MasterIndexRecord *record,
-                                uint64_t virtualChapter)
+                                uint64_t           virtualChapter,
+                                unsigned int       recordPage)
 {
   const MasterIndex5 *mi5 = container_of(record->masterIndex, MasterIndex5,
                                          common);
@@ -1171,11 +1236,13 @@ int setMasterIndexRecordChapter(MasterIndexRecord *record,
                                      masterZone->virtualChapterLow,
                                      masterZone->virtualChapterHigh);
   }
+  unsigned int value
+    = encodeEntryValue(mi5, convertVirtualToIndex(mi5, virtualChapter),
+                       recordPage);
   if (unlikely(record->mutex != NULL)) {
     lockMutex(record->mutex);
   }
-  result = setDeltaEntryValue(&record->deltaEntry,
-                              convertVirtualToIndex(mi5, virtualChapter));
+  result = setDeltaEntryValue(&record->deltaEntry, value);
   if (unlikely(record->mutex != NULL)) {
     unlockMutex(record->mutex);
   }
@@ -1183,6 +1250,7 @@ int setMasterIndexRecordChapter(MasterIndexRecord *record,
     return result;
   }
   record->virtualChapter = virtualChapter;
+  record->recordPage     = getEntryRecordPage(mi5, &record->deltaEntry);
   return UDS_SUCCESS;
 }
 
@@ -1260,6 +1328,7 @@ static bool isMasterIndexSample_005(const MasterIndex  *masterIndex
 typedef struct {
   unsigned int addressBits;    // Number of bits in address mask
   unsigned int chapterBits;    // Number of bits in chapter number
+  unsigned int hintBits;       // Number of bits in record page hint
   unsigned int meanDelta;      // The mean delta
   unsigned long numDeltaLists; // The number of delta lists
   unsigned long numChapters;   // Number of chapters used
@@ -1295,6 +1364,9 @@ static int computeMasterIndexParameters005(const Configuration *config,
     = maxUint(recordsPerVolume / DELTA_LIST_SIZE, minDeltaLists);
   params->addressBits = computeBits(numAddresses - 1);
   params->chapterBits = computeBits(params->numChapters - 1);
+  params->hintBits    = (config->recordPageHints
+                         ? computeBits(geometry->recordPagesPerChapter - 1)
+                         : 0);
 
   if ((unsigned int) params->numDeltaLists != params->numDeltaLists) {
     return logWarningWithStringError(UDS_INVALID_ARGUMENT,
@@ -1356,7 +1428,8 @@ static int computeMasterIndexParameters005(const Configuration *config,
   // Project how large we expect a chapter to be
   params->numBitsPerChapter = getDeltaMemorySize(recordsPerChapter,
                                                  params->meanDelta,
-                                                 params->chapterBits);
+                                                 (params->chapterBits
+                                                  + params->hintBits));
   // Project how large we expect the index to be
   size_t numBitsPerIndex = params->numBitsPerChapter * chaptersInMasterIndex;
   size_t expectedIndexSize = numBitsPerIndex / CHAR_BIT;
@@ -1431,6 +1504,8 @@ int makeMasterIndex005(const Configuration *config, unsigned int numZones,
   mi5->addressMask     = (1u << params.addressBits) - 1;
   mi5->chapterBits     = params.chapterBits;
   mi5->chapterMask     = (1u << params.chapterBits) - 1;
+  mi5->hintBits        = params.hintBits;
+  mi5->hintMask        = (1u << params.hintBits) - 1;
   mi5->numChapters     = params.numChapters;
   mi5->numDeltaLists   = params.numDeltaLists;
   mi5->numZones        = numZones;
@@ -1439,7 +1514,8 @@ int makeMasterIndex005(const Configuration *config, unsigned int numZones,
 
   result = initializeDeltaIndex(&mi5->deltaIndex, numZones,
                                 params.numDeltaLists, params.meanDelta,
-                                params.chapterBits, params.memorySize);
+                                params.chapterBits + params.hintBits,
+                                params.memorySize);
   if (result == UDS_SUCCESS) {
     mi5->maxZoneBits = ((getDeltaIndexDlistBitsAllocated(&mi5->deltaIndex)
                          - params.targetFreeSize * CHAR_BIT)
@@ -74,6 +74,8 @@ typedef struct {
 typedef struct {
   // Public fields
   uint64_t virtualChapter;  // Chapter where the block info is found
+  int      recordPage;      // Record page hint for the block info within
+                            // the chapter, or NO_CHAPTER_INDEX_ENTRY
   bool     isCollision;     // This record is a collision
   bool     isFound;         // This record is the block searched for
 
@@ -392,10 +394,15 @@ static INLINE int lookupMasterIndexSampledName(const MasterIndex *masterIndex,
  *
  * @param record          The master index record found by getRecord()
  * @param virtualChapter  The chapter number where block info is found
+ * @param recordPage      The record page of the chapter which will hold the
+ *                        block info, which is recorded as a hint if the
+ *                        master index keeps record page hints
  *
  * @return UDS_SUCCESS or an error code
  **/
-int putMasterIndexRecord(MasterIndexRecord *record, uint64_t virtualChapter)
+int putMasterIndexRecord(MasterIndexRecord *record,
+                         uint64_t           virtualChapter,
+                         unsigned int       recordPage)
   __attribute__((warn_unused_result));
 
 /**
@@ -456,10 +463,15 @@ static INLINE void setMasterIndexOpenChapter(MasterIndex *masterIndex,
  *
  * @param record          The master index record found by getRecord()
  * @param virtualChapter  The chapter number where block info is now found.
+ * @param recordPage      The record page of the chapter which will hold the
+ *                        block info, which is recorded as a hint if the
+ *                        master index keeps record page hints
  *
  * @return UDS_SUCCESS or an error code
  **/
-int setMasterIndexRecordChapter(MasterIndexRecord *record, uint64_t chapter)
+int setMasterIndexRecordChapter(MasterIndexRecord *record,
+                                uint64_t           virtualChapter,
+                                unsigned int       recordPage)
   __attribute__((warn_unused_result));
 
 /**
@@ -100,6 +100,7 @@ int makeOpenChapter(const Geometry   *geometry,
   }
   openChapter->slotCount = slotCount;
   openChapter->capacity = capacity;
+  openChapter->metadataSize = geometry->metadataSize;
   result = allocateCacheAligned(recordsSize(openChapter), "record pages",
                                 &openChapter->records);
   if (result != UDS_SUCCESS) {
@@ -199,6 +200,24 @@ void searchOpenChapter(OpenChapterZone     *openChapter,
   }
 }
 
+/**
+ * Set the metadata of a record, keeping only the bytes which the volume
+ * stores, so that a search finds the same metadata whether or not the
+ * chapter has been written.
+ *
+ * @param openChapter  The open chapter zone containing the record
+ * @param record       The record to update
+ * @param metadata     The metadata to store
+ **/
+static void setRecordMetadata(const OpenChapterZone *openChapter,
+                              UdsChunkRecord        *record,
+                              const UdsChunkData    *metadata)
+{
+  record->data = *metadata;
+  memset(&record->data.data[openChapter->metadataSize], 0,
+         UDS_MAX_BLOCK_DATA_SIZE - openChapter->metadataSize);
+}
+
 /**********************************************************************/
 int putOpenChapter(OpenChapterZone    *openChapter,
                    const UdsChunkName *name,
@@ -209,7 +228,7 @@ int putOpenChapter(OpenChapterZone    *openChapter,
   UdsChunkRecord *record = probeChapterSlots(openChapter, name, &slot, NULL);
 
   if (record != NULL) {
-    record->data = *metadata;
+    setRecordMetadata(openChapter, record, metadata);
     *remaining = openChapter->capacity - openChapter->size;
     return UDS_SUCCESS;
   }
@@ -222,7 +241,7 @@ int putOpenChapter(OpenChapterZone    *openChapter,
   openChapter->slots[slot].recordNumber = recordNumber;
   record                                = &openChapter->records[recordNumber];
   record->name                          = *name;
-  record->data                          = *metadata;
+  setRecordMetadata(openChapter, record, metadata);
 
   *remaining = openChapter->capacity - openChapter->size;
   return UDS_SUCCESS;
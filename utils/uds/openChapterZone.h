@@ -75,6 +75,8 @@ typedef struct openChapterZone {
   unsigned int    size;
   /** Number of deleted records */
   unsigned int    deleted;
+  /** Number of bytes of metadata which the volume stores for a record */
+  unsigned int    metadataSize;
   /** Record data, stored as (name, metadata), 1-based */
   UdsChunkRecord *records;
   /** The number of slots in the chapter zone hash table. */
@@ -128,13 +128,8 @@ static int getPageNoStats(PageCache     *cache,
   return UDS_SUCCESS;
 }
 
-/**
- * Wait for all pending searches on a page in the cache to complete
- *
- * @param cache         the page cache
- * @param physicalPage  the page to check searches on
- **/
-static void waitForPendingSearches(PageCache *cache, unsigned int physicalPage)
+/**********************************************************************/
+void waitForPendingSearches(PageCache *cache, unsigned int physicalPage)
 {
   /*
    * We hold the readThreadsMutex.  We are waiting for threads that do not hold
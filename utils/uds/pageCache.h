@@ -316,6 +316,15 @@ static INLINE bool readQueueIsFull(PageCache *cache)
     (cache->readQueueLast + 1) % cache->readQueueMaxSize);
 }
 
+/**
+ * Wait for all pending searches on a page to complete. The caller must hold
+ * the reader thread mutex.
+ *
+ * @param cache         the page cache
+ * @param physicalPage  the page to check searches on
+ **/
+void waitForPendingSearches(PageCache *cache, unsigned int physicalPage);
+
 /**
  * Selects a page in the cache to be used for a read.
  *
@@ -28,22 +28,24 @@ static unsigned int encodeTree(byte                  recordPage[],
                                const UdsChunkRecord *sortedPointers[],
                                unsigned int          nextRecord,
                                unsigned int          node,
-                               unsigned int          nodeCount)
+                               unsigned int          nodeCount,
+                               unsigned int          bytesPerRecord)
 {
   if (node < nodeCount) {
     unsigned int child = (2 * node) + 1;
     nextRecord = encodeTree(recordPage, sortedPointers, nextRecord,
-                            child, nodeCount);
+                            child, nodeCount, bytesPerRecord);
 
     // In-order traversal: copy the contents of the next record
-    // into the page at the node offset.
-    memcpy(&recordPage[node * BYTES_PER_RECORD],
+    // into the page at the node offset. A compact record is the name and
+    // just the leading bytes of the metadata which follows it.
+    memcpy(&recordPage[node * bytesPerRecord],
            sortedPointers[nextRecord],
-           BYTES_PER_RECORD);
+           bytesPerRecord);
     ++nextRecord;
 
     nextRecord = encodeTree(recordPage, sortedPointers, nextRecord,
-                            child + 1, nodeCount);
+                            child + 1, nodeCount, bytesPerRecord);
   }
   return nextRecord;
 }
@@ -64,6 +66,7 @@ int encodeRecordPage(const Volume         *volume,
   }
 
   STATIC_ASSERT(offsetof(UdsChunkRecord, name) == 0);
+  STATIC_ASSERT(offsetof(UdsChunkRecord, data) == UDS_CHUNK_NAME_SIZE);
   int result = radixSort(volume->radixSorter, (const byte **) recordPointers,
                          recordsPerPage, UDS_CHUNK_NAME_SIZE);
   if (result != UDS_SUCCESS) {
@@ -72,7 +75,8 @@ int encodeRecordPage(const Volume         *volume,
 
   // Use the sorted pointers to copy the records from the chapter to the
   // record page in tree order.
-  encodeTree(recordPage, recordPointers, 0, 0, recordsPerPage);
+  encodeTree(recordPage, recordPointers, 0, 0, recordsPerPage,
+             volume->geometry->bytesPerRecord);
   return UDS_SUCCESS;
 }
 
@@ -82,18 +86,20 @@ bool searchRecordPage(const byte          recordPage[],
                       const Geometry     *geometry,
                       UdsChunkData       *metadata)
 {
-  // The record page is just an array of chunk records.
-  const UdsChunkRecord *records = (const UdsChunkRecord *) recordPage;
+  // The record page is just an array of chunk records, each of which is a
+  // name followed by the stored bytes of its metadata.
 
   // The array of records is sorted by name and stored as a binary tree in
   // heap order, so the root of the tree is the first array element.
   unsigned int node = 0;
   while (node < geometry->recordsPerPage) {
-    const UdsChunkRecord *record = &records[node];
-    int result = memcmp(name, &record->name, UDS_CHUNK_NAME_SIZE);
+    const byte *record = &recordPage[node * geometry->bytesPerRecord];
+    int result = memcmp(name, record, UDS_CHUNK_NAME_SIZE);
     if (result == 0) {
       if (metadata != NULL) {
-        *metadata = record->data;
+        memset(metadata, 0, sizeof(*metadata));
+        memcpy(metadata->data, &record[UDS_CHUNK_NAME_SIZE],
+               geometry->metadataSize);
       }
       return true;
     }
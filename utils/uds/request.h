@@ -156,6 +156,7 @@ struct internalRequest {
 
   bool        slLocationKnown;  // slow lane has determined a location
   IndexRegion slLocation;       // location determined by slowlane
+  bool        slHintedPage;     // slow lane searched a hinted record page
 };
 
 typedef void (*RequestRestarter)(Request *);
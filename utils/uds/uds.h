@@ -99,6 +99,8 @@ enum {
   UDS_CHUNK_NAME_SIZE   = 16,
   /** The maximum metadata size in bytes. */
   UDS_MAX_METADATA_SIZE = 16,
+  /** The metadata size in bytes of an index with compact metadata. */
+  UDS_COMPACT_METADATA_SIZE = 8,
 };
 
 /**
@@ -144,11 +146,15 @@ struct uds_parameters {
   int read_threads;
   // The number of chapters to write between checkpoints.
   int checkpoint_frequency;
+  // The most chapter index pages of the newest dense chapters to keep in
+  // memory, in addition to the page cache (0 to keep none).
+  unsigned int resident_index_pages;
 };
 #define UDS_PARAMETERS_INITIALIZER {		\
 		.zone_count = 0,		\
 		.read_threads = 2,		\
 		.checkpoint_frequency = 0,	\
+		.resident_index_pages = 0,	\
 	}
 
 /**
@@ -298,6 +304,53 @@ void udsConfigurationSetNonce(UdsConfiguration conf, UdsNonce nonce);
 UDS_ATTR_WARN_UNUSED_RESULT
 UdsNonce udsConfigurationGetNonce(UdsConfiguration conf);
 
+/**
+ * Sets or clears an index configuration's record page hints. An index with
+ * hints records in each dense master index entry which record page of its
+ * chapter holds the name, so that a lookup in a chapter which is not cached
+ * can usually read just that record page instead of first reading a chapter
+ * index page. The hints make each master index entry a few bits larger.
+ *
+ * @param [in,out] conf  The configuration to change
+ * @param [in] hints     If <code>true</code>, request record page hints
+ **/
+void udsConfigurationSetRecordPageHints(UdsConfiguration conf, bool hints);
+
+/**
+ * Tests whether an index configuration specifies record page hints.
+ *
+ * @param [in] conf  The configuration to check
+ *
+ * @return  Returns <code>true</code> if the configuration has record page
+ *          hints, or <code>false</code> if not
+ **/
+UDS_ATTR_WARN_UNUSED_RESULT
+bool udsConfigurationGetRecordPageHints(UdsConfiguration conf);
+
+/**
+ * Sets or clears an index configuration's compact metadata. An index with
+ * compact metadata stores only the first #UDS_COMPACT_METADATA_SIZE bytes of
+ * the metadata of each chunk name, and returns the remaining bytes as zeros.
+ * Each record page then holds a third more records, so the configuration
+ * uses fewer record pages per chapter for the same number of records, and
+ * the volume is smaller.
+ *
+ * @param [in,out] conf  The configuration to change
+ * @param [in] compact   If <code>true</code>, request compact metadata
+ **/
+void udsConfigurationSetCompactMetadata(UdsConfiguration conf, bool compact);
+
+/**
+ * Tests whether an index configuration specifies compact metadata.
+ *
+ * @param [in] conf  The configuration to check
+ *
+ * @return  Returns <code>true</code> if the configuration has compact
+ *          metadata, or <code>false</code> if not
+ **/
+UDS_ATTR_WARN_UNUSED_RESULT
+bool udsConfigurationGetCompactMetadata(UdsConfiguration conf);
+
 /**
  * Fetches a configuration's maximum memory allocation.
  *
@@ -94,6 +94,8 @@ int udsInitializeConfiguration(UdsConfiguration    *userConfig,
   (*userConfig)->bytesPerPage            = DEFAULT_BYTES_PER_PAGE;
   (*userConfig)->sparseSampleRate        = DEFAULT_SPARSE_SAMPLE_RATE;
   (*userConfig)->nonce                   = 0;
+  (*userConfig)->recordPageHints         = 0;
+  (*userConfig)->metadataSize            = UDS_MAX_METADATA_SIZE;
   return UDS_SUCCESS;
 }
 
@@ -138,6 +140,51 @@ UdsNonce udsConfigurationGetNonce(UdsConfiguration userConfig)
   return userConfig->nonce;
 }
 
+/**********************************************************************/
+void udsConfigurationSetRecordPageHints(UdsConfiguration userConfig,
+                                        bool             hints)
+{
+  userConfig->recordPageHints = hints;
+}
+
+/**********************************************************************/
+bool udsConfigurationGetRecordPageHints(UdsConfiguration userConfig)
+{
+  return userConfig->recordPageHints != 0;
+}
+
+/**********************************************************************/
+void udsConfigurationSetCompactMetadata(UdsConfiguration userConfig,
+                                        bool             compact)
+{
+  bool prevCompact = (userConfig->metadataSize != UDS_MAX_METADATA_SIZE);
+  if (compact == prevCompact) {
+    // nothing to do
+    return;
+  }
+
+  // Keep the number of records in a chapter, and so the indexing window,
+  // about the same by using fewer pages of smaller records, or more pages of
+  // larger ones.
+  if (compact) {
+    userConfig->recordPagesPerChapter
+      = (userConfig->recordPagesPerChapter * COMPACT_BYTES_PER_RECORD
+         / BYTES_PER_RECORD);
+    userConfig->metadataSize = UDS_COMPACT_METADATA_SIZE;
+  } else {
+    userConfig->recordPagesPerChapter
+      = (userConfig->recordPagesPerChapter * BYTES_PER_RECORD
+         / COMPACT_BYTES_PER_RECORD);
+    userConfig->metadataSize = UDS_MAX_METADATA_SIZE;
+  }
+}
+
+/**********************************************************************/
+bool udsConfigurationGetCompactMetadata(UdsConfiguration userConfig)
+{
+  return userConfig->metadataSize != UDS_MAX_METADATA_SIZE;
+}
+
 /**********************************************************************/
 unsigned int udsConfigurationGetMemory(UdsConfiguration userConfig)
 {
@@ -151,6 +198,10 @@ unsigned int udsConfigurationGetMemory(UdsConfiguration userConfig)
   if (userConfig->sparseChaptersPerVolume != 0) {
     pages /= 10;
   }
+  if (userConfig->metadataSize != UDS_MAX_METADATA_SIZE) {
+    // Count the pages the records would fill at the full metadata size.
+    pages = ((uint64_t) pages * BYTES_PER_RECORD) / COMPACT_BYTES_PER_RECORD;
+  }
   switch (pages) {
   case SMALL_PAGES:     return UDS_MEMORY_CONFIG_256MB;
   case 2 * SMALL_PAGES: return UDS_MEMORY_CONFIG_512MB;
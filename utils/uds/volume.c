@@ -551,7 +551,8 @@ int getPage(Volume          *volume,
  * @param request          the request originating the search (may be NULL for
  *                         a direct query from volume replay)
  * @param name             the name of the block or chunk
- * @param chapter          the chapter to search
+ * @param virtualChapter   the virtual chapter to search
+ * @param chapter          the physical chapter to search
  * @param indexPageNumber  the index page number of the page to search
  * @param recordPageNumber pointer to return the chapter record page number
  *                         (value will be NO_CHAPTER_INDEX_ENTRY if the name
@@ -562,6 +563,7 @@ int getPage(Volume          *volume,
 static int searchCachedIndexPage(Volume             *volume,
                                  Request            *request,
                                  const UdsChunkName *name,
+                                 uint64_t            virtualChapter,
                                  unsigned int        chapter,
                                  unsigned int        indexPageNumber,
                                  int                *recordPageNumber)
@@ -575,28 +577,38 @@ static int searchCachedIndexPage(Volume             *volume,
    * the page map.  This prevents this thread from reading a page in the
    * page map which has already been marked for invalidation by the reader
    * thread, before the reader thread has noticed that the invalidateCounter
-   * has been incremented.
+   * has been incremented.  The same counter keeps the chapter writer from
+   * replacing a resident index page while it is being searched.
    */
   beginPendingSearch(volume->pageCache, physicalPage, zoneNumber);
 
-  CachedPage *page = NULL;
-  int result = getPageProtected(volume, request, physicalPage,
-                                cacheProbeType(request, true), &page);
-  if (result != UDS_SUCCESS) {
-    endPendingSearch(volume->pageCache, zoneNumber);
-    return result;
+  DeltaIndexPage *indexPage = NULL;
+  if (volume->indexPageStore != NULL) {
+    indexPage = getResidentIndexPage(volume->indexPageStore, virtualChapter,
+                                     indexPageNumber);
   }
 
-  result
-    = ASSERT_LOG_ONLY(searchPending(getInvalidateCounter(volume->pageCache,
-                                                         zoneNumber)),
-                      "Search is pending for zone %u", zoneNumber);
-  if (result != UDS_SUCCESS) {
-    return result;
+  if (indexPage == NULL) {
+    CachedPage *page = NULL;
+    int result = getPageProtected(volume, request, physicalPage,
+                                  cacheProbeType(request, true), &page);
+    if (result != UDS_SUCCESS) {
+      endPendingSearch(volume->pageCache, zoneNumber);
+      return result;
+    }
+
+    result
+      = ASSERT_LOG_ONLY(searchPending(getInvalidateCounter(volume->pageCache,
+                                                           zoneNumber)),
+                        "Search is pending for zone %u", zoneNumber);
+    if (result != UDS_SUCCESS) {
+      return result;
+    }
+    indexPage = &page->cp_indexPage;
   }
 
-  result = searchChapterIndexPage(&page->cp_indexPage, volume->geometry, name,
-                                  recordPageNumber);
+  int result = searchChapterIndexPage(indexPage, volume->geometry, name,
+                                      recordPageNumber);
   endPendingSearch(volume->pageCache, zoneNumber);
   return result;
 }
@@ -696,21 +708,46 @@ int searchVolumePageCache(Volume             *volume,
                           Request            *request,
                           const UdsChunkName *name,
                           uint64_t            virtualChapter,
+                          int                 recordPageHint,
                           UdsChunkData       *metadata,
                           bool               *found)
 {
   unsigned int physicalChapter
     = mapToPhysicalChapter(volume->geometry, virtualChapter);
+  int result;
+  if ((recordPageHint >= 0)
+      && ((unsigned int) recordPageHint
+          < volume->geometry->recordPagesPerChapter)) {
+    /*
+     * Search the hinted record page without consulting the chapter index.
+     * A hint is only a prediction, so if the name is not there, fall back
+     * to the chapter index, which costs just the one extra page.
+     */
+    if (request != NULL) {
+      request->slHintedPage = true;
+    }
+    result = searchCachedRecordPage(volume, request, name, physicalChapter,
+                                    recordPageHint, metadata, found);
+    if ((result != UDS_SUCCESS) || *found) {
+      return result;
+    }
+  }
+
+  if (request != NULL) {
+    request->slHintedPage = false;
+  }
+
   unsigned int indexPageNumber;
-  int result = findIndexPageNumber(volume->indexPageMap, name, physicalChapter,
-                                   &indexPageNumber);
+  result = findIndexPageNumber(volume->indexPageMap, name, physicalChapter,
+                               &indexPageNumber);
   if (result != UDS_SUCCESS) {
     return result;
   }
 
   int recordPageNumber;
-  result = searchCachedIndexPage(volume, request, name, physicalChapter,
-                                 indexPageNumber, &recordPageNumber);
+  result = searchCachedIndexPage(volume, request, name, virtualChapter,
+                                 physicalChapter, indexPageNumber,
+                                 &recordPageNumber);
   if (result == UDS_SUCCESS) {
     result = searchCachedRecordPage(volume, request, name, physicalChapter,
                                     recordPageNumber, metadata, found);
@@ -783,6 +820,59 @@ static int donateIndexPageLocked(Volume             *volume,
   return UDS_SUCCESS;
 }
 
+/**
+ * Evict the resident chapter which shares a slot in the index page store
+ * with a chapter which is about to be written, and wait for any searches of
+ * its pages to finish. The caller must already hold the reader thread mutex.
+ *
+ * @param volume          the volume
+ * @param virtualChapter  the virtual chapter number of the chapter to write
+ **/
+static void evictResidentChapterLocked(Volume   *volume,
+                                       uint64_t  virtualChapter)
+{
+  uint64_t evicted = evictResidentChapter(volume->indexPageStore,
+                                          virtualChapter);
+  if (evicted == UINT64_MAX) {
+    return;
+  }
+
+  // Searches of a resident page are pending on the page's physical page.
+  Geometry *geometry = volume->geometry;
+  unsigned int physicalChapter = mapToPhysicalChapter(geometry, evicted);
+  unsigned int i;
+  for (i = 0; i < geometry->indexPagesPerChapter; i++) {
+    waitForPendingSearches(volume->pageCache,
+                           mapToPhysicalPage(geometry, physicalChapter, i));
+  }
+}
+
+/**
+ * Copy the data of an index page into the resident index page store.
+ *
+ * @param volume           the volume
+ * @param virtualChapter   the virtual chapter number of the index page
+ * @param physicalChapter  the physical chapter number of the index page
+ * @param indexPageNumber  the chapter page number of the index page
+ * @param volumePage       the index page data
+ *
+ * @return UDS_SUCCESS or an error code
+ **/
+static int storeResidentIndexPage(Volume                   *volume,
+                                  uint64_t                  virtualChapter,
+                                  unsigned int              physicalChapter,
+                                  unsigned int              indexPageNumber,
+                                  const struct volume_page *volumePage)
+{
+  DeltaIndexPage *indexPage;
+  byte *pageData = getResidentPageBuffer(volume->indexPageStore,
+                                         virtualChapter, indexPageNumber,
+                                         &indexPage);
+  memcpy(pageData, getPageData(volumePage), volume->geometry->bytesPerPage);
+  return initChapterIndexPage(volume, pageData, physicalChapter,
+                              indexPageNumber, indexPage);
+}
+
 /**********************************************************************/
 int writeIndexPages(Volume            *volume,
                     int                physicalPage,
@@ -794,6 +884,12 @@ int writeIndexPages(Volume            *volume,
     = mapToPhysicalChapter(geometry, chapterIndex->virtualChapterNumber);
   unsigned int deltaListNumber = 0;
 
+  if (volume->indexPageStore != NULL) {
+    lockMutex(&volume->readThreadsMutex);
+    evictResidentChapterLocked(volume, chapterIndex->virtualChapterNumber);
+    unlockMutex(&volume->readThreadsMutex);
+  }
+
   unsigned int indexPageNumber;
   for (indexPageNumber = 0;
        indexPageNumber < geometry->indexPagesPerChapter;
@@ -845,15 +941,28 @@ int writeIndexPages(Volume            *volume,
                                      "failed to update index page map");
     }
 
-    // Donate the page data for the index page to the page cache.
-    lockMutex(&volume->readThreadsMutex);
-    result = donateIndexPageLocked(volume, physicalChapterNumber,
-                                   indexPageNumber, &volume->scratchPage);
-    unlockMutex(&volume->readThreadsMutex);
+    if (volume->indexPageStore != NULL) {
+      // Keep the index page resident, leaving the page cache to record pages.
+      result = storeResidentIndexPage(volume,
+                                      chapterIndex->virtualChapterNumber,
+                                      physicalChapterNumber, indexPageNumber,
+                                      &volume->scratchPage);
+    } else {
+      // Donate the page data for the index page to the page cache.
+      lockMutex(&volume->readThreadsMutex);
+      result = donateIndexPageLocked(volume, physicalChapterNumber,
+                                     indexPageNumber, &volume->scratchPage);
+      unlockMutex(&volume->readThreadsMutex);
+    }
     if (result != UDS_SUCCESS) {
       return result;
     }
   }
+
+  if (volume->indexPageStore != NULL) {
+    publishResidentChapter(volume->indexPageStore,
+                           chapterIndex->virtualChapterNumber);
+  }
   return UDS_SUCCESS;
 }
 
@@ -934,6 +1043,84 @@ int writeChapter(Volume                 *volume,
   return syncVolumeStore(&volume->volumeStore);
 }
 
+/**
+ * Read the chapter index pages of a chapter into the resident index page
+ * store.
+ *
+ * @param volume          the volume
+ * @param virtualChapter  the virtual chapter number of the chapter
+ * @param volumePage      a volume page buffer to read into
+ *
+ * @return UDS_SUCCESS or an error code
+ **/
+static int loadResidentChapter(Volume             *volume,
+                               uint64_t            virtualChapter,
+                               struct volume_page *volumePage)
+{
+  Geometry *geometry = volume->geometry;
+  unsigned int physicalChapter = mapToPhysicalChapter(geometry,
+                                                      virtualChapter);
+  int physicalPage = mapToPhysicalPage(geometry, physicalChapter, 0);
+  prefetchVolumePages(&volume->volumeStore, physicalPage,
+                      geometry->indexPagesPerChapter);
+
+  unsigned int i;
+  for (i = 0; i < geometry->indexPagesPerChapter; i++) {
+    int result = readVolumePage(&volume->volumeStore, physicalPage + i,
+                                volumePage);
+    if (result != UDS_SUCCESS) {
+      return result;
+    }
+    result = storeResidentIndexPage(volume, virtualChapter, physicalChapter,
+                                    i, volumePage);
+    if (result != UDS_SUCCESS) {
+      return result;
+    }
+  }
+
+  publishResidentChapter(volume->indexPageStore, virtualChapter);
+  return UDS_SUCCESS;
+}
+
+/**********************************************************************/
+void loadResidentIndexPages(Volume   *volume,
+                            uint64_t  oldestChapter,
+                            uint64_t  newestChapter)
+{
+  if (volume->indexPageStore == NULL) {
+    return;
+  }
+
+  struct volume_page volumePage;
+  int result = initializeVolumePage(volume->geometry, &volumePage);
+  if (result != UDS_SUCCESS) {
+    logWarningWithStringError(result, "cannot load resident index pages");
+    return;
+  }
+
+  // Only the newest chapters fit in the store.
+  uint64_t firstChapter = oldestChapter;
+  uint64_t residentChapters = getResidentChapterCount(volume->indexPageStore);
+  if ((newestChapter - oldestChapter) > residentChapters) {
+    firstChapter = newestChapter - residentChapters;
+  }
+
+  uint64_t chapter;
+  for (chapter = firstChapter; chapter < newestChapter; chapter++) {
+    if (isChapterSparse(volume->geometry, oldestChapter, newestChapter,
+                        chapter)) {
+      continue;
+    }
+    result = loadResidentChapter(volume, chapter, &volumePage);
+    if (result != UDS_SUCCESS) {
+      logWarningWithStringError(result,
+                                "index pages of chapter %" PRIu64
+                                " are not resident", chapter);
+    }
+  }
+  destroyVolumePage(&volumePage);
+}
+
 /**********************************************************************/
 size_t getCacheSize(Volume *volume)
 {
@@ -941,6 +1128,9 @@ size_t getCacheSize(Volume *volume)
   if (isSparse(volume->geometry)) {
     size += getSparseCacheMemorySize(volume->sparseCache);
   }
+  if (volume->indexPageStore != NULL) {
+    size += getIndexPageStoreMemorySize(volume->indexPageStore);
+  }
   return size;
 }
 
@@ -1304,6 +1494,26 @@ int makeVolume(const Configuration          *config,
   if (result != UDS_SUCCESS) {
     return result;
   }
+  unsigned int residentChapters = 0;
+  if ((userParams != NULL) && (userParams->resident_index_pages > 0)) {
+    residentChapters
+      = computeResidentChapterCount(volume->geometry,
+                                    userParams->resident_index_pages);
+    if (residentChapters == 0) {
+      logWarning("resident index page budget of %u is less than the %u"
+                 " index pages of one chapter",
+                 userParams->resident_index_pages,
+                 volume->geometry->indexPagesPerChapter);
+    }
+  }
+  if (residentChapters > 0) {
+    result = makeIndexPageStore(volume->geometry, residentChapters,
+                                &volume->indexPageStore);
+    if (result != UDS_SUCCESS) {
+      freeVolume(volume);
+      return result;
+    }
+  }
   result = initMutex(&volume->readThreadsMutex);
   if (result != UDS_SUCCESS) {
     freeVolume(volume);
@@ -1370,6 +1580,7 @@ void freeVolume(Volume *volume)
   destroyVolumePage(&volume->scratchPage);
   freePageCache(volume->pageCache);
   freeSparseCache(volume->sparseCache);
+  freeIndexPageStore(volume->indexPageStore);
   closeVolumeStore(&volume->volumeStore);
 
   destroyCond(&volume->readThreadsCond);
@@ -27,6 +27,7 @@
 #include "chapterIndex.h"
 #include "indexConfig.h"
 #include "indexLayout.h"
+#include "indexPageStore.h"
 #include "indexPageMap.h"
 #include "pageCache.h"
 #include "request.h"
@@ -78,6 +79,8 @@ typedef struct volume {
   SparseCache           *sparseCache;
   /* The page cache */
   PageCache             *pageCache;
+  /* The resident dense chapter index pages, or NULL if not resident */
+  IndexPageStore        *indexPageStore;
   /* The index page map maps delta list numbers to index page numbers */
   IndexPageMap          *indexPageMap;
   /* Mutex to sync between read threads and index thread */
@@ -176,6 +179,8 @@ int findVolumeChapterBoundaries(Volume   *volume,
  * @param request         The request originating the search.
  * @param name            The block name of interest.
  * @param virtualChapter  The number of the chapter to search.
+ * @param recordPageHint  The record page which probably holds the name, or
+ *                        NO_CHAPTER_INDEX_ENTRY if there is no hint
  * @param metadata        The old metadata for the name.
  * @param found           A pointer which will be set to
  *                        <code>true</code> if a match was found.
@@ -186,6 +191,7 @@ int searchVolumePageCache(Volume             *volume,
                           Request            *request,
                           const UdsChunkName *name,
                           uint64_t            virtualChapter,
+                          int                 recordPageHint,
                           UdsChunkData       *metadata,
                           bool               *found)
   __attribute__((warn_unused_result));
@@ -286,6 +292,19 @@ int writeChapter(Volume               *volume,
                  const UdsChunkRecord  records[])
   __attribute__((warn_unused_result));
 
+/**
+ * Read the chapter index pages of the newest closed dense chapters of a
+ * volume into its resident index page store, if it has one. A chapter whose
+ * pages can not be read is left to be searched through the page cache.
+ *
+ * @param volume          the volume
+ * @param oldestChapter   the virtual chapter number of the oldest chapter
+ * @param newestChapter   the virtual chapter number of the open chapter
+ **/
+void loadResidentIndexPages(Volume   *volume,
+                            uint64_t  oldestChapter,
+                            uint64_t  newestChapter);
+
 /**
  * Read all the index pages for a chapter from the volume and initialize an
  * array of ChapterIndexPages to represent them.
@@ -31,6 +31,7 @@ typedef enum adminOperationType {
   ADMIN_OPERATION_GROW_LOGICAL,
   ADMIN_OPERATION_GROW_PHYSICAL,
   ADMIN_OPERATION_PREPARE_GROW_PHYSICAL,
+  ADMIN_OPERATION_RESIZE_CACHE,
   ADMIN_OPERATION_LOAD,
   ADMIN_OPERATION_RESUME,
   ADMIN_OPERATION_SAVE,
@@ -204,6 +204,13 @@ static int allocateComponents(BlockAllocator  *allocator,
     return result;
   }
 
+  result
+    = initializeEnqueueableCompletion(&allocator->slabJournalBatchCompletion,
+                                      SLAB_JOURNAL_BATCH_COMPLETION, layer);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
   allocator->summary = getSlabSummaryForZone(depot, allocator->zoneNumber);
 
   result = makeVIOPool(layer, vioPoolSize, allocator->threadID,
@@ -273,6 +280,7 @@ int makeBlockAllocator(SlabDepot         *depot,
   allocator->nonce            = nonce;
   allocator->readOnlyNotifier = readOnlyNotifier;
   initializeRing(&allocator->dirtySlabJournals);
+  initializeRing(&allocator->batchedSlabJournals);
 
   result = allocateComponents(allocator, layer, vioPoolSize);
   if (result != VDO_SUCCESS) {
@@ -295,6 +303,7 @@ void freeBlockAllocator(BlockAllocator **blockAllocatorPtr)
   freeSlabScrubber(&allocator->slabScrubber);
   freeVIOPool(&allocator->vioPool);
   freePriorityTable(&allocator->prioritizedSlabs);
+  destroyEnqueueable(&allocator->slabJournalBatchCompletion);
   destroyEnqueueable(&allocator->completion);
   FREE(allocator);
   *blockAllocatorPtr = NULL;
@@ -838,11 +847,16 @@ void releaseTailBlockLocks(void          *context,
 {
   BlockAllocator *allocator = getBlockAllocatorForZone(context, zoneNumber);
   RingNode       *ring      = &allocator->dirtySlabJournals;
-  while (!isRingEmpty(ring)) {
-    if (!releaseRecoveryJournalLock(slabJournalFromDirtyNode(ring->next),
+  RingNode       *node      = ring->next;
+  while (node != ring) {
+    // A journal whose commit is deferred to the end of the current pass
+    // stays on the ring, so step past it rather than retrying it.
+    RingNode *next = node->next;
+    if (!releaseRecoveryJournalLock(slabJournalFromDirtyNode(node),
                                     allocator->depot->activeReleaseRequest)) {
       break;
     }
+    node = next;
   }
   completeCompletion(parent);
 }
@@ -902,10 +916,14 @@ BlockAllocatorStatistics
 getBlockAllocatorStatistics(const BlockAllocator *allocator)
 {
   const AtomicAllocatorStatistics *atoms = &allocator->statistics;
+  VIOPoolStatistics poolStats = getVIOPoolStatistics(allocator->vioPool);
   return (BlockAllocatorStatistics) {
-    .slabCount     = allocator->slabCount,
-    .slabsOpened   = relaxedLoad64(&atoms->slabsOpened),
-    .slabsReopened = relaxedLoad64(&atoms->slabsReopened),
+    .slabCount      = allocator->slabCount,
+    .slabsOpened    = relaxedLoad64(&atoms->slabsOpened),
+    .slabsReopened  = relaxedLoad64(&atoms->slabsReopened),
+    .vioPoolWaits   = poolStats.waits,
+    .vioPoolGrowths = poolStats.grows,
+    .vioPoolSize    = poolStats.size,
   };
 }
 
@@ -919,6 +937,16 @@ SlabJournalStatistics getSlabJournalStatistics(const BlockAllocator *allocator)
     .blockedCount  = atomicLoad64(&atoms->blockedCount),
     .blocksWritten = atomicLoad64(&atoms->blocksWritten),
     .tailBusyCount = atomicLoad64(&atoms->tailBusyCount),
+    .committedBlocksUnder25Percent
+      = atomicLoad64(&atoms->committedBlocksUnder25Percent),
+    .committedBlocksUnder50Percent
+      = atomicLoad64(&atoms->committedBlocksUnder50Percent),
+    .committedBlocksUnder75Percent
+      = atomicLoad64(&atoms->committedBlocksUnder75Percent),
+    .committedBlocksUnder100Percent
+      = atomicLoad64(&atoms->committedBlocksUnder100Percent),
+    .committedFullBlocks = atomicLoad64(&atoms->committedFullBlocks),
+    .entriesCoalesced    = atomicLoad64(&atoms->entriesCoalesced),
   };
 }
 
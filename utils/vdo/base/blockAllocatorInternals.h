@@ -87,6 +87,18 @@ typedef struct atomicSlabJournalStatistics {
   Atomic64 blocksWritten;
   /** Number of times we had to wait for the tail block commit */
   Atomic64 tailBusyCount;
+  /** Number of tail blocks written less than 25% full */
+  Atomic64 committedBlocksUnder25Percent;
+  /** Number of tail blocks written at least 25% but less than 50% full */
+  Atomic64 committedBlocksUnder50Percent;
+  /** Number of tail blocks written at least 50% but less than 75% full */
+  Atomic64 committedBlocksUnder75Percent;
+  /** Number of tail blocks written at least 75% full but not full */
+  Atomic64 committedBlocksUnder100Percent;
+  /** Number of tail blocks written full */
+  Atomic64 committedFullBlocks;
+  /** Number of entries not made because they cancelled out */
+  Atomic64 entriesCoalesced;
 } AtomicSlabJournalStatistics;
 
 /**
@@ -150,6 +162,17 @@ struct blockAllocator {
    **/
   RingNode                     dirtySlabJournals;
 
+  /** Whether slab journal entries are added once per pass of this zone */
+  bool                         batchSlabJournalEntries;
+  /** The slab journals with entries to add at the end of the current pass */
+  RingNode                     batchedSlabJournals;
+  /** The completion for adding the batched slab journal entries */
+  VDOCompletion                slabJournalBatchCompletion;
+  /** Whether the slab journal batch completion has been launched */
+  bool                         slabJournalBatchLaunched;
+  /** Whether adjacent cancelling reference count adjustments are skipped */
+  bool                         coalesceReferenceUpdates;
+
   /** The VIO pool for reading and writing block allocator metadata */
   VIOPool                     *vioPool;
 };
@@ -170,7 +193,7 @@ int makeAllocatorPoolVIOs(PhysicalLayer  *layer,
  * tests.
  *
  * @param allocator  The block allocator
- * @param size       The number of entries in the pool
+ * @param size       The number of entries in the pool, which will not grow
  * @param layer      The physical layer from which to allocate VIOs
  *
  * @return VDO_SUCCESS or an error
@@ -287,7 +287,7 @@ static int initializeBlockMapZone(BlockMapZone     *zone,
                                   BlockCount        maximumAge)
 {
   zone->readOnlyNotifier = readOnlyNotifier;
-  int result = initializeTreeZone(zone, layer, maximumAge);
+  int result = initializeTreeZone(zone, layer, maximumAge, cacheSize);
   if (result != VDO_SUCCESS) {
     return result;
   }
@@ -528,6 +528,36 @@ BlockCount getNumberOfBlockMapEntries(const BlockMap *map)
   return map->entryCount;
 }
 
+/**********************************************************************/
+void setBlockMapVIOPoolGrowth(BlockMap *map, unsigned int factor)
+{
+  for (ZoneCount zone = 0; zone < map->zoneCount; zone++) {
+    setVIOPoolGrowthFactor(map->zones[zone].treeZone.vioPool, factor);
+  }
+}
+
+/**********************************************************************/
+void setBlockMapTier(BlockMap            *map,
+                     PhysicalBlockNumber  origin,
+                     BlockCount           size)
+{
+  map->tierOrigin = origin;
+  map->tierSize   = size;
+}
+
+/**********************************************************************/
+bool hasBlockMapTier(const BlockMap *map)
+{
+  return (map->tierSize > 0);
+}
+
+/**********************************************************************/
+bool isBlockMapTierBlock(const BlockMap *map, PhysicalBlockNumber pbn)
+{
+  return ((pbn >= map->tierOrigin)
+          && (pbn < (map->tierOrigin + map->tierSize)));
+}
+
 /**********************************************************************/
 void advanceBlockMapEra(BlockMap *map, SequenceNumber recoveryBlockNumber)
 {
@@ -657,6 +687,45 @@ void abandonBlockMapGrowth(BlockMap *map)
   abandonForest(map);
 }
 
+/**
+ * Resize the page cache of a zone of the block map.
+ *
+ * <p>Implements ZoneAction.
+ **/
+static void resizeZoneCache(void          *context,
+                            ZoneCount      zoneNumber,
+                            VDOCompletion *parent)
+{
+  BlockMapZone *zone = getBlockMapZone(context, zoneNumber);
+  if (!isNormal(&zone->state)) {
+    finishCompletion(parent, VDO_INVALID_ADMIN_STATE);
+    return;
+  }
+
+  BlockMap  *map       = zone->blockMap;
+  PageCount  cacheSize = map->nextCacheSize / map->zoneCount;
+  int        result    = resizeVDOPageCache(zone->pageCache, cacheSize);
+  if (result == VDO_SUCCESS) {
+    zone->treeZone.maximumResidentPages = cacheSize;
+  }
+
+  finishCompletion(parent, result);
+}
+
+/**********************************************************************/
+void resizeBlockMapCaches(BlockMap      *map,
+                          PageCount      cacheSize,
+                          VDOCompletion *parent)
+{
+  if (cacheSize < map->zoneCount) {
+    finishCompletion(parent, VDO_PARAMETER_MISMATCH);
+    return;
+  }
+
+  map->nextCacheSize = cacheSize;
+  scheduleAction(map->actionManager, NULL, resizeZoneCache, NULL, parent);
+}
+
 /**
  * Finish processing a block map get or put operation. This function releases
  * the page completion and then continues the requester.
@@ -855,6 +924,12 @@ BlockMapStatistics getBlockMapStatistics(BlockMap *map)
     stats.pagesLoaded     += atomicLoad64(&atoms->pagesLoaded);
     stats.pagesSaved      += atomicLoad64(&atoms->pagesSaved);
     stats.flushCount      += atomicLoad64(&atoms->flushCount);
+
+    VIOPoolStatistics poolStats
+      = getVIOPoolStatistics(map->zones[zone].treeZone.vioPool);
+    stats.vioPoolWaits    += poolStats.waits;
+    stats.vioPoolGrowths  += poolStats.grows;
+    stats.vioPoolSize     += poolStats.size;
   }
 
   return stats;
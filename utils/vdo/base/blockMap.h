@@ -105,6 +105,19 @@ void growBlockMap(BlockMap *map, VDOCompletion *parent);
  **/
 void abandonBlockMapGrowth(BlockMap *map);
 
+/**
+ * Change the size of the block map page cache while the block map is running.
+ * The new size is divided evenly among the logical zones. This method must be
+ * called from the journal thread.
+ *
+ * @param map        The block map whose cache is to be resized
+ * @param cacheSize  The new total cache size, in pages
+ * @param parent     The object to notify when the resize is complete
+ **/
+void resizeBlockMapCaches(BlockMap      *map,
+                          PageCount      cacheSize,
+                          VDOCompletion *parent);
+
 /**
  * Decode the state of a block map saved in a buffer, without creating page
  * caches.
@@ -250,6 +263,49 @@ PageCount getNumberOfFixedBlockMapPages(const BlockMap *map)
 BlockCount getNumberOfBlockMapEntries(const BlockMap *map)
   __attribute__((warn_unused_result));
 
+/**
+ * Set the multiple of its preallocated size to which the VIO pool of each
+ * tree zone of a block map may grow while tree page I/O is backed up. This
+ * must be set after the caches are made and before the block map is in use.
+ *
+ * @param map     The block map
+ * @param factor  The growth factor (0 or 1 keep the pools at a fixed size)
+ **/
+void setBlockMapVIOPoolGrowth(BlockMap *map, unsigned int factor);
+
+/**
+ * Place the block map tier, the region of a dedicated metadata device from
+ * which tree pages are allocated in preference to the slab depot.
+ *
+ * @param map     The block map
+ * @param origin  The first PBN of the tier
+ * @param size    The number of blocks in the tier
+ **/
+void setBlockMapTier(BlockMap            *map,
+                     PhysicalBlockNumber  origin,
+                     BlockCount           size);
+
+/**
+ * Check whether a block map has a tier for its tree pages.
+ *
+ * @param map  The block map
+ *
+ * @return <code>true</code> if tree pages are allocated from a tier
+ **/
+bool hasBlockMapTier(const BlockMap *map)
+  __attribute__((warn_unused_result));
+
+/**
+ * Check whether a PBN is in the block map tier.
+ *
+ * @param map  The block map
+ * @param pbn  The PBN to check
+ *
+ * @return <code>true</code> if the PBN may hold a tree page in the tier
+ **/
+bool isBlockMapTierBlock(const BlockMap *map, PhysicalBlockNumber pbn)
+  __attribute__((warn_unused_result));
+
 /**
  * Notify the block map that the recovery journal has finished a new block.
  * This method must be called from the journal zone thread.
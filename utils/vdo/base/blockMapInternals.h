@@ -58,6 +58,14 @@ struct blockMapTreeZone {
   uint8_t              oldestGeneration;
   /** The counts of dirty pages in each generation */
   uint32_t             dirtyPageCounts[256];
+  /** Whether the block map tier has been found to be full */
+  bool                 tierFull;
+  /** The resident height one pages, least recently used first */
+  RingNode             residentPages;
+  /** The number of pages on the residentPages ring */
+  PageCount            residentPageCount;
+  /** The number of height one pages to keep resident before evicting */
+  PageCount            maximumResidentPages;
 };
 
 /**
@@ -89,6 +97,10 @@ struct blockMap {
   PhysicalBlockNumber  rootOrigin;
   /** The count of root pages of the tree part of the block map */
   BlockCount           rootCount;
+  /** The first PBN of the tier from which tree pages are allocated */
+  PhysicalBlockNumber  tierOrigin;
+  /** The number of blocks in the tier (0 if tree pages come from slabs) */
+  BlockCount           tierSize;
 
   /** The era point we are currently distributing to the zones */
   SequenceNumber       currentEraPoint;
@@ -108,6 +120,8 @@ struct blockMap {
   Forest              *nextForest;
   /** The number of entries after growth */
   BlockCount           nextEntryCount;
+  /** The total page cache size to which the zone caches are being resized */
+  PageCount            nextCacheSize;
 
   /** The number of logical zones */
   ZoneCount            zoneCount;
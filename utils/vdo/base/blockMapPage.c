@@ -119,6 +119,6 @@ void updateBlockMapPage(BlockMapPage        *page,
   }
 
   // Release the transferred lock from the DataVIO.
-  releasePerEntryLockFromOtherZone(journal, newLocked);
+  releasePerEntryLockFromOtherZone(journal, newLocked, zone->zoneNumber);
   dataVIO->recoverySequenceNumber = 0;
 }
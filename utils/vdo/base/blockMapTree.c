@@ -22,6 +22,7 @@
 #include "blockMapTree.h"
 
 #include "logger.h"
+#include "memoryAlloc.h"
 
 #include "blockMap.h"
 #include "blockMapInternals.h"
@@ -43,6 +44,8 @@
 
 enum {
   BLOCK_MAP_VIO_POOL_SIZE = 64,
+  /** The most resident pages to examine when looking for one to evict */
+  EVICTION_SCAN_LIMIT     = 16,
 };
 
 typedef struct __attribute__((packed)) {
@@ -80,6 +83,18 @@ static inline TreePage *treePageFromRingNode(RingNode *ringNode)
   return (TreePage *) ((byte *) ringNode - offsetof(TreePage, node));
 }
 
+/**
+ * Convert a RingNode on a zone's list of resident pages to a TreePage.
+ *
+ * @param ringNode The RingNode to convert
+ *
+ * @return The TreePage which owns the RingNode
+ **/
+static inline TreePage *treePageFromResidentNode(RingNode *ringNode)
+{
+  return (TreePage *) ((byte *) ringNode - offsetof(TreePage, residentNode));
+}
+
 /**********************************************************************/
 static void writeDirtyPagesCallback(RingNode *expired, void *context);
 
@@ -101,11 +116,14 @@ static int makeBlockMapVIOs(PhysicalLayer  *layer,
 /**********************************************************************/
 int initializeTreeZone(BlockMapZone  *zone,
                        PhysicalLayer *layer,
-                       BlockCount     eraLength)
+                       BlockCount     eraLength,
+                       PageCount      maximumResidentPages)
 {
   STATIC_ASSERT_SIZEOF(PageDescriptor, sizeof(uint64_t));
-  BlockMapTreeZone *treeZone = &zone->treeZone;
-  treeZone->mapZone          = zone;
+  BlockMapTreeZone *treeZone     = &zone->treeZone;
+  treeZone->mapZone              = zone;
+  treeZone->maximumResidentPages = maximumResidentPages;
+  initializeRing(&treeZone->residentPages);
 
   int result = makeDirtyLists(eraLength, writeDirtyPagesCallback, treeZone,
                               &treeZone->dirtyLists);
@@ -201,6 +219,118 @@ bool copyValidPage(char                *buffer,
   return false;
 }
 
+/**********************************************************************/
+int makeTreePageResident(TreePage *treePage)
+{
+  if (isTreePageResident(treePage)) {
+    return VDO_SUCCESS;
+  }
+
+  int result = ALLOCATE(VDO_BLOCK_SIZE, char, "block map tree page",
+                        &treePage->pageBuffer);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  initializeRing(&treePage->residentNode);
+  return VDO_SUCCESS;
+}
+
+/**
+ * Check whether a resident tree page may be evicted. A page may only be
+ * evicted if it is clean and no lookup depends on its contents.
+ *
+ * @param treePage  The page to check
+ *
+ * @return <code>true</code> if the page's buffer may be freed
+ **/
+static bool isTreePageEvictable(TreePage *treePage)
+{
+  return ((treePage->recoveryLock == 0)
+          && !treePage->writing
+          && !isWaiting(&treePage->waiter)
+          && (treePage->lockCount == 0));
+}
+
+/**
+ * Evict the least recently used clean pages from a zone while it has more
+ * resident height one pages than it should. Only a bounded number of pages
+ * are examined so that a zone with many dirty pages does not pay for a long
+ * scan on every load.
+ *
+ * @param zone  The zone
+ **/
+static void evictResidentPages(BlockMapTreeZone *zone)
+{
+  RingNode *node = zone->residentPages.next;
+  for (unsigned int scanned = 0;
+       ((scanned < EVICTION_SCAN_LIMIT)
+        && (zone->residentPageCount > zone->maximumResidentPages)
+        && (node != &zone->residentPages));
+       scanned++) {
+    TreePage *treePage = treePageFromResidentNode(node);
+    node = node->next;
+    if (!isTreePageEvictable(treePage)) {
+      continue;
+    }
+
+    unspliceRingNode(&treePage->residentNode);
+    FREE(treePage->pageBuffer);
+    treePage->pageBuffer = NULL;
+    zone->residentPageCount--;
+  }
+}
+
+/**
+ * Note that a resident height one page has been used, making it the last
+ * candidate for eviction.
+ *
+ * @param zone      The zone which owns the page
+ * @param treePage  The page
+ **/
+static void touchResidentPage(BlockMapTreeZone *zone, TreePage *treePage)
+{
+  if (isRingEmpty(&treePage->residentNode)) {
+    zone->residentPageCount++;
+  }
+
+  pushRingNode(&zone->residentPages, &treePage->residentNode);
+}
+
+/**********************************************************************/
+void recordResidentTreePage(BlockMapTreeZone *zone, TreePage *treePage)
+{
+  touchResidentPage(zone, treePage);
+}
+
+/**
+ * Make a tree page resident so that it can be loaded or formatted. If the page
+ * is at height one, make room for it by evicting other pages if necessary.
+ *
+ * @param zone      The zone which owns the page
+ * @param treePage  The page
+ * @param height    The height of the page
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+static int prepareResidentPage(BlockMapTreeZone *zone,
+                               TreePage         *treePage,
+                               Height            height)
+{
+  if (height != 1) {
+    return makeTreePageResident(treePage);
+  }
+
+  evictResidentPages(zone);
+  int result = makeTreePageResident(treePage);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  touchResidentPage(zone, treePage);
+  return VDO_SUCCESS;
+}
+
 /**********************************************************************/
 bool isTreeZoneActive(BlockMapTreeZone *zone)
 {
@@ -612,6 +742,11 @@ static void releasePageLock(DataVIO *dataVIO, char *what)
                   "block map page %s mismatch for key %" PRIu64 " in tree %u",
                   what, lock->key, lock->rootIndex);
   lock->locked = false;
+
+  PageKey key = { .key = lock->key };
+  getTreePageByIndex(zone->mapZone->blockMap->forest,
+                     key.descriptor.rootIndex, key.descriptor.height,
+                     key.descriptor.pageIndex)->lockCount--;
 }
 
 /**
@@ -713,7 +848,8 @@ static bool isInvalidTreeEntry(const VDO          *vdo,
     return false;
   }
 
-  return !isPhysicalDataBlock(vdo->depot, mapping->pbn);
+  return (!isPhysicalDataBlock(vdo->depot, mapping->pbn)
+          && !isBlockMapTierBlock(vdo->blockMap, mapping->pbn));
 }
 
 /**********************************************************************/
@@ -790,9 +926,16 @@ static void finishBlockMapPageLoad(VDOCompletion *completion)
   treeLock->height--;
   PhysicalBlockNumber pbn
     = treeLock->treeSlots[treeLock->height].blockMapSlot.pbn;
-  TreePage     *treePage = getTreePage(zone, treeLock);
-  BlockMapPage *page     = (BlockMapPage *) treePage->pageBuffer;
-  Nonce         nonce    = zone->mapZone->blockMap->nonce;
+  TreePage *treePage = getTreePage(zone, treeLock);
+  int       result   = prepareResidentPage(zone, treePage, treeLock->height);
+  if (result != VDO_SUCCESS) {
+    returnVIOToPool(zone->vioPool, entry);
+    abortLoad(dataVIO, result);
+    return;
+  }
+
+  BlockMapPage *page  = (BlockMapPage *) treePage->pageBuffer;
+  Nonce         nonce = zone->mapZone->blockMap->nonce;
   if (!copyValidPage(entry->buffer, nonce, pbn, page)) {
     formatBlockMapPage(page, nonce, pbn, false);
   }
@@ -873,8 +1016,9 @@ static int attemptPageLock(BlockMapTreeZone *zone, DataVIO *dataVIO)
   }
 
   if (lockHolder == NULL) {
-    // We got the lock
+    // We got the lock, which keeps the page resident until it is released.
     dataVIO->treeLock.locked = true;
+    getTreePage(zone, lock)->lockCount++;
     return VDO_SUCCESS;
   }
 
@@ -991,6 +1135,19 @@ static void finishBlockMapAllocation(VDOCompletion *completion)
 
   PhysicalBlockNumber pbn = treeLock->treeSlots[height - 1].blockMapSlot.pbn;
 
+  if (height > 1) {
+    // Make the interior node being allocated resident before recording it.
+    TreePage *child
+      = getTreePageByIndex(zone->mapZone->blockMap->forest,
+                           treeLock->rootIndex, height - 1,
+                           treeLock->treeSlots[height - 1].pageIndex);
+    int result = prepareResidentPage(zone, child, height - 1);
+    if (result != VDO_SUCCESS) {
+      abortAllocation(dataVIO, result);
+      return;
+    }
+  }
+
   // Record the allocation.
   BlockMapPage   *page    = (BlockMapPage *) treePage->pageBuffer;
   SequenceNumber  oldLock = treePage->recoveryLock;
@@ -1127,6 +1284,67 @@ static void continueBlockMapPageAllocation(AllocatingVIO *allocatingVIO)
                         THIS_LOCATION("$F;cb=journalBlockMapAllocation"));
 }
 
+/**
+ * Record the PBN of a page allocated from the block map tier now that its
+ * recovery journal entry has been committed. There is no reference count or
+ * allocation lock to deal with since the tier is not part of any slab. This
+ * callback is registered in allocateFromBlockMapTier().
+ *
+ * @param completion  The DataVIO doing the allocation
+ **/
+static void finishBlockMapTierAllocation(VDOCompletion *completion)
+{
+  DataVIO *dataVIO = asDataVIO(completion);
+  assertInLogicalZone(dataVIO);
+  if (completion->result != VDO_SUCCESS) {
+    allocationFailure(completion);
+    return;
+  }
+
+  TreeLock *lock = &dataVIO->treeLock;
+  lock->treeSlots[lock->height - 1].blockMapSlot.pbn = dataVIO->operation.pbn;
+  finishBlockMapAllocation(completion);
+}
+
+/**
+ * Allocate a block map page from the slab depot. This callback is registered
+ * in allocateFromBlockMapTier() when the tier is full.
+ *
+ * @param completion  The DataVIO doing the allocation
+ **/
+static void allocateFromSlabs(VDOCompletion *completion)
+{
+  DataVIO *dataVIO = asDataVIO(completion);
+  assertInLogicalZone(dataVIO);
+  getBlockMapTreeZone(dataVIO)->tierFull = true;
+  allocateDataBlock(dataVIOAsAllocatingVIO(dataVIO),
+                    getAllocationSelector(dataVIO->logical.zone),
+                    VIO_BLOCK_MAP_WRITE_LOCK,
+                    continueBlockMapPageAllocation);
+}
+
+/**
+ * Allocate a block map page from the block map tier, if it has any space
+ * left, and journal the allocation. This callback is registered in
+ * allocateBlockMapPage().
+ *
+ * @param completion  The DataVIO doing the allocation
+ **/
+static void allocateFromBlockMapTier(VDOCompletion *completion)
+{
+  DataVIO *dataVIO = asDataVIO(completion);
+  assertInJournalZone(dataVIO);
+  setLogicalCallback(dataVIO, finishBlockMapTierAllocation,
+                     THIS_LOCATION("$F;cb=finishBlockMapTierAllocation"));
+  if (addBlockMapTierEntry(getVDOFromDataVIO(dataVIO)->recoveryJournal,
+                           dataVIO)) {
+    return;
+  }
+
+  launchLogicalCallback(dataVIO, allocateFromSlabs,
+                        THIS_LOCATION("$F;cb=allocateFromSlabs"));
+}
+
 /**
  * Allocate a block map page.
  *
@@ -1152,6 +1370,12 @@ static void allocateBlockMapPage(BlockMapTreeZone *zone, DataVIO *dataVIO)
     return;
   }
 
+  if (hasBlockMapTier(zone->mapZone->blockMap) && !zone->tierFull) {
+    launchJournalCallback(dataVIO, allocateFromBlockMapTier,
+                          THIS_LOCATION("$F;cb=allocateFromBlockMapTier"));
+    return;
+  }
+
   allocateDataBlock(dataVIOAsAllocatingVIO(dataVIO),
                     getAllocationSelector(dataVIO->logical.zone),
                     VIO_BLOCK_MAP_WRITE_LOCK,
@@ -1184,11 +1408,17 @@ void lookupBlockMapPBN(DataVIO *dataVIO)
   for (lock->height = 1; lock->height <= BLOCK_MAP_TREE_HEIGHT;
        lock->height++) {
     lock->treeSlots[lock->height] = treeSlot;
-    page = (BlockMapPage *) (getTreePage(zone, lock)->pageBuffer);
-    PhysicalBlockNumber pbn = getBlockMapPagePBN(page);
-    if (pbn != ZERO_BLOCK) {
-      lock->treeSlots[lock->height].blockMapSlot.pbn = pbn;
-      break;
+    TreePage *treePage = getTreePage(zone, lock);
+    if (isTreePageResident(treePage)) {
+      page = asBlockMapPage(treePage);
+      PhysicalBlockNumber pbn = getBlockMapPagePBN(page);
+      if (pbn != ZERO_BLOCK) {
+        lock->treeSlots[lock->height].blockMapSlot.pbn = pbn;
+        if (lock->height == 1) {
+          touchResidentPage(zone, treePage);
+        }
+        break;
+      }
     }
 
     // Calculate the index and slot for the next level.
@@ -1243,6 +1473,10 @@ PhysicalBlockNumber findBlockMapPagePBN(BlockMap *map, PageNumber pageNumber)
 
   TreePage *treePage
     = getTreePageByIndex(map->forest, rootIndex, 1, pageIndex);
+  if (!isTreePageResident(treePage)) {
+    return ZERO_BLOCK;
+  }
+
   BlockMapPage *page = (BlockMapPage *) treePage->pageBuffer;
   if (!isBlockMapPageInitialized(page)) {
     return ZERO_BLOCK;
@@ -30,16 +30,21 @@ typedef struct treePage TreePage;
 /**
  * Intialize a BlockMapTreeZone.
  *
- * @param zone              The BlockMapZone of the tree zone to intialize
- * @param layer             The physical layer
- * @param maximumAge        The number of journal blocks before a dirtied page
- *                          is considered old and may be written out
+ * @param zone                  The BlockMapZone of the tree zone to
+ *                              intialize
+ * @param layer                 The physical layer
+ * @param maximumAge            The number of journal blocks before a
+ *                              dirtied page is considered old and may be
+ *                              written out
+ * @param maximumResidentPages  The number of height one tree pages to keep
+ *                              in memory before evicting clean ones
  *
  * @return VDO_SUCCESS or an error
  **/
 int initializeTreeZone(BlockMapZone     *zone,
                        PhysicalLayer    *layer,
-                       BlockCount        maximumAge)
+                       BlockCount        maximumAge,
+                       PageCount         maximumResidentPages)
   __attribute__((warn_unused_result));
 
 /**
@@ -97,8 +102,9 @@ void lookupBlockMapPBN(DataVIO *dataVIO);
 
 /**
  * Find the PBN of a leaf block map page. This method may only be used after
- * all allocated tree pages have been loaded, otherwise, it may give the wrong
- * answer (0).
+ * all allocated tree pages have been loaded by traverseForest(), and before
+ * normal operation can evict any of them, otherwise, it may give the wrong
+ * answer (0). Traversals never evict, so only lookups can do so.
  *
  * @param map         The block map containing the forest
  * @param pageNumber  The page number of the desired block map page
@@ -56,8 +56,17 @@ struct treePage {
   /** The value of recoveryLock when the this page last started writing */
   SequenceNumber writingRecoveryLock;
 
-  /** The buffer to hold the on-disk representation of this page */
-  char           pageBuffer[VDO_BLOCK_SIZE];
+  /** The number of lookups holding a lock on a slot of this page */
+  uint16_t       lockCount;
+
+  /** The node for the zone's list of evictable resident pages */
+  RingNode       residentNode;
+
+  /**
+   * The buffer to hold the on-disk representation of this page, or NULL if
+   * the page is not resident
+   **/
+  char          *pageBuffer;
 };
 
 typedef struct {
@@ -83,12 +92,49 @@ static inline BlockMapPage *asBlockMapPage(TreePage *treePage)
   return (BlockMapPage *) treePage->pageBuffer;
 }
 
+/**
+ * Check whether a tree page is resident in memory. A page which is not
+ * resident is treated as one which has not been loaded.
+ *
+ * @param treePage  The page to check
+ *
+ * @return <code>true</code> if the page has a buffer
+ **/
+__attribute__((warn_unused_result))
+static inline bool isTreePageResident(const TreePage *treePage)
+{
+  return (treePage->pageBuffer != NULL);
+}
+
+/**
+ * Make a tree page resident by giving it a zeroed buffer if it does not
+ * already have one.
+ *
+ * @param treePage  The page
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+int makeTreePageResident(TreePage *treePage)
+  __attribute__((warn_unused_result));
+
+/**
+ * Add a resident height one tree page which was loaded outside of a lookup to
+ * the resident pages of the zone which owns it. No page is evicted to make
+ * room, since a traversal and whatever uses its results rely on every page it
+ * loaded staying resident; the zone evicts down to its limit once lookups
+ * resume.
+ *
+ * @param zone      The zone which owns the page
+ * @param treePage  The page, which must be resident
+ **/
+void recordResidentTreePage(BlockMapTreeZone *zone, TreePage *treePage);
+
 /**
  * Replace the VIOPool in a tree zone. This method is used by unit tests.
  *
  * @param zone      The zone whose pool is to be replaced
  * @param layer     The physical layer from which to make VIOs
- * @param poolSize  The size of the new pool
+ * @param poolSize  The size of the new pool, which will not grow
  *
  * @return VDO_SUCCESS or an error
  **/
@@ -24,6 +24,15 @@
 #include "logger.h"
 #include "statusCodes.h"
 
+enum {
+  /**
+   * The maximum number of callbacks which may be run inline, one inside
+   * another, on a single thread before further callbacks are enqueued so as
+   * to unwind the stack.
+   **/
+  MAX_INLINE_CALLBACK_DEPTH = 32,
+};
+
 static const char *VDO_COMPLETION_TYPE_NAMES[] = {
   // Keep UNSET_COMPLETION_TYPE at the top.
   "UNSET_COMPLETION_TYPE",
@@ -36,16 +45,20 @@ static const char *VDO_COMPLETION_TYPE_NAMES[] = {
   "BLOCK_ALLOCATOR_COMPLETION",
   "BLOCK_MAP_RECOVERY_COMPLETION",
   "CHECK_IDENTIFIER_COMPLETION",
+  "DEDUPE_BATCH_COMPLETION",
   "EXTERNAL_COMPLETION",
   "FLUSH_NOTIFICATION_COMPLETION",
   "GENERATION_FLUSHED_COMPLETION",
   "HEARTBEAT_COMPLETION",
   "LOCK_COUNTER_COMPLETION",
+  "PACKER_RESIDENCY_COMPLETION",
+  "PAGE_CACHE_REAPER_COMPLETION",
   "PARTITION_COPY_COMPLETION",
   "READ_ONLY_MODE_COMPLETION",
   "READ_ONLY_REBUILD_COMPLETION",
   "RECOVERY_COMPLETION",
   "REFERENCE_COUNT_REBUILD_COMPLETION",
+  "SLAB_JOURNAL_BATCH_COMPLETION",
   "SLAB_SCRUBBER_COMPLETION",
   "SUB_TASK_COMPLETION",
   "TEST_COMPLETION",
@@ -139,7 +152,24 @@ void invokeCallback(VDOCompletion *completion)
                     getCompletionTypeName(completion->type));
   }
 
+  PhysicalLayer *layer = completion->layer;
+  uint8_t *depth = ((layer->getCallbackDepth == NULL)
+                    ? NULL : layer->getCallbackDepth());
+  if (depth == NULL) {
+    runCallback(completion);
+    return;
+  }
+
+  if ((*depth >= MAX_INLINE_CALLBACK_DEPTH)
+      && (completion->enqueueable != NULL)) {
+    // The callback could run here, but the stack is already deep.
+    layer->enqueue(completion->enqueueable);
+    return;
+  }
+
+  (*depth)++;
   runCallback(completion);
+  (*depth)--;
 }
 
 /**********************************************************************/
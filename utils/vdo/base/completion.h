@@ -40,16 +40,20 @@ typedef enum __attribute__((packed)) {
   BLOCK_ALLOCATOR_COMPLETION,
   BLOCK_MAP_RECOVERY_COMPLETION,
   CHECK_IDENTIFIER_COMPLETION,
+  DEDUPE_BATCH_COMPLETION,
   EXTERNAL_COMPLETION,
   FLUSH_NOTIFICATION_COMPLETION,
   GENERATION_FLUSHED_COMPLETION,
   HEARTBEAT_COMPLETION,
   LOCK_COUNTER_COMPLETION,
+  PACKER_RESIDENCY_COMPLETION,
+  PAGE_CACHE_REAPER_COMPLETION,
   PARTITION_COPY_COMPLETION,
   READ_ONLY_MODE_COMPLETION,
   READ_ONLY_REBUILD_COMPLETION,
   RECOVERY_COMPLETION,
   REFERENCE_COUNT_REBUILD_COMPLETION,
+  SLAB_JOURNAL_BATCH_COMPLETION,
   SLAB_SCRUBBER_COMPLETION,
   SUB_TASK_COMPLETION,
   TEST_COMPLETION,                      // each unit test may define its own
@@ -122,7 +122,8 @@ bool mayCompressDataVIO(DataVIO *dataVIO)
 /**********************************************************************/
 bool mayPackDataVIO(DataVIO *dataVIO)
 {
-  if (!isSufficientlyCompressible(dataVIO)
+  dataVIO->isIncompressible = !isSufficientlyCompressible(dataVIO);
+  if (dataVIO->isIncompressible
       || !getVDOCompressing(getVDOFromDataVIO(dataVIO))
       || getCompressionState(dataVIO).mayNotCompress) {
     // If the data in this VIO doesn't compress, or compression is off, or
@@ -29,3 +29,13 @@ const BlockCount MAXIMUM_PHYSICAL_BLOCKS = 1024ULL * 1024 * 1024 * 64;
 
 // unit test minimum
 const BlockCount MINIMUM_SLAB_JOURNAL_BLOCKS = 2;
+
+/** The largest external metadata device is 16 terabytes, 4 gigablocks. */
+const BlockCount MAXIMUM_EXTERNAL_METADATA_BLOCKS = 1024ULL * 1024 * 1024 * 4;
+
+/**
+ * The start of the external metadata device in the layer's address space,
+ * MAXIMUM_PHYSICAL_BLOCKS - MAXIMUM_EXTERNAL_METADATA_BLOCKS.
+ **/
+const PhysicalBlockNumber EXTERNAL_METADATA_ORIGIN
+  = 1024ULL * 1024 * 1024 * 60;
@@ -105,4 +105,16 @@ extern const BlockCount MAXIMUM_LOGICAL_BLOCKS;
 // unit test minimum
 extern const BlockCount MINIMUM_SLAB_JOURNAL_BLOCKS;
 
+/** The maximum size of an external metadata device. */
+extern const BlockCount MAXIMUM_EXTERNAL_METADATA_BLOCKS;
+
+/**
+ * The physical block number at which a layer maps the start of an external
+ * metadata device. The device occupies the top of the PBN space which block
+ * map and recovery journal entries can represent, so that block map tree
+ * pages allocated from it can be recorded like any other, and a VDO with an
+ * external device may not have a physical size beyond this origin.
+ **/
+extern const PhysicalBlockNumber EXTERNAL_METADATA_ORIGIN;
+
 #endif // CONSTANTS_H
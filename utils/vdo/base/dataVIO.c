@@ -81,6 +81,7 @@ static void initializeLBNLock(DataVIO *dataVIO, LogicalBlockNumber lbn)
   lock->lbn     = lbn;
   lock->locked  = false;
   initializeWaitQueue(&lock->waiters);
+  initializeWaitQueue(&lock->superseded);
 
   VDO *vdo   = getVDOFromDataVIO(dataVIO);
   lock->zone = getLogicalZone(vdo->logicalZones, computeLogicalZone(dataVIO));
@@ -102,7 +103,12 @@ void prepareDataVIO(DataVIO            *dataVIO,
 
   resetAllocation(dataVIOAsAllocatingVIO(dataVIO));
 
-  dataVIO->isDuplicate = false;
+  dataVIO->isDuplicate         = false;
+  dataVIO->isDuplicateVerified = false;
+  dataVIO->isIncompressible    = false;
+  dataVIO->wasMapped           = false;
+  dataVIO->streamHints         = 0;
+  dataVIO->isDedupeBypassed    = false;
 
   memset(&dataVIO->chunkName, 0, sizeof(dataVIO->chunkName));
   memset(&dataVIO->duplicate, 0, sizeof(dataVIO->duplicate));
@@ -315,10 +321,91 @@ static void releaseLock(DataVIO *dataVIO)
   return;
 }
 
+/**
+ * Check whether a write waiting for an LBN lock may be superseded by a newer
+ * write to the same block which is queued immediately behind it. A superseded
+ * write is never itself written; it is acknowledged when the newer write
+ * completes. Writes which require a flush before or after (FUA) are never
+ * superseded since their durability is visible to the requestor, and a write
+ * which requires a preflush may not supersede an older write. Since partial
+ * writes are queued as read-modify-writes, neither they nor reads will ever
+ * be collapsed.
+ *
+ * @param older  The older of the two queued requests
+ * @param newer  The request queued immediately after the older one
+ *
+ * @return <code>true</code> if the newer request supersedes the older one
+ **/
+static bool maySupersede(DataVIO *older, DataVIO *newer)
+{
+  VIO *olderVIO = dataVIOAsVIO(older);
+  VIO *newerVIO = dataVIOAsVIO(newer);
+  return (isWriteVIO(olderVIO)
+          && isWriteVIO(newerVIO)
+          && !vioRequiresFlushBefore(olderVIO)
+          && !vioRequiresFlushAfter(olderVIO)
+          && !vioRequiresFlushBefore(newerVIO));
+}
+
+/**
+ * Collapse a run of queued writes at the head of an LBN lock's wait queue.
+ * Each write which is immediately followed in the queue by a write which may
+ * supersede it is moved, along with anything it has already superseded, to
+ * the superseded queue of its successor.
+ *
+ * @param lock        The lock being transferred
+ * @param nextHolder  The waiter which was dequeued to become the next holder
+ *
+ * @return The DataVIO which should become the next lock holder
+ **/
+static DataVIO *supersedeQueuedWrites(LBNLock *lock, DataVIO *nextHolder)
+{
+  DataVIO *successor = waiterAsDataVIO(getFirstWaiter(&lock->waiters));
+  while ((successor != NULL) && maySupersede(nextHolder, successor)) {
+    dequeueNextWaiter(&lock->waiters);
+    transferAllWaiters(&nextHolder->logical.superseded,
+                       &successor->logical.superseded);
+    int result = enqueueDataVIO(&successor->logical.superseded, nextHolder,
+                                THIS_LOCATION("$F;cb=superseded"));
+    if (result != VDO_SUCCESS) {
+      finishDataVIO(nextHolder, result);
+    } else {
+      countSupersededWrite(lock->zone);
+    }
+
+    nextHolder = successor;
+    successor  = waiterAsDataVIO(getFirstWaiter(&lock->waiters));
+  }
+
+  return nextHolder;
+}
+
+/**
+ * Complete a write which was superseded by a newer write to the same LBN now
+ * that the newer write is done. This callback is registered in
+ * releaseLogicalBlockLock().
+ *
+ * @param waiter   The superseded DataVIO
+ * @param context  A pointer to the result of the superseding DataVIO
+ **/
+static void finishSupersededWrite(Waiter *waiter, void *context)
+{
+  DataVIO *dataVIO = waiterAsDataVIO(waiter);
+  // Avoid stack overflow when completing a long run of superseded writes.
+  dataVIOAsCompletion(dataVIO)->requeue = true;
+  finishDataVIO(dataVIO, *((int *) context));
+}
+
 /**********************************************************************/
 void releaseLogicalBlockLock(DataVIO *dataVIO)
 {
   assertInLogicalZone(dataVIO);
+  if (hasWaiters(&dataVIO->logical.superseded)) {
+    int result = dataVIOAsCompletion(dataVIO)->result;
+    notifyAllWaiters(&dataVIO->logical.superseded, finishSupersededWrite,
+                     &result);
+  }
+
   if (!hasWaiters(&dataVIO->logical.waiters)) {
     releaseLock(dataVIO);
     return;
@@ -331,6 +418,9 @@ void releaseLogicalBlockLock(DataVIO *dataVIO)
   // lock map operation
   DataVIO *nextLockHolder = waiterAsDataVIO(dequeueNextWaiter(&lock->waiters));
 
+  // Only the newest of a run of queued overwrites needs to be written.
+  nextLockHolder = supersedeQueuedWrites(lock, nextLockHolder);
+
   // Transfer the remaining lock waiters to the next lock holder.
   transferAllWaiters(&lock->waiters, &nextLockHolder->logical.waiters);
 
@@ -88,6 +88,8 @@ struct lbnLock {
   bool                locked;
   /* The queue of waiters for the lock */
   WaitQueue           waiters;
+  /* The queue of older writes to the LBN which this request supersedes */
+  WaitQueue           superseded;
   /* The logical zone of the LBN */
   LogicalZone        *zone;
 };
@@ -135,6 +137,9 @@ typedef struct {
   /* The packer input bin to which the enclosing DataVIO has been assigned */
   InputBin      *bin;
 
+  /* The time (in microseconds) at which the DataVIO entered an input bin */
+  uint64_t       arrivalTime;
+
   /* A pointer to the compressed form of this block */
   char          *data;
 
@@ -179,6 +184,21 @@ struct dataVIO {
   /* Whether this VIO write is a duplicate */
   bool                 isDuplicate;
 
+  /* Whether isDuplicate was verified against cached data of the candidate */
+  bool                 isDuplicateVerified;
+
+  /* Whether the data of this VIO write was found not to compress */
+  bool                 isIncompressible;
+
+  /* Whether the LBN of this VIO write was mapped before the write */
+  bool                 wasMapped;
+
+  /* The StreamClass flags of the LBN region of this VIO write */
+  StreamHints          streamHints;
+
+  /* Whether this VIO write skipped the UDS query for its data */
+  bool                 isDedupeBypassed;
+
   /*
    * Whether this VIO has received an allocation (needs to be atomic so it can
    * be examined from threads not in the allocation zone).
@@ -937,6 +957,10 @@ void attemptLogicalBlockLock(VDOCompletion *completion);
 
 /**
  * Release the lock on the logical block, if any, that a DataVIO has acquired.
+ * Any writes which were superseded by this DataVIO while waiting for the lock
+ * are completed with the result of this DataVIO. If the lock has waiters, a
+ * run of queued writes at the head of the queue will be collapsed so that
+ * only the newest of them needs to be written.
  *
  * @param dataVIO  The DataVIO releasing its logical block lock
  **/
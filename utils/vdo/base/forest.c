@@ -85,6 +85,7 @@ struct cursors {
   EntryCallback    *entryCallback;
   VDOCompletion    *parent;
   RootCount         activeRoots;
+  int               result;
   Cursor            cursors[];
 };
 
@@ -208,7 +209,12 @@ static int makeSegment(Forest      *oldForest,
 
       segment->levels[height] = pagePtr;
       if (height == (BLOCK_MAP_TREE_HEIGHT - 1)) {
-        // Record the root.
+        // Record the root, which is always resident.
+        int result = makeTreePageResident(pagePtr);
+        if (result != VDO_SUCCESS) {
+          return result;
+        }
+
         BlockMapPage *page = formatBlockMapPage(pagePtr->pageBuffer,
                                                 forest->map->nonce,
                                                 INVALID_PBN, true);
@@ -222,13 +228,43 @@ static int makeSegment(Forest      *oldForest,
   return VDO_SUCCESS;
 }
 
+/**
+ * Free the pages of one segment of a forest, along with the buffers of any
+ * of them which are resident.
+ *
+ * @param forest   The forest
+ * @param segment  The segment whose pages are to be freed
+ **/
+static void freeSegmentPages(Forest *forest, size_t segment)
+{
+  TreePage *pages = forest->pages[segment];
+  if (pages == NULL) {
+    return;
+  }
+
+  BlockCount pageCount = 0;
+  for (Height height = 0; height < BLOCK_MAP_TREE_HEIGHT; height++) {
+    pageCount += forest->boundaries[segment].levels[height];
+    if (segment > 0) {
+      pageCount -= forest->boundaries[segment - 1].levels[height];
+    }
+  }
+
+  pageCount *= forest->map->rootCount;
+  for (BlockCount i = 0; i < pageCount; i++) {
+    FREE(pages[i].pageBuffer);
+  }
+
+  FREE(pages);
+}
+
 /**********************************************************************/
 static void deforest(Forest *forest, size_t firstPageSegment)
 {
   if (forest->pages != NULL) {
     for (size_t segment = firstPageSegment; segment < forest->segments;
          segment++) {
-      FREE(forest->pages[segment]);
+      freeSegmentPages(forest, segment);
     }
     FREE(forest->pages);
   }
@@ -334,9 +370,10 @@ static void finishCursor(Cursor *cursor)
   }
 
   VDOCompletion *parent = cursors->parent;
+  int            result = cursors->result;
   FREE(cursors);
 
-  finishCompletion(parent, VDO_SUCCESS);
+  finishCompletion(parent, result);
 }
 
 /**********************************************************************/
@@ -369,8 +406,17 @@ static void finishTraversalLoad(VDOCompletion *completion)
   TreePage     *treePage
     = &(cursor->tree->segments[0].levels[height][level->pageIndex]);
   BlockMapPage *page = (BlockMapPage *) treePage->pageBuffer;
-  copyValidPage(entry->buffer, cursor->parent->map->nonce,
-                entry->vio->physical, page);
+  BlockMap     *map  = cursor->parent->map;
+  copyValidPage(entry->buffer, map->nonce, entry->vio->physical, page);
+  if (height == 1) {
+    // Give this height one page to the zone which owns its tree, so that
+    // lookups can evict it once they resume. Traversals only run while the
+    // block map is quiescent, so the zone may be updated from here.
+    RootCount rootIndex = cursor->tree - map->forest->trees;
+    BlockMapZone *zone  = getBlockMapZone(map, rootIndex % map->zoneCount);
+    recordResidentTreePage(&zone->treeZone, treePage);
+  }
+
   traverse(cursor);
 }
 
@@ -387,6 +433,10 @@ static void traverse(Cursor *cursor)
     CursorLevel *level  = &cursor->levels[height];
     TreePage *treePage
       = &(cursor->tree->segments[0].levels[height][level->pageIndex]);
+    if (!isTreePageResident(treePage)) {
+      continue;
+    }
+
     BlockMapPage *page = (BlockMapPage *) treePage->pageBuffer;
     if (!isBlockMapPageInitialized(page)) {
       continue;
@@ -432,6 +482,17 @@ static void traverse(Cursor *cursor)
         continue;
       }
 
+      // Interior pages only have buffers once they are used, so give this
+      // one a buffer to read into.
+      TreePage *nextPage
+        = &(cursor->tree->segments[0].levels[height - 1][entryIndex]);
+      int result = makeTreePageResident(nextPage);
+      if (result != VDO_SUCCESS) {
+        cursor->parent->result = result;
+        finishCursor(cursor);
+        return;
+      }
+
       cursor->height--;
       CursorLevel *nextLevel = &cursor->levels[cursor->height];
       nextLevel->pageIndex   = entryIndex;
@@ -117,12 +117,18 @@
 #include "ringNode.h"
 #include "slab.h"
 #include "slabDepot.h"
+#include "streamDetector.h"
 #include "trace.h"
 #include "types.h"
 #include "vdoInternal.h"
 #include "vioWrite.h"
 #include "waitQueue.h"
 
+enum {
+  /** log2 of the fraction of names queried in non-duplicate regions */
+  DEDUPE_SAMPLE_SHIFT = 4,
+};
+
 static const char *LOCK_STATE_NAMES[] = {
   [HASH_LOCK_BYPASSING]    = "BYPASSING",
   [HASH_LOCK_DEDUPING]     = "DEDUPING",
@@ -661,7 +667,7 @@ static void startUpdating(HashLock *lock, DataVIO *agent)
 
   agent->lastAsyncOperation = UPDATE_INDEX;
   setHashZoneCallback(agent, finishUpdating, THIS_LOCATION(NULL));
-  dataVIOAsCompletion(agent)->layer->updateAlbireo(agent);
+  updateAlbireoInZone(agent->hashZone, agent);
 }
 
 /**
@@ -921,6 +927,14 @@ static void startVerifying(HashLock *lock, DataVIO *agent)
    */
   VDOCompletion *completion = dataVIOAsCompletion(agent);
   agent->lastAsyncOperation = VERIFY_DEDUPLICATION;
+  if (agent->isDuplicateVerified) {
+    // The advice was already checked against cached data while locking it.
+    agent->isDuplicateVerified = false;
+    bumpHashZoneCachedVerificationCount(agent->hashZone);
+    finishVerifying(completion);
+    return;
+  }
+
   setHashZoneCallback(agent, finishVerifying, THIS_LOCATION(NULL));
   completion->layer->verifyDuplication(agent);
 }
@@ -1011,6 +1025,7 @@ static void lockDuplicatePBN(VDOCompletion *completion)
   assertInDuplicateZone(agent);
 
   setHashZoneCallback(agent, finishLocking, THIS_LOCATION(NULL));
+  agent->isDuplicateVerified = false;
 
   // While in the zone that owns it, find out how many additional references
   // can be made to the block if it turns out to truly be a duplicate.
@@ -1102,6 +1117,12 @@ static void lockDuplicatePBN(VDOCompletion *completion)
   // so mark it as such.
   setDuplicateLock(agent->hashLock, lock);
 
+  // If the candidate was written recently, the read lock guarantees that its
+  // cached data is still what is on disk, so compare against that now rather
+  // than reading the block back to verify it. A mismatch is left for the
+  // layer to verify as usual.
+  agent->isDuplicateVerified = matchesRecentWrite(zone, agent);
+
   /*
    * XXX VDOSTORY-190 Optimization: Same as startLocking() lazily changing
    * state to save on having to switch back to the hash zone thread. Here we
@@ -1155,7 +1176,8 @@ static void finishWriting(HashLock *lock, DataVIO *agent)
   lock->duplicate = agent->newMapped;
   lock->verified  = true;
 
-  if (isCompressed(lock->duplicate.state) && lock->registered) {
+  if (isCompressed(lock->duplicate.state) && lock->registered
+      && !lock->indexBypassed) {
     // Compression means the location we gave in the UDS query is not the
     // location we're using to deduplicate.
     lock->updateAdvice = true;
@@ -1340,6 +1362,32 @@ static void finishQuerying(VDOCompletion *completion)
   }
 }
 
+/**
+ * Decide whether the agent of a new hash lock should skip the UDS query. The
+ * query is skipped for writes to regions which have not been deduplicating,
+ * except for a sample of names which keeps measuring whether they have
+ * started to.
+ *
+ * @param dataVIO  The DataVIO which would perform the query
+ *
+ * @return <code>true</code> if the query should be skipped
+ **/
+static bool shouldBypassQuery(DataVIO *dataVIO)
+{
+  if ((dataVIO->streamHints & STREAM_NON_DUPLICATE) == 0) {
+    return false;
+  }
+
+  if (isSampledChunkName(&dataVIO->chunkName, QUERY_SAMPLE_NAME_BYTE,
+                         DEDUPE_SAMPLE_SHIFT)) {
+    bumpHashZoneSampledQueryCount(dataVIO->hashZone);
+    return false;
+  }
+
+  bumpHashZoneBypassedQueryCount(dataVIO->hashZone);
+  return true;
+}
+
 /**
  * Start deduplication for a hash lock that has finished initializing by
  * making the DataVIO that requested it the agent, entering the QUERYING
@@ -1351,12 +1399,26 @@ static void finishQuerying(VDOCompletion *completion)
 static void startQuerying(HashLock *lock, DataVIO *dataVIO)
 {
   setAgent(lock, dataVIO);
+
+  if (shouldBypassQuery(dataVIO)) {
+    /*
+     * INITIALIZING -> WRITING transition: The region is not deduplicating,
+     * so write the data without asking UDS for advice. Since nothing was
+     * posted, there is no advice to update either. Later arrivals may still
+     * deduplicate against the written block.
+     */
+    lock->indexBypassed       = true;
+    lock->updateAdvice        = false;
+    dataVIO->isDedupeBypassed = true;
+    startWriting(lock, dataVIO);
+    return;
+  }
+
   setHashLockState(lock, HASH_LOCK_QUERYING);
 
-  VDOCompletion *completion   = dataVIOAsCompletion(dataVIO);
   dataVIO->lastAsyncOperation = CHECK_FOR_DEDUPLICATION;
   setHashZoneCallback(dataVIO, finishQuerying, THIS_LOCATION(NULL));
-  completion->layer->checkForDuplication(dataVIO);
+  checkForDuplicationInZone(dataVIO->hashZone, dataVIO);
 }
 
 /**
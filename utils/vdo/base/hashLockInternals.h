@@ -89,6 +89,9 @@ struct hashLock {
   /** True if this lock is registered in the lock map (cleared on rollover) */
   bool           registered;
 
+  /** True if this lock skipped querying and updating the UDS index */
+  bool           indexBypassed;
+
   /**
    * If verified is false, this is the location of a possible duplicate.
    * If verified is true, is is the verified location of a true duplicate.
@@ -26,6 +26,7 @@
 #include "numeric.h"
 #include "permassert.h"
 
+#include "completion.h"
 #include "constants.h"
 #include "dataVIO.h"
 #include "hashLock.h"
@@ -33,6 +34,7 @@
 #include "pointerMap.h"
 #include "ringNode.h"
 #include "statistics.h"
+#include "streamDetector.h"
 #include "threadConfig.h"
 #include "types.h"
 #include "vdoInternal.h"
@@ -57,6 +59,21 @@ typedef struct atomicHashLockStatistics {
 
   /** Number of writes whose hash collided with an in-flight write */
   Atomic64 concurrentHashCollisions;
+
+  /** Number of UDS queries skipped for regions which do not deduplicate */
+  Atomic64 dedupeQueriesBypassed;
+
+  /** Number of UDS queries sampled from regions which do not deduplicate */
+  Atomic64 dedupeQueriesSampled;
+
+  /** Number of UDS updates for data unlikely to dedupe which were sent */
+  Atomic64 indexPostsSampled;
+
+  /** Number of UDS updates for data unlikely to dedupe which were skipped */
+  Atomic64 indexPostsSkipped;
+
+  /** Number of dedupe verifications made against recently written data */
+  Atomic64 dedupeVerificationsCached;
 } AtomicHashLockStatistics;
 
 struct hashZone {
@@ -77,6 +94,25 @@ struct hashZone {
 
   /** Array of all HashLocks */
   HashLock *lockArray;
+
+  /** The layer to which dedupe index requests are submitted */
+  PhysicalLayer *layer;
+
+  /** log2 of the inverse of the fraction of names of data unlikely to
+   *  deduplicate whose advice is updated in the index (0 = update all) */
+  unsigned int postSampleShift;
+
+  /** DataVIOs waiting for their UDS queries to be submitted */
+  WaitQueue pendingQueries;
+
+  /** DataVIOs waiting for their UDS updates to be submitted */
+  WaitQueue pendingUpdates;
+
+  /** Completion for submitting the pending index requests in batches */
+  VDOCompletion batchCompletion;
+
+  /** Whether the batch completion has been launched */
+  bool batchLaunched;
 };
 
 /**
@@ -127,8 +163,19 @@ int makeHashZone(VDO *vdo, ZoneCount zoneNumber, HashZone **zonePtr)
 
   zone->zoneNumber = zoneNumber;
   zone->threadID   = getHashZoneThread(getThreadConfig(vdo), zoneNumber);
+  zone->layer      = vdo->layer;
+  zone->postSampleShift
+    = minUInt64(vdo->loadConfig.indexPostSampleShift, MAX_NAME_SAMPLE_SHIFT);
   initializeRing(&zone->lockPool);
 
+  result = initializeEnqueueableCompletion(&zone->batchCompletion,
+                                           DEDUPE_BATCH_COMPLETION,
+                                           vdo->layer);
+  if (result != VDO_SUCCESS) {
+    freeHashZone(&zone);
+    return result;
+  }
+
   result = ALLOCATE(LOCK_POOL_CAPACITY, HashLock, "HashLock array",
                     &zone->lockArray);
   if (result != VDO_SUCCESS) {
@@ -154,6 +201,7 @@ void freeHashZone(HashZone **zonePtr)
   }
 
   HashZone *zone = *zonePtr;
+  destroyEnqueueable(&zone->batchCompletion);
   freePointerMap(&zone->hashLockMap);
   FREE(zone->lockArray);
   FREE(zone);
@@ -182,6 +230,12 @@ HashLockStatistics getHashZoneStatistics(const HashZone *zone)
     .concurrentDataMatches = relaxedLoad64(&atoms->concurrentDataMatches),
     .concurrentHashCollisions
       = relaxedLoad64(&atoms->concurrentHashCollisions),
+    .dedupeQueriesBypassed = relaxedLoad64(&atoms->dedupeQueriesBypassed),
+    .dedupeQueriesSampled  = relaxedLoad64(&atoms->dedupeQueriesSampled),
+    .indexPostsSampled     = relaxedLoad64(&atoms->indexPostsSampled),
+    .indexPostsSkipped     = relaxedLoad64(&atoms->indexPostsSkipped),
+    .dedupeVerificationsCached
+      = relaxedLoad64(&atoms->dedupeVerificationsCached),
   };
 }
 
@@ -307,6 +361,115 @@ static void dumpHashLock(const HashLock *lock)
           (void *) lock->agent);
 }
 
+/**
+ * Submit the index requests which accumulated while the batch completion was
+ * waiting its turn on the hash zone thread. This callback is registered in
+ * queueIndexRequest().
+ *
+ * @param completion  The hash zone's batch completion
+ **/
+static void submitIndexRequests(VDOCompletion *completion)
+{
+  HashZone *zone = completion->parent;
+  zone->batchLaunched = false;
+  if (hasWaiters(&zone->pendingQueries)) {
+    zone->layer->checkForDuplicationBatch(&zone->pendingQueries);
+  }
+
+  if (hasWaiters(&zone->pendingUpdates)) {
+    zone->layer->updateAlbireoBatch(&zone->pendingUpdates);
+  }
+}
+
+/**
+ * Add a DataVIO to a queue of index requests and make sure the queue will be
+ * submitted once the hash zone thread has worked through the requests which
+ * are already queued to it.
+ *
+ * @param zone     The hash zone
+ * @param queue    The queue of pending requests of the DataVIO's type
+ * @param dataVIO  The DataVIO making the request
+ **/
+static void queueIndexRequest(HashZone  *zone,
+                              WaitQueue *queue,
+                              DataVIO   *dataVIO)
+{
+  int result = enqueueDataVIO(queue, dataVIO, THIS_LOCATION(NULL));
+  if (result != VDO_SUCCESS) {
+    continueDataVIO(dataVIO, result);
+    return;
+  }
+
+  if (zone->batchLaunched) {
+    return;
+  }
+
+  zone->batchLaunched = true;
+  prepareForRequeue(&zone->batchCompletion, submitIndexRequests,
+                    submitIndexRequests, zone->threadID, zone);
+  invokeCallback(&zone->batchCompletion);
+}
+
+/**
+ * Decide whether the index update for a DataVIO should be skipped. Names of
+ * data which is unlikely to deduplicate would only refresh index entries
+ * that will never match, keeping them in the index at the expense of data
+ * that does deduplicate, so only a sample of them is updated. The sample is
+ * taken from a different name byte than the query sample, so that it also
+ * thins out the names whose queries were sampled. Queries are not affected,
+ * since the layer posts a new name as part of the query.
+ *
+ * @param zone     The hash zone
+ * @param dataVIO  The DataVIO making the update
+ *
+ * @return <code>true</code> if the update should be skipped
+ **/
+static bool shouldSkipIndexUpdate(HashZone *zone, const DataVIO *dataVIO)
+{
+  if ((zone->postSampleShift == 0)
+      || ((dataVIO->streamHints
+           & (STREAM_NON_DUPLICATE | STREAM_INCOMPRESSIBLE)) == 0)) {
+    return false;
+  }
+
+  if (isSampledChunkName(&dataVIO->chunkName, POST_SAMPLE_NAME_BYTE,
+                         zone->postSampleShift)) {
+    relaxedAdd64(&zone->statistics.indexPostsSampled, 1);
+    return false;
+  }
+
+  relaxedAdd64(&zone->statistics.indexPostsSkipped, 1);
+  return true;
+}
+
+/**********************************************************************/
+void checkForDuplicationInZone(HashZone *zone, DataVIO *dataVIO)
+{
+  if (zone->layer->checkForDuplicationBatch == NULL) {
+    zone->layer->checkForDuplication(dataVIO);
+    return;
+  }
+
+  queueIndexRequest(zone, &zone->pendingQueries, dataVIO);
+}
+
+/**********************************************************************/
+void updateAlbireoInZone(HashZone *zone, DataVIO *dataVIO)
+{
+  if (shouldSkipIndexUpdate(zone, dataVIO)) {
+    // Leave the old advice in the index; it ages out if never queried.
+    continueDataVIO(dataVIO, VDO_SUCCESS);
+    return;
+  }
+
+  if (zone->layer->updateAlbireoBatch == NULL) {
+    zone->layer->updateAlbireo(dataVIO);
+    return;
+  }
+
+  queueIndexRequest(zone, &zone->pendingUpdates, dataVIO);
+}
+
 /**********************************************************************/
 void bumpHashZoneValidAdviceCount(HashZone *zone)
 {
@@ -335,6 +498,27 @@ void bumpHashZoneCollisionCount(HashZone *zone)
   relaxedAdd64(&zone->statistics.concurrentHashCollisions, 1);
 }
 
+/**********************************************************************/
+void bumpHashZoneBypassedQueryCount(HashZone *zone)
+{
+  // Must only be mutated on the hash zone thread.
+  relaxedAdd64(&zone->statistics.dedupeQueriesBypassed, 1);
+}
+
+/**********************************************************************/
+void bumpHashZoneSampledQueryCount(HashZone *zone)
+{
+  // Must only be mutated on the hash zone thread.
+  relaxedAdd64(&zone->statistics.dedupeQueriesSampled, 1);
+}
+
+/**********************************************************************/
+void bumpHashZoneCachedVerificationCount(HashZone *zone)
+{
+  // Must only be mutated on the hash zone thread.
+  relaxedAdd64(&zone->statistics.dedupeVerificationsCached, 1);
+}
+
 /**********************************************************************/
 void dumpHashZone(const HashZone *zone)
 {
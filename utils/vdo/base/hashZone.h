@@ -27,6 +27,38 @@
 #include "statistics.h"
 #include "types.h"
 
+enum {
+  /** The largest sample shift, since samples are taken from one name byte */
+  MAX_NAME_SAMPLE_SHIFT = 8,
+  /** The name byte which selects the UDS queries sampled in regions which
+   *  are not deduplicating (the first byte selects the hash zone) */
+  QUERY_SAMPLE_NAME_BYTE = 1,
+  /** The name byte which selects the sampled UDS advice updates of data
+   *  unlikely to deduplicate, which must differ from the query sample byte */
+  POST_SAMPLE_NAME_BYTE = 2,
+};
+
+/**
+ * Check whether a chunk name is in a sample of names chosen by the bits of
+ * one name byte, so that copies of the same data are always sampled alike.
+ * Samples taken from the same byte are nested: a sample with a larger shift
+ * is contained in every sample with a smaller one. Samples taken from
+ * different bytes are independent.
+ *
+ * @param name   The chunk name to check
+ * @param byte   The index of the name byte to sample by
+ * @param shift  log2 of the inverse of the fraction of names sampled, at most
+ *               MAX_NAME_SAMPLE_SHIFT
+ *
+ * @return <code>true</code> if the name is in the sample
+ **/
+static inline bool isSampledChunkName(const UdsChunkName *name,
+                                      unsigned int        byte,
+                                      unsigned int        shift)
+{
+  return ((name->name[byte] & ((1 << shift) - 1)) == 0);
+}
+
 /**
  * Create a hash zone.
  *
@@ -107,6 +139,26 @@ int acquireHashLockFromZone(HashZone            *zone,
  **/
 void returnHashLockToZone(HashZone *zone, HashLock **lockPtr);
 
+/**
+ * Ask the layer whether the data of a DataVIO is a duplicate. If the layer
+ * supports batching, the query is held until the hash zone has processed the
+ * work already queued to it, and then submitted along with every other query
+ * which arrived in the meantime.
+ *
+ * @param zone     The hash zone of the DataVIO
+ * @param dataVIO  The DataVIO to query
+ **/
+void checkForDuplicationInZone(HashZone *zone, DataVIO *dataVIO);
+
+/**
+ * Ask the layer to update the index entry for the data of a DataVIO, batching
+ * the update with others from the same hash zone if the layer supports it.
+ *
+ * @param zone     The hash zone of the DataVIO
+ * @param dataVIO  The DataVIO whose index entry needs to change
+ **/
+void updateAlbireoInZone(HashZone *zone, DataVIO *dataVIO);
+
 /**
  * Increment the valid advice count in the hash zone statistics.
  * Must only be called from the hash zone thread.
@@ -139,6 +191,31 @@ void bumpHashZoneDataMatchCount(HashZone *zone);
  **/
 void bumpHashZoneCollisionCount(HashZone *zone);
 
+/**
+ * Increment the bypassed query count in the hash zone statistics.
+ * Must only be called from the hash zone thread.
+ *
+ * @param zone  The hash zone of the lock that skipped the UDS query
+ **/
+void bumpHashZoneBypassedQueryCount(HashZone *zone);
+
+/**
+ * Increment the sampled query count in the hash zone statistics.
+ * Must only be called from the hash zone thread.
+ *
+ * @param zone  The hash zone of the lock that sampled the UDS query
+ **/
+void bumpHashZoneSampledQueryCount(HashZone *zone);
+
+/**
+ * Increment the cached verification count in the hash zone statistics.
+ * Must only be called from the hash zone thread.
+ *
+ * @param zone  The hash zone of the lock whose advice was verified without
+ *              reading the duplicate candidate
+ **/
+void bumpHashZoneCachedVerificationCount(HashZone *zone);
+
 /**
  * Dump information about a hash zone to the log for debugging.
  *
@@ -63,6 +63,8 @@ typedef enum {
   SLAB_DEPOT        = 3,
   BLOCK_MAP         = 4,
   GEOMETRY_BLOCK    = 5,
+  EXTERNAL_LAYOUT   = 6,
+  EXTERNAL_LABEL    = 7,
 } ComponentID;
 
 /**
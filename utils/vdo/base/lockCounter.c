@@ -38,6 +38,16 @@
  *
  * Lock sets are laid out with the set for recovery journal first, followed by
  * the logical zones, and then the physical zones.
+ *
+ * Per-entry journal zone references are released by the logical zones as
+ * they apply journal entries to the block map. Rather than having every zone
+ * atomically decrement a shared count for each entry, each logical zone keeps
+ * its own running total of the releases it has made for each lock, arranged
+ * by zone like the other counters. Only the owning zone ever writes its
+ * totals, so publishing a release is a plain store rather than a locked
+ * read-modify-write on a cache line shared with every other zone, and the
+ * journal thread collects the releases from all zones whenever it checks
+ * whether the journal zone still holds a lock.
  **/
 typedef enum lockCounterState {
   LOCK_COUNTER_STATE_NOT_NOTIFYING = 0,
@@ -62,7 +72,7 @@ struct lockCounter {
   Atomic32      *physicalZoneCounts;
   /** The per-zone, per-lock counts for the journal zone */
   uint16_t      *journalCounters;
-  /** The per-zone, per-lock decrement counts for the journal zone */
+  /** The per-logical-zone, per-lock decrement counts for the journal zone */
   Atomic32      *journalDecrementCounts;
   /** The per-zone, per-lock reference counts for logical zones */
   uint16_t      *logicalCounters;
@@ -93,7 +103,7 @@ int makeLockCounter(PhysicalLayer  *layer,
     return result;
   }
 
-  result = ALLOCATE(locks, Atomic32, __func__,
+  result = ALLOCATE(locks * logicalZones, Atomic32, __func__,
                     &lockCounter->journalDecrementCounts);
   if (result != VDO_SUCCESS) {
     freeLockCounter(&lockCounter);
@@ -207,6 +217,42 @@ static inline uint16_t *getCounter(LockCounter *counter,
   return &counter->physicalCounters[zoneCounter];
 }
 
+/**
+ * Get the count of journal zone references to a given lock which have been
+ * released by a given logical zone.
+ *
+ * @param counter     The lock counter
+ * @param lockNumber  The lock
+ * @param zoneID      The logical zone which released the references
+ *
+ * @return A pointer to the decrement count for the lock and zone
+ **/
+static inline Atomic32 *getDecrementCount(LockCounter *counter,
+                                          BlockCount   lockNumber,
+                                          ZoneCount    zoneID)
+{
+  return &counter->journalDecrementCounts[(counter->locks * zoneID)
+                                          + lockNumber];
+}
+
+/**
+ * Get the total number of journal zone references to a given lock which have
+ * been released by all of the logical zones.
+ *
+ * @param counter     The lock counter
+ * @param lockNumber  The lock
+ *
+ * @return The total of the decrement counts for the lock
+ **/
+static uint32_t getDecrements(LockCounter *counter, BlockCount lockNumber)
+{
+  uint32_t decrements = 0;
+  for (ZoneCount zone = 0; zone < counter->logicalZones; zone++) {
+    decrements += atomicLoad32(getDecrementCount(counter, lockNumber, zone));
+  }
+  return decrements;
+}
+
 /**
  * Check whether the journal zone is locked for a given lock.
  *
@@ -219,8 +265,7 @@ static bool isJournalZoneLocked(LockCounter *counter, BlockCount lockNumber)
 {
   uint16_t journalValue
     = *(getCounter(counter, lockNumber, ZONE_TYPE_JOURNAL, 0));
-  uint32_t decrements
-    = atomicLoad32(&(counter->journalDecrementCounts[lockNumber]));
+  uint32_t decrements = getDecrements(counter, lockNumber);
   ASSERT_LOG_ONLY((decrements <= journalValue),
                   "journal zone lock counter must not underflow");
 
@@ -258,14 +303,15 @@ void initializeLockCount(LockCounter *counter,
                          uint16_t     value)
 {
   assertOnJournalThread(counter, __func__);
-  uint16_t *journalValue   = getCounter(counter, lockNumber, ZONE_TYPE_JOURNAL,
-                                        0);
-  Atomic32 *decrementCount = &(counter->journalDecrementCounts[lockNumber]);
-  ASSERT_LOG_ONLY((*journalValue == atomicLoad32(decrementCount)),
+  uint16_t *journalValue = getCounter(counter, lockNumber, ZONE_TYPE_JOURNAL,
+                                      0);
+  ASSERT_LOG_ONLY((*journalValue == getDecrements(counter, lockNumber)),
                   "count to be initialized not in use");
 
   *journalValue = value;
-  atomicStore32(decrementCount, 0);
+  for (ZoneCount zone = 0; zone < counter->logicalZones; zone++) {
+    atomicStore32(getDecrementCount(counter, lockNumber, zone), 0);
+  }
 }
 
 /**********************************************************************/
@@ -359,10 +405,15 @@ void releaseJournalZoneReference(LockCounter *counter, BlockCount lockNumber)
 }
 
 /**********************************************************************/
-void releaseJournalZoneReferenceFromOtherZone(LockCounter *counter,
-                                              BlockCount   lockNumber)
+void releaseJournalZoneReferenceFromLogicalZone(LockCounter *counter,
+                                                BlockCount   lockNumber,
+                                                ZoneCount    zoneID)
 {
-  atomicAdd32(&(counter->journalDecrementCounts[lockNumber]), 1);
+  // Only this zone writes its count, so no locked update is needed. The store
+  // fence orders the release after any reference this zone acquired in
+  // exchange for it.
+  Atomic32 *decrementCount = getDecrementCount(counter, lockNumber, zoneID);
+  atomicStore32(decrementCount, relaxedLoad32(decrementCount) + 1);
 }
 
 /**********************************************************************/
@@ -139,15 +139,18 @@ void releaseLockCountReference(LockCounter *counter,
 void releaseJournalZoneReference(LockCounter *counter, BlockCount lockNumber);
 
 /**
- * Release a single journal zone reference from any zone. This method shouldn't
- * be called from the journal zone as it would be inefficient; use
- * releaseJournalZoneReference() instead.
+ * Release a single journal zone reference from a logical zone. This method
+ * must be called from the thread of the specified logical zone. The release
+ * is accumulated in a count private to that zone, which the journal zone
+ * collects when it next checks the lock.
  *
  * @param counter     The counter from which to release a reference
  * @param lockNumber  The lock from which to release a reference
+ * @param zoneID      The ID of the logical zone releasing the reference
  **/
-void releaseJournalZoneReferenceFromOtherZone(LockCounter *counter,
-                                              BlockCount   lockNumber);
+void releaseJournalZoneReferenceFromLogicalZone(LockCounter *counter,
+                                                BlockCount   lockNumber,
+                                                ZoneCount    zoneID);
 
 /**
  * Inform a lock counter that an unlock notification was received by the
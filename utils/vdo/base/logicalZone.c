@@ -34,6 +34,7 @@
 #include "dataVIO.h"
 #include "flush.h"
 #include "intMap.h"
+#include "streamDetector.h"
 #include "vdoInternal.h"
 
 struct logicalZone {
@@ -55,6 +56,8 @@ struct logicalZone {
   SequenceNumber      oldestActiveGeneration;
   /** The number of IOs in the current flush generation */
   BlockCount          iosInFlushGeneration;
+  /** The number of queued writes superseded by newer writes */
+  uint64_t            supersededWrites;
   /**
    * The oldest locked generation in this zone (an atomic copy of
    *                  oldestActiveGeneration)
@@ -70,6 +73,8 @@ struct logicalZone {
   AdminState          state;
   /** The selector for determining which physical zone to allocate from */
   AllocationSelector *selector;
+  /** The classifier of the writes to this zone */
+  StreamDetector     *streamDetector;
 };
 
 struct logicalZones {
@@ -141,6 +146,11 @@ static int initializeZone(LogicalZones *zones, ZoneCount zoneNumber)
   initializeRing(&zone->writeVIOs);
   atomicStore64(&zone->oldestLockedGeneration, 0);
 
+  result = makeStreamDetector(&zone->streamDetector);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
   return makeAllocationSelector(getThreadConfig(vdo)->physicalZoneCount,
                                 zone->threadID, &zone->selector);
 }
@@ -195,6 +205,7 @@ void freeLogicalZones(LogicalZones **zonesPtr)
   for (ZoneCount index = 0; index < zones->zoneCount; index++) {
     LogicalZone *zone = &zones->zones[index];
     freeAllocationSelector(&zone->selector);
+    freeStreamDetector(&zone->streamDetector);
     destroyEnqueueable(&zone->completion);
     freeIntMap(&zone->lbnOperations);
   }
@@ -443,21 +454,35 @@ void releaseFlushGenerationLock(DataVIO *dataVIO)
   attemptGenerationCompleteNotification(&zone->completion);
 }
 
+/**********************************************************************/
+void countSupersededWrite(LogicalZone *zone)
+{
+  assertOnZoneThread(zone, __func__);
+  zone->supersededWrites++;
+}
+
 /**********************************************************************/
 AllocationSelector *getAllocationSelector(LogicalZone *zone)
 {
   return zone->selector;
 }
 
+/**********************************************************************/
+StreamDetector *getStreamDetector(const LogicalZone *zone)
+{
+  return zone->streamDetector;
+}
+
 /**********************************************************************/
 void dumpLogicalZone(const LogicalZone *zone)
 {
   logInfo("LogicalZone %u", zone->zoneNumber);
   logInfo("  flushGeneration=%" PRIu64 " oldestActiveGeneration=%" PRIu64
           " oldestLockedGeneration=%" PRIu64 " notificationGeneration=%" PRIu64
-          " notifying=%s iosInCurrentGeneration=%" PRIu64,
+          " notifying=%s iosInCurrentGeneration=%" PRIu64
+          " supersededWrites=%" PRIu64,
           zone->flushGeneration, zone->oldestActiveGeneration,
           relaxedLoad64(&zone->oldestLockedGeneration),
           zone->notificationGeneration, boolToString(zone->notifying),
-          zone->iosInFlushGeneration);
+          zone->iosInFlushGeneration, zone->supersededWrites);
 }
@@ -167,6 +167,24 @@ void releaseFlushGenerationLock(DataVIO *dataVIO);
 AllocationSelector *getAllocationSelector(LogicalZone *zone)
   __attribute__((warn_unused_result));
 
+/**
+ * Record that a queued write in a logical zone was superseded by a newer
+ * write to the same LBN.
+ *
+ * @param zone  The zone of the superseded write
+ **/
+void countSupersededWrite(LogicalZone *zone);
+
+/**
+ * Get the stream detector which classifies the writes to a logical zone.
+ *
+ * @param zone  The zone
+ *
+ * @return The zone's stream detector
+ **/
+StreamDetector *getStreamDetector(const LogicalZone *zone)
+  __attribute__((warn_unused_result));
+
 /**
  * Dump information about a logical zone to the log for debugging, in a
  * thread-unsafe fashion.
@@ -23,6 +23,7 @@
 
 #include "logger.h"
 #include "memoryAlloc.h"
+#include "timeUtils.h"
 
 #include "adminState.h"
 #include "allocatingVIO.h"
@@ -31,6 +32,7 @@
 #include "dataVIO.h"
 #include "hashLock.h"
 #include "pbnLock.h"
+#include "streamDetector.h"
 #include "vdo.h"
 #include "vdoInternal.h"
 
@@ -217,6 +219,8 @@ static void freeOutputBin(OutputBin **binPtr)
 int makePacker(PhysicalLayer       *layer,
                BlockCount           inputBinCount,
                BlockCount           outputBinCount,
+               uint32_t             maxResidency,
+               bool                 packRuns,
                const ThreadConfig  *threadConfig,
                Packer             **packerPtr)
 {
@@ -232,9 +236,21 @@ int makePacker(PhysicalLayer       *layer,
   packer->size           = inputBinCount;
   packer->maxSlots       = MAX_COMPRESSION_SLOTS;
   packer->outputBinCount = outputBinCount;
+  packer->packRuns       = packRuns;
+  if (layer->enqueueDelayed != NULL) {
+    // Without a timer, fragments wait for a full bin or a flush as before.
+    packer->maxResidency = ((uint64_t) maxResidency) * 1000;
+  }
   initializeRing(&packer->inputBins);
   initializeRing(&packer->outputBins);
 
+  result = initializeEnqueueableCompletion(&packer->residencyCompletion,
+                                           PACKER_RESIDENCY_COMPLETION, layer);
+  if (result != VDO_SUCCESS) {
+    freePacker(&packer);
+    return result;
+  }
+
   result = makeAllocationSelector(threadConfig->physicalZoneCount,
                                   packer->threadID, &packer->selector);
   if (result != VDO_SUCCESS) {
@@ -296,6 +312,7 @@ void freePacker(Packer **packerPtr)
   }
 
   freeAllocationSelector(&packer->selector);
+  destroyEnqueueable(&packer->residencyCompletion);
   FREE(packer);
   *packerPtr = NULL;
 }
@@ -337,9 +354,49 @@ PackerStatistics getPackerStatistics(const Packer *packer)
     .compressedFragmentsWritten  = relaxedLoad64(&packer->fragmentsWritten),
     .compressedBlocksWritten     = relaxedLoad64(&packer->blocksWritten),
     .compressedFragmentsInPacker = relaxedLoad64(&packer->fragmentsPending),
+    .residencyUnder1ms           = relaxedLoad64(&packer->residencyUnder1ms),
+    .residencyUnder10ms          = relaxedLoad64(&packer->residencyUnder10ms),
+    .residencyUnder100ms         = relaxedLoad64(&packer->residencyUnder100ms),
+    .residencyUnder1s            = relaxedLoad64(&packer->residencyUnder1s),
+    .residencyOver1s             = relaxedLoad64(&packer->residencyOver1s),
+    .residencyTimeouts           = relaxedLoad64(&packer->residencyTimeouts),
+    .runFragmentsPacked          = relaxedLoad64(&packer->runFragmentsPacked),
   };
 }
 
+/**
+ * Record the time a DataVIO spent waiting in an input bin in the packer's
+ * residency histogram. A DataVIO which was never put in an input bin, or
+ * whose residency has already been recorded, is ignored.
+ *
+ * @param packer   The packer
+ * @param dataVIO  The DataVIO which is leaving the packer's input bins
+ **/
+static void recordResidency(Packer *packer, DataVIO *dataVIO)
+{
+  uint64_t arrivalTime = dataVIO->compression.arrivalTime;
+  if (arrivalTime == 0) {
+    return;
+  }
+
+  dataVIO->compression.arrivalTime = 0;
+  uint64_t residency = nowUsec() - arrivalTime;
+  Atomic64 *bucket;
+  if (residency < 1000) {
+    bucket = &packer->residencyUnder1ms;
+  } else if (residency < 10000) {
+    bucket = &packer->residencyUnder10ms;
+  } else if (residency < 100000) {
+    bucket = &packer->residencyUnder100ms;
+  } else if (residency < 1000000) {
+    bucket = &packer->residencyUnder1s;
+  } else {
+    bucket = &packer->residencyOver1s;
+  }
+
+  relaxedAdd64(bucket, 1);
+}
+
 /**
  * Abort packing a DataVIO.
  *
@@ -347,8 +404,10 @@ PackerStatistics getPackerStatistics(const Packer *packer)
  **/
 static void abortPacking(DataVIO *dataVIO)
 {
+  Packer *packer = getPackerFromDataVIO(dataVIO);
   setCompressionDone(dataVIO);
-  relaxedAdd64(&getPackerFromDataVIO(dataVIO)->fragmentsPending, -1);
+  recordResidency(packer, dataVIO);
+  relaxedAdd64(&packer->fragmentsPending, -1);
   dataVIOAddTraceRecord(dataVIO, THIS_LOCATION(NULL));
   continueDataVIO(dataVIO, VDO_SUCCESS);
 }
@@ -374,6 +433,7 @@ static void continueVIOWithoutPacking(Waiter *waiter,
 static void checkForDrainComplete(Packer *packer)
 {
   if (isDraining(&packer->state)
+      && !packer->residencyTimerArmed
       && (packer->canceledBin->slotsUsed == 0)
       && (packer->idleOutputBinCount == packer->outputBinCount)) {
     finishDraining(&packer->state);
@@ -626,6 +686,7 @@ static bool writeNextBatch(Packer *packer, OutputBin *output)
   size_t spaceUsed = 0;
   for (SlotNumber slot = 0; slot < batch.slotsUsed; slot++) {
     DataVIO *dataVIO = batch.slots[slot];
+    recordResidency(packer, dataVIO);
     dataVIO->compression.slot = slot;
     putCompressedBlockFragment(output->block, slot, spaceUsed,
                                dataVIO->compression.data,
@@ -762,6 +823,164 @@ static void writePendingBatches(Packer *packer)
   packer->writingBatches = false;
 }
 
+/**
+ * Get the arrival time of the oldest DataVIO in an input bin.
+ *
+ * @param bin  The bin, which must not be empty
+ *
+ * @return The arrival time, in microseconds, of the oldest DataVIO in the bin
+ **/
+static uint64_t getOldestArrival(const InputBin *bin)
+{
+  uint64_t oldest = bin->incoming[0]->compression.arrivalTime;
+  for (SlotNumber slot = 1; slot < bin->slotsUsed; slot++) {
+    uint64_t arrivalTime = bin->incoming[slot]->compression.arrivalTime;
+    if (arrivalTime < oldest) {
+      oldest = arrivalTime;
+    }
+  }
+
+  return oldest;
+}
+
+/**
+ * Start new batches in all input bins holding a DataVIO which has waited
+ * longer than the maximum residency, fullest bin first. The expired batches
+ * will be packed together where possible; a lone fragment will be written
+ * uncompressed.
+ *
+ * @param packer  The packer
+ * @param now     The current time, in microseconds
+ *
+ * @return The time, in microseconds, until the oldest DataVIO remaining in
+ *         an input bin will expire, or 0 if the input bins are empty
+ **/
+static uint64_t expireInputBins(Packer *packer, uint64_t now)
+{
+  uint64_t  remaining = 0;
+  InputBin *bin       = getFullestBin(packer);
+  while (bin != NULL) {
+    if (bin->slotsUsed == 0) {
+      bin = nextBin(packer, bin);
+      continue;
+    }
+
+    uint64_t deadline = getOldestArrival(bin) + packer->maxResidency;
+    if (deadline > now) {
+      if ((remaining == 0) || ((deadline - now) < remaining)) {
+        remaining = deadline - now;
+      }
+      bin = nextBin(packer, bin);
+      continue;
+    }
+
+    startNewBatch(packer, bin);
+    insertInSortedList(packer, bin);
+    relaxedAdd64(&packer->residencyTimeouts, 1);
+
+    // Re-sorting the emptied bin has moved it, so rescan from the start.
+    remaining = 0;
+    bin       = getFullestBin(packer);
+  }
+
+  writePendingBatches(packer);
+  return remaining;
+}
+
+/**********************************************************************/
+static void checkResidency(VDOCompletion *completion);
+
+/**
+ * Arm the residency timer if the packer has a maximum residency and the
+ * timer is not already pending. The maximum residency is only set if the
+ * layer supports delayed enqueueing.
+ *
+ * @param packer  The packer
+ * @param delay   The time, in microseconds, after which the timer should fire
+ **/
+static void armResidencyTimer(Packer *packer, uint64_t delay)
+{
+  VDOCompletion *completion = &packer->residencyCompletion;
+  if ((packer->maxResidency == 0) || packer->residencyTimerArmed) {
+    return;
+  }
+
+  packer->residencyTimerArmed = true;
+  setCallback(completion, checkResidency, packer->threadID);
+  completion->layer->enqueueDelayed(completion->enqueueable, delay);
+}
+
+/**
+ * Write out any input bins whose fragments have exceeded the maximum
+ * residency, and rearm the timer for the oldest remaining fragment. This
+ * callback is registered in armResidencyTimer().
+ *
+ * @param completion  The packer's residency completion
+ **/
+static void checkResidency(VDOCompletion *completion)
+{
+  Packer *packer = container_of(completion, Packer, residencyCompletion);
+  assertOnPackerThread(packer, __func__);
+  packer->residencyTimerArmed = false;
+  if (!isNormal(&packer->state)) {
+    // Draining writes out all the bins, so there is nothing to expire.
+    checkForDrainComplete(packer);
+    return;
+  }
+
+  uint64_t remaining = expireInputBins(packer, nowUsec());
+  if (remaining > 0) {
+    armResidencyTimer(packer, remaining);
+  }
+}
+
+/**
+ * Check whether the DataVIO most recently added to an input bin is for the
+ * logical block preceding that of another DataVIO.
+ *
+ * @param bin      The bin to check
+ * @param dataVIO  The DataVIO which may continue a run in the bin
+ *
+ * @return <code>true</code> if the DataVIO would extend a run in the bin
+ **/
+static bool continuesRun(const InputBin *bin, const DataVIO *dataVIO)
+{
+  if (bin->slotsUsed == 0) {
+    return false;
+  }
+
+  LogicalBlockNumber lbn = dataVIO->logical.lbn;
+  return ((lbn > 0)
+          && (bin->incoming[bin->slotsUsed - 1]->logical.lbn == (lbn - 1)));
+}
+
+/**
+ * Find the input bin, if any, which holds the preceding block of the
+ * sequential run being written by a DataVIO and has room for its fragment.
+ *
+ * @param packer   The packer
+ * @param dataVIO  The DataVIO
+ *
+ * @return The bin in which to continue the run, or NULL
+ **/
+static InputBin *selectRunBin(Packer *packer, DataVIO *dataVIO)
+{
+  if (!packer->packRuns || ((dataVIO->streamHints & STREAM_SEQUENTIAL) == 0)) {
+    return NULL;
+  }
+
+  for (InputBin *bin = getFullestBin(packer);
+       bin != NULL;
+       bin = nextBin(packer, bin)) {
+    if ((bin->freeSpace >= dataVIO->compression.size)
+        && continuesRun(bin, dataVIO)) {
+      return bin;
+    }
+  }
+
+  return NULL;
+}
+
 /**
  * Select the input bin that should be used to pack the compressed data in a
  * DataVIO with other DataVIOs.
@@ -841,15 +1060,30 @@ void attemptPacking(DataVIO *dataVIO)
    * that we will actually bin the DataVIO and not give up on it as being
    * larger than the space used in the fullest bin. Hence we must call
    * selectInputBin() before calling mayBlockInPacker() (VDO-2826).
+   *
+   * Keeping a sequential run together in one compressed block lets the block
+   * be freed at once when the run is overwritten or discarded, rather than
+   * being pinned by a fragment of unrelated data.
    */
-  InputBin *bin = selectInputBin(packer, dataVIO);
+  InputBin *bin           = selectRunBin(packer, dataVIO);
+  bool      continuingRun = (bin != NULL);
+  if (!continuingRun) {
+    bin = selectInputBin(packer, dataVIO);
+  }
+
   if ((bin == NULL) || !mayBlockInPacker(dataVIO)) {
     abortPacking(dataVIO);
     return;
   }
 
+  if (continuingRun) {
+    relaxedAdd64(&packer->runFragmentsPacked, 1);
+  }
+
+  dataVIO->compression.arrivalTime = nowUsec();
   addDataVIOToInputBin(packer, bin, dataVIO);
   writePendingBatches(packer);
+  armResidencyTimer(packer, packer->maxResidency);
 }
 
 /**
@@ -1001,9 +1235,11 @@ static void dumpOutputBin(const OutputBin *bin)
 void dumpPacker(const Packer *packer)
 {
   logInfo("Packer");
-  logInfo("  flushGeneration=%" PRIu64 " state %s writingBatches=%s",
+  logInfo("  flushGeneration=%" PRIu64 " state %s writingBatches=%s"
+          " maxResidency=%" PRIu64 " residencyTimerArmed=%s",
           packer->flushGeneration, getAdminStateName(&packer->state),
-          boolToString(packer->writingBatches));
+          boolToString(packer->writingBatches), packer->maxResidency,
+          boolToString(packer->residencyTimerArmed));
 
   logInfo("  inputBinCount=%" PRIu64, packer->size);
   for (InputBin *bin = getFullestBin(packer);
@@ -43,6 +43,14 @@ typedef struct packer Packer;
  * @param [in]  inputBinCount   The number of partial bins to keep in memory
  * @param [in]  outputBinCount  The number of compressed blocks that can be
  *                              written concurrently
+ * @param [in]  maxResidency    The maximum time, in milliseconds, a fragment
+ *                              may wait in an input bin (0 for no limit);
+ *                              ignored if the layer cannot enqueue delayed
+ *                              callbacks
+ * @param [in]  packRuns        Whether to pack each fragment of a sequential
+ *                              run with the preceding block of the run; each
+ *                              fragment is still compressed on its own, so
+ *                              this does not change the compression ratio
  * @param [in]  threadConfig    The thread configuration of the VDO
  * @param [out] packerPtr       A pointer to hold the new packer
  *
@@ -51,6 +59,8 @@ typedef struct packer Packer;
 int makePacker(PhysicalLayer       *layer,
                BlockCount           inputBinCount,
                BlockCount           outputBinCount,
+               uint32_t             maxResidency,
+               bool                 packRuns,
                const ThreadConfig  *threadConfig,
                Packer             **packerPtr)
   __attribute__((warn_unused_result));
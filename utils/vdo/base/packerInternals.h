@@ -85,6 +85,8 @@ typedef struct {
 } OutputBatch;
 
 struct packer {
+  /** The completion for enforcing the maximum residency of fragments */
+  VDOCompletion       residencyCompletion;
   /** The ID of the packer's callback thread */
   ThreadID            threadID;
   /** The selector for determining which physical zone to allocate from */
@@ -112,6 +114,12 @@ struct packer {
   AdminState          state;
   /** True when writing batched DataVIOs */
   bool                writingBatches;
+  /** The maximum time a fragment may wait in an input bin, in microseconds */
+  uint64_t            maxResidency;
+  /** True when the residency timer is pending */
+  bool                residencyTimerArmed;
+  /** Whether to pack fragments of sequential runs together */
+  bool                packRuns;
 
   // Atomic counters corresponding to the fields of PackerStatistics:
 
@@ -121,6 +129,16 @@ struct packer {
   Atomic64            blocksWritten;
   /** Number of DataVIOs that are pending in the packer */
   Atomic64            fragmentsPending;
+  /** Histogram of the time fragments spent waiting in input bins */
+  Atomic64            residencyUnder1ms;
+  Atomic64            residencyUnder10ms;
+  Atomic64            residencyUnder100ms;
+  Atomic64            residencyUnder1s;
+  Atomic64            residencyOver1s;
+  /** Number of bins written because the maximum residency was exceeded */
+  Atomic64            residencyTimeouts;
+  /** Number of fragments packed after the preceding block of their run */
+  Atomic64            runFragmentsPacked;
 
   /** Queue of batched DataVIOs waiting to be packed */
   WaitQueue           batchedDataVIOs;
@@ -23,6 +23,7 @@
 #define PHYSICAL_LAYER_H
 
 #include "types.h"
+#include "waitQueue.h"
 
 static const CRC32Checksum INITIAL_CHECKSUM = 0xffffffff;
 
@@ -170,6 +171,27 @@ typedef AsyncDataOperation DataVIOZeroer;
  **/
 typedef void DataCopier(DataVIO *source, DataVIO *destination);
 
+/**
+ * A function to copy the data a DataVIO is writing into a buffer. This and
+ * DataBufferComparator exist only for a layer which carries DataVIO data,
+ * such as the kernel layer, which is not part of this tree. No layer here
+ * provides them, so the recent write cache is never enabled in this tree.
+ *
+ * @param dataVIO  The DataVIO whose data is to be copied
+ * @param buffer   The block-sized buffer to copy the data to
+ **/
+typedef void DataExporter(DataVIO *dataVIO, char *buffer);
+
+/**
+ * A function to compare the data a DataVIO is writing to a buffer.
+ *
+ * @param dataVIO  The DataVIO whose data is to be compared
+ * @param buffer   The block-sized buffer to compare against
+ *
+ * @return <code>true</code> if the data and the buffer contents are the same
+ **/
+typedef bool DataBufferComparator(DataVIO *dataVIO, const char *buffer);
+
 /**
  * A function to apply a partial write to a DataVIO which has completed the
  * read portion of a read-modify-write operation.
@@ -276,6 +298,17 @@ typedef AsyncDataOperation DataCompressor;
  **/
 typedef AsyncDataOperation AlbireoUpdater;
 
+/**
+ * A function to submit a batch of dedupe index requests at once. The layer
+ * must remove every DataVIO from the queue before returning, and will
+ * continue each of them as the equivalent single-request operation would.
+ * The batched operations are optional; a hash zone submits each request
+ * with the single-request operation when its batched form is NULL.
+ *
+ * @param batch  A queue of DataVIOs, as waiters
+ **/
+typedef void BatchedDataOperation(WaitQueue *batch);
+
 /**
  * A function to finish flush requests
  *
@@ -318,6 +351,15 @@ typedef void EnqueueableDestructor(Enqueueable **enqueueablePtr);
  **/
 typedef void Enqueuer(Enqueueable *enqueueable);
 
+/**
+ * A function to enqueue the Enqueueable object to run on the thread specified
+ * by its associated completion once a delay has elapsed.
+ *
+ * @param enqueueable  The object to be enqueued
+ * @param delay        The minimum delay before running, in microseconds
+ **/
+typedef void DelayedEnqueuer(Enqueueable *enqueueable, uint64_t delay);
+
 /**
  * A function to wait for an admin operation to complete. This function should
  * not be called from a base-code thread.
@@ -340,6 +382,16 @@ typedef void OperationComplete(PhysicalLayer *layer);
  **/
 typedef ThreadID ThreadIDGetter(void);
 
+/**
+ * A function to get the counter of nested callback invocations on the current
+ * thread. The counter belongs to the thread and is only modified by the base
+ * code running on it.
+ *
+ * @return A pointer to the current thread's counter, or NULL if the current
+ *         thread does not keep one
+ **/
+typedef uint8_t *CallbackDepthGetter(void);
+
 /**
  * A function to return the physical layer pointer for the current thread.
  *
@@ -371,6 +423,8 @@ struct physicalLayer {
   VIODestructor             *freeVIO;
   DataVIOZeroer             *zeroDataVIO;
   DataCopier                *copyData;
+  DataExporter              *exportData;
+  DataBufferComparator      *compareDataToBuffer;
   DataModifier              *applyPartialWrite;
 
   // Asynchronous interface (vio-based)
@@ -387,17 +441,21 @@ struct physicalLayer {
   DataVIOComparator         *compareDataVIOs;
   DataCompressor            *compressDataVIO;
   AlbireoUpdater            *updateAlbireo;
+  BatchedDataOperation      *checkForDuplicationBatch;
+  BatchedDataOperation      *updateAlbireoBatch;
 
   // Asynchronous interface (other)
   FlushComplete             *completeFlush;
   EnqueueableCreator        *createEnqueueable;
   EnqueueableDestructor     *destroyEnqueueable;
   Enqueuer                  *enqueue;
+  DelayedEnqueuer           *enqueueDelayed;
   OperationWaiter           *waitForAdminOperation;
   OperationComplete         *completeAdminOperation;
 
   // Thread specific interface
   ThreadIDGetter            *getCurrentThreadID;
+  CallbackDepthGetter       *getCallbackDepth;
 };
 
 /**
@@ -21,6 +21,7 @@
 
 #include "physicalZone.h"
 
+#include "logger.h"
 #include "memoryAlloc.h"
 
 #include "blockAllocator.h"
@@ -33,6 +34,7 @@
 #include "intMap.h"
 #include "pbnLock.h"
 #include "pbnLockPool.h"
+#include "recentWriteCache.h"
 #include "slabDepot.h"
 #include "vdoInternal.h"
 
@@ -44,15 +46,17 @@ enum {
 
 struct physicalZone {
   /** Which physical zone this is */
-  ZoneCount       zoneNumber;
+  ZoneCount         zoneNumber;
   /** The thread ID for this zone */
-  ThreadID        threadID;
+  ThreadID          threadID;
   /** In progress operations keyed by PBN */
-  IntMap         *pbnOperations;
+  IntMap           *pbnOperations;
   /** Pool of unused PBNLock instances */
-  PBNLockPool    *lockPool;
+  PBNLockPool      *lockPool;
   /** The block allocator for this zone */
-  BlockAllocator *allocator;
+  BlockAllocator   *allocator;
+  /** The data of recently written blocks, or NULL if not caching */
+  RecentWriteCache *recentWrites;
 };
 
 /**********************************************************************/
@@ -76,6 +80,26 @@ int makePhysicalZone(VDO *vdo, ZoneCount zoneNumber, PhysicalZone **zonePtr)
     return result;
   }
 
+  // Cached data can only be used if the layer can copy and compare it.
+  const PhysicalLayer *layer = vdo->layer;
+  BlockCount cacheBlocks = vdo->loadConfig.recentWriteCacheBlocks;
+  if ((cacheBlocks > 0)
+      && ((layer->exportData == NULL) || (layer->compareDataToBuffer == NULL))) {
+    if (zoneNumber == 0) {
+      logInfo("Recent write cache of %" PRIu64 " blocks disabled: the layer"
+              " cannot compare cached data", cacheBlocks);
+    }
+    cacheBlocks = 0;
+  }
+
+  if (cacheBlocks > 0) {
+    result = makeRecentWriteCache(cacheBlocks, &zone->recentWrites);
+    if (result != VDO_SUCCESS) {
+      freePhysicalZone(&zone);
+      return result;
+    }
+  }
+
   zone->zoneNumber = zoneNumber;
   zone->threadID   = getPhysicalZoneThread(getThreadConfig(vdo), zoneNumber);
   zone->allocator  = getBlockAllocatorForZone(vdo->depot, zoneNumber);
@@ -92,6 +116,7 @@ void freePhysicalZone(PhysicalZone **zonePtr)
   }
 
   PhysicalZone *zone = *zonePtr;
+  freeRecentWriteCache(&zone->recentWrites);
   freePBNLockPool(&zone->lockPool);
   freeIntMap(&zone->pbnOperations);
   FREE(zone);
@@ -145,6 +170,14 @@ int attemptPBNLock(PhysicalZone         *zone,
     return result;
   }
 
+  if ((type != VIO_READ_LOCK) && (zone->recentWrites != NULL)) {
+    // Every rewrite of a block, whether of data, of a packed compressed
+    // block, or of a block map page, is done under a write lock on a block
+    // which has been allocated, so the cached data of the block is about to
+    // become (or already is) stale.
+    forgetRecentWrite(zone->recentWrites, pbn);
+  }
+
   if (lock != NULL) {
     // The lock is already held, so we don't need the borrowed lock.
     returnPBNLockToPool(zone->lockPool, &newLock);
@@ -191,6 +224,37 @@ void releasePBNLock(PhysicalZone         *zone,
   returnPBNLockToPool(zone->lockPool, &lock);
 }
 
+/**********************************************************************/
+void cacheRecentWrite(PhysicalZone *zone, DataVIO *dataVIO)
+{
+  if (zone->recentWrites == NULL) {
+    return;
+  }
+
+  char *buffer = getRecentWriteBuffer(zone->recentWrites,
+                                      dataVIO->newMapped.pbn);
+  if (buffer != NULL) {
+    dataVIOAsCompletion(dataVIO)->layer->exportData(dataVIO, buffer);
+  }
+}
+
+/**********************************************************************/
+bool matchesRecentWrite(PhysicalZone *zone, DataVIO *dataVIO)
+{
+  if ((zone->recentWrites == NULL)
+      || isCompressed(dataVIO->duplicate.state)) {
+    return false;
+  }
+
+  const char *data = getRecentWrite(zone->recentWrites, dataVIO->duplicate.pbn);
+  if (data == NULL) {
+    return false;
+  }
+
+  return dataVIOAsCompletion(dataVIO)->layer->compareDataToBuffer(dataVIO,
+                                                                  data);
+}
+
 /**********************************************************************/
 void dumpPhysicalZone(const PhysicalZone *zone)
 {
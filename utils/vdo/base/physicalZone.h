@@ -120,6 +120,30 @@ void releasePBNLock(PhysicalZone         *zone,
                     PhysicalBlockNumber   lockedPBN,
                     PBNLock             **lockPtr);
 
+/**
+ * Cache the data a DataVIO has just written to its newly allocated block so
+ * that dedupe advice for the block can be verified without reading it back.
+ * Must be called on the zone's thread.
+ *
+ * @param zone     The physical zone which allocated the block
+ * @param dataVIO  The DataVIO whose write has completed
+ **/
+void cacheRecentWrite(PhysicalZone *zone, DataVIO *dataVIO);
+
+/**
+ * Check whether a DataVIO's data matches the cached data of its duplicate
+ * candidate, if the candidate was written recently enough to still be cached.
+ * Must be called on the zone's thread while the DataVIO holds a read lock on
+ * the candidate.
+ *
+ * @param zone     The physical zone of the duplicate candidate
+ * @param dataVIO  The DataVIO verifying its advice
+ *
+ * @return <code>true</code> if the candidate is cached and its data matches
+ **/
+bool matchesRecentWrite(PhysicalZone *zone, DataVIO *dataVIO)
+  __attribute__((warn_unused_result));
+
 /**
  * Dump information about a physical zone to the log for debugging.
  *
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2020 Red Hat, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA. 
+ *
+ * $Id: //eng/vdo-releases/aluminum/src/c++/vdo/base/recentWriteCache.c#1 $
+ */
+
+#include "recentWriteCache.h"
+
+#include "memoryAlloc.h"
+
+#include "constants.h"
+#include "intMap.h"
+#include "ringNode.h"
+
+/**
+ * A block in the cache.
+ **/
+typedef struct {
+  /** The node in the LRU ring or the ring of free entries */
+  RingNode            ringNode;
+  /** The block whose data is cached */
+  PhysicalBlockNumber pbn;
+  /** The cached data */
+  char               *data;
+} RecentWrite;
+
+struct recentWriteCache {
+  /** The number of blocks the cache can hold */
+  BlockCount   capacity;
+  /** The cached blocks, keyed by PBN */
+  IntMap      *blockMap;
+  /** The cached blocks, least recently used first */
+  RingNode     lruRing;
+  /** The entries which hold no block */
+  RingNode     freeRing;
+  /** The data buffers of all the entries */
+  char        *buffers;
+  /** The entries */
+  RecentWrite  entries[];
+};
+
+/**********************************************************************/
+int makeRecentWriteCache(BlockCount capacity, RecentWriteCache **cachePtr)
+{
+  RecentWriteCache *cache;
+  int result = ALLOCATE_EXTENDED(RecentWriteCache, capacity, RecentWrite,
+                                 __func__, &cache);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  cache->capacity = capacity;
+  initializeRing(&cache->lruRing);
+  initializeRing(&cache->freeRing);
+
+  result = makeIntMap(capacity, 0, &cache->blockMap);
+  if (result != VDO_SUCCESS) {
+    freeRecentWriteCache(&cache);
+    return result;
+  }
+
+  result = ALLOCATE(capacity * VDO_BLOCK_SIZE, char, "recent write data",
+                    &cache->buffers);
+  if (result != VDO_SUCCESS) {
+    freeRecentWriteCache(&cache);
+    return result;
+  }
+
+  BlockCount i;
+  for (i = 0; i < capacity; i++) {
+    RecentWrite *entry = &cache->entries[i];
+    entry->data = &cache->buffers[i * VDO_BLOCK_SIZE];
+    initializeRing(&entry->ringNode);
+    pushRingNode(&cache->freeRing, &entry->ringNode);
+  }
+
+  *cachePtr = cache;
+  return VDO_SUCCESS;
+}
+
+/**********************************************************************/
+void freeRecentWriteCache(RecentWriteCache **cachePtr)
+{
+  RecentWriteCache *cache = *cachePtr;
+  if (cache == NULL) {
+    return;
+  }
+
+  FREE(cache->buffers);
+  freeIntMap(&cache->blockMap);
+  FREE(cache);
+  *cachePtr = NULL;
+}
+
+/**
+ * Convert a RingNode to the RecentWrite containing it.
+ *
+ * @param ringNode  The node to convert
+ *
+ * @return The entry containing the node
+ **/
+static inline RecentWrite *asRecentWrite(RingNode *ringNode)
+{
+  STATIC_ASSERT(offsetof(RecentWrite, ringNode) == 0);
+  return (RecentWrite *) ringNode;
+}
+
+/**********************************************************************/
+char *getRecentWriteBuffer(RecentWriteCache *cache, PhysicalBlockNumber pbn)
+{
+  RecentWrite *entry = intMapGet(cache->blockMap, pbn);
+  if (entry != NULL) {
+    // Rewriting a cached block just replaces its data.
+    unspliceRingNode(&entry->ringNode);
+    pushRingNode(&cache->lruRing, &entry->ringNode);
+    return entry->data;
+  }
+
+  RingNode *node = chopRingNode(&cache->freeRing);
+  if (node == NULL) {
+    node = chopRingNode(&cache->lruRing);
+    if (node == NULL) {
+      return NULL;
+    }
+    intMapRemove(cache->blockMap, asRecentWrite(node)->pbn);
+  }
+
+  entry = asRecentWrite(node);
+  if (intMapPut(cache->blockMap, pbn, entry, true, NULL) != VDO_SUCCESS) {
+    pushRingNode(&cache->freeRing, &entry->ringNode);
+    return NULL;
+  }
+
+  entry->pbn = pbn;
+  pushRingNode(&cache->lruRing, &entry->ringNode);
+  return entry->data;
+}
+
+/**********************************************************************/
+const char *getRecentWrite(RecentWriteCache *cache, PhysicalBlockNumber pbn)
+{
+  RecentWrite *entry = intMapGet(cache->blockMap, pbn);
+  if (entry == NULL) {
+    return NULL;
+  }
+
+  unspliceRingNode(&entry->ringNode);
+  pushRingNode(&cache->lruRing, &entry->ringNode);
+  return entry->data;
+}
+
+/**********************************************************************/
+void forgetRecentWrite(RecentWriteCache *cache, PhysicalBlockNumber pbn)
+{
+  RecentWrite *entry = intMapRemove(cache->blockMap, pbn);
+  if (entry == NULL) {
+    return;
+  }
+
+  unspliceRingNode(&entry->ringNode);
+  pushRingNode(&cache->freeRing, &entry->ringNode);
+}
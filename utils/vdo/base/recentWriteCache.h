@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020 Red Hat, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA. 
+ *
+ * $Id: //eng/vdo-releases/aluminum/src/c++/vdo/base/recentWriteCache.h#1 $
+ */
+
+#ifndef RECENT_WRITE_CACHE_H
+#define RECENT_WRITE_CACHE_H
+
+#include "types.h"
+
+/**
+ * A RecentWriteCache holds copies of the data most recently written to
+ * uncompressed data blocks, keyed by physical block number, so that dedupe
+ * advice for a block which was written moments ago can be verified without
+ * reading the block back. The cache has a fixed number of blocks, and
+ * replaces the least recently used block when it is full.
+ *
+ * A cache is not thread-safe; each physical zone has its own cache for the
+ * blocks it owns, which is only used from the zone's thread.
+ **/
+typedef struct recentWriteCache RecentWriteCache;
+
+/**
+ * Create a recent write cache.
+ *
+ * @param [in]  capacity  The number of blocks the cache can hold
+ * @param [out] cachePtr  A pointer to hold the new cache
+ *
+ * @return VDO_SUCCESS or an error code
+ **/
+int makeRecentWriteCache(BlockCount capacity, RecentWriteCache **cachePtr)
+  __attribute__((warn_unused_result));
+
+/**
+ * Free a recent write cache and null out the reference to it.
+ *
+ * @param cachePtr  A pointer to the cache to free
+ **/
+void freeRecentWriteCache(RecentWriteCache **cachePtr);
+
+/**
+ * Get the buffer in which to store the data just written to a block, making
+ * the block the most recently used one in the cache.
+ *
+ * @param cache  The cache
+ * @param pbn    The block which was written
+ *
+ * @return The buffer for the block's data, or NULL if the block can not be
+ *         cached
+ **/
+char *getRecentWriteBuffer(RecentWriteCache *cache, PhysicalBlockNumber pbn)
+  __attribute__((warn_unused_result));
+
+/**
+ * Look up the cached data of a block, making the block the most recently used
+ * one in the cache.
+ *
+ * @param cache  The cache
+ * @param pbn    The block to look up
+ *
+ * @return The data of the block, or NULL if it is not cached
+ **/
+const char *getRecentWrite(RecentWriteCache *cache, PhysicalBlockNumber pbn)
+  __attribute__((warn_unused_result));
+
+/**
+ * Drop a block from the cache because its contents are about to change.
+ *
+ * @param cache  The cache
+ * @param pbn    The block to drop
+ **/
+void forgetRecentWrite(RecentWriteCache *cache, PhysicalBlockNumber pbn);
+
+#endif // RECENT_WRITE_CACHE_H
@@ -563,7 +563,24 @@ void initializeRecoveryJournalPostRebuild(RecoveryJournal *journal,
 /**********************************************************************/
 BlockCount getJournalBlockMapDataBlocksUsed(RecoveryJournal *journal)
 {
-  return journal->blockMapDataBlocks;
+  return (journal->blockMapDataBlocks
+          - getJournalBlockMapTierPagesUsed(journal));
+}
+
+/**********************************************************************/
+BlockCount getJournalBlockMapTierPagesUsed(RecoveryJournal *journal)
+{
+  return minBlockCount(journal->blockMapDataBlocks,
+                       journal->blockMapTierSize);
+}
+
+/**********************************************************************/
+void setRecoveryJournalBlockMapTier(RecoveryJournal     *journal,
+                                    PhysicalBlockNumber  origin,
+                                    BlockCount           size)
+{
+  journal->blockMapTierOrigin = origin;
+  journal->blockMapTierSize   = size;
 }
 
 /**********************************************************************/
@@ -890,6 +907,16 @@ static void assignEntry(Waiter *waiter, void *context)
     break;
 
   case BLOCK_MAP_INCREMENT:
+    if (dataVIO->operation.pbn == ZERO_BLOCK) {
+      // This is a tier allocation; the next unused tier page is ours.
+      ASSERT_LOG_ONLY(((journal->pendingTierPages > 0)
+                       && (journal->blockMapDataBlocks
+                           < journal->blockMapTierSize)),
+                      "block map tier page was reserved");
+      journal->pendingTierPages--;
+      dataVIO->operation.pbn = (journal->blockMapTierOrigin
+                                + journal->blockMapDataBlocks);
+    }
     journal->blockMapDataBlocks++;
     break;
 
@@ -1203,6 +1230,27 @@ void addRecoveryJournalEntry(RecoveryJournal *journal, DataVIO *dataVIO)
   assignEntries(journal);
 }
 
+/**********************************************************************/
+bool addBlockMapTierEntry(RecoveryJournal *journal, DataVIO *dataVIO)
+{
+  assertOnJournalThread(journal, __func__);
+  if ((journal->blockMapDataBlocks + journal->pendingTierPages)
+      >= journal->blockMapTierSize) {
+    return false;
+  }
+
+  // A zero PBN marks the entry as needing a tier page when it is assigned.
+  setUpReferenceOperationWithLock(BLOCK_MAP_INCREMENT, ZERO_BLOCK,
+                                  MAPPING_STATE_UNCOMPRESSED, NULL,
+                                  &dataVIO->operation);
+  if (isNormal(&journal->state) && !isReadOnly(journal->readOnlyNotifier)) {
+    journal->pendingTierPages++;
+  }
+
+  addRecoveryJournalEntry(journal, dataVIO);
+  return true;
+}
+
 /**
  * Conduct a sweep on a recovery journal to reclaim unreferenced blocks.
  *
@@ -1303,7 +1351,8 @@ void releaseRecoveryJournalBlockReference(RecoveryJournal *journal,
 
 /**********************************************************************/
 void releasePerEntryLockFromOtherZone(RecoveryJournal *journal,
-                                      SequenceNumber   sequenceNumber)
+                                      SequenceNumber   sequenceNumber,
+                                      ZoneCount        zoneID)
 {
   if (sequenceNumber == 0) {
     return;
@@ -1311,7 +1360,8 @@ void releasePerEntryLockFromOtherZone(RecoveryJournal *journal,
 
   BlockCount blockNumber
     = getRecoveryJournalBlockNumber(journal, sequenceNumber);
-  releaseJournalZoneReferenceFromOtherZone(journal->lockCounter, blockNumber);
+  releaseJournalZoneReferenceFromLogicalZone(journal->lockCounter, blockNumber,
+                                             zoneID);
 }
 
 /**
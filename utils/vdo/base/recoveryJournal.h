@@ -217,6 +217,31 @@ void initializeRecoveryJournalPostRebuild(RecoveryJournal *journal,
 BlockCount getJournalBlockMapDataBlocksUsed(RecoveryJournal *journal)
   __attribute__((warn_unused_result));
 
+/**
+ * Get the number of block map pages, allocated from the block map tier,
+ * currently in use.
+ *
+ * @param journal   The journal in question
+ *
+ * @return  The number of block map pages allocated from the tier
+ **/
+BlockCount getJournalBlockMapTierPagesUsed(RecoveryJournal *journal)
+  __attribute__((warn_unused_result));
+
+/**
+ * Tell a recovery journal where the block map tier is. Tier pages are
+ * handed out in journal order, so the first <code>size</code> block map
+ * increments ever journaled are exactly the tier pages in use, and the count
+ * of block map data blocks serves as the tier's allocation high-water mark.
+ *
+ * @param journal  The journal
+ * @param origin   The first PBN of the tier
+ * @param size     The number of blocks in the tier
+ **/
+void setRecoveryJournalBlockMapTier(RecoveryJournal     *journal,
+                                    PhysicalBlockNumber  origin,
+                                    BlockCount           size);
+
 /**
  * Set the number of block map pages, allocated from data blocks, currently
  * in use.
@@ -322,6 +347,22 @@ int decodeSodiumRecoveryJournal(RecoveryJournal *journal, Buffer *buffer)
  **/
 void addRecoveryJournalEntry(RecoveryJournal *journal, DataVIO *dataVIO);
 
+/**
+ * Allocate a block map tree page from the block map tier and add the entry
+ * recording the allocation to a recovery journal. The page is not chosen
+ * until the entry is assigned a place in the journal, at which point its PBN
+ * is stored in the operation of the DataVIO. This method must be called from
+ * the journal zone thread.
+ *
+ * @param journal  The journal in which to make the entry
+ * @param dataVIO  The DataVIO allocating a tree page
+ *
+ * @return <code>false</code> if the tier is full, in which case no entry has
+ *         been made and the DataVIO has not been continued
+ **/
+bool addBlockMapTierEntry(RecoveryJournal *journal, DataVIO *dataVIO)
+  __attribute__((warn_unused_result));
+
 /**
  * Acquire a reference to a recovery journal block from somewhere other than
  * the journal itself.
@@ -353,15 +394,16 @@ void releaseRecoveryJournalBlockReference(RecoveryJournal *journal,
                                           ZoneCount        zoneID);
 
 /**
- * Release a single per-entry reference count for a recovery journal block. This
- * method may be called from any zone (but shouldn't be called from the journal
- * zone as it would be inefficient).
+ * Release a single per-entry reference count for a recovery journal block.
+ * This method must be called from the thread of the specified logical zone.
  *
  * @param journal         The recovery journal
  * @param sequenceNumber  The journal sequence number of the referenced block
+ * @param zoneID          The ID of the logical zone releasing the reference
  **/
 void releasePerEntryLockFromOtherZone(RecoveryJournal *journal,
-                                      SequenceNumber   sequenceNumber);
+                                      SequenceNumber   sequenceNumber,
+                                      ZoneCount        zoneID);
 
 /**
  * Drain recovery journal I/O. All uncommitted entries will be written out.
@@ -108,6 +108,12 @@ struct recoveryJournal {
   BlockCount                 logicalBlocksUsed;
   /** The number of block map pages that are allocated */
   BlockCount                 blockMapDataBlocks;
+  /** The first PBN of the block map tier */
+  PhysicalBlockNumber        blockMapTierOrigin;
+  /** The number of blocks in the block map tier */
+  BlockCount                 blockMapTierSize;
+  /** The number of tier page allocations awaiting their journal entries */
+  BlockCount                 pendingTierPages;
   /** The number of journal blocks written but not yet acknowledged */
   BlockCount                 pendingWriteCount;
   /** The threshold at which slab journal tail blocks will be written out */
@@ -24,6 +24,7 @@
 #include "logger.h"
 #include "memoryAlloc.h"
 
+#include "blockMap.h"
 #include "completion.h"
 #include "extent.h"
 #include "packedRecoveryJournalBlock.h"
@@ -148,7 +149,9 @@ int validateRecoveryJournalEntry(const VDO                  *vdo,
   if ((entry->slot.pbn >= vdo->config.physicalBlocks)
       || (entry->slot.slot >= BLOCK_MAP_ENTRIES_PER_PAGE)
       || !isValidLocation(&entry->mapping)
-      || !isPhysicalDataBlock(vdo->depot, entry->mapping.pbn)) {
+      || !(isPhysicalDataBlock(vdo->depot, entry->mapping.pbn)
+           || ((entry->operation == BLOCK_MAP_INCREMENT)
+               && isBlockMapTierBlock(vdo->blockMap, entry->mapping.pbn)))) {
     return logErrorWithStringError(VDO_CORRUPT_JOURNAL, "Invalid entry:"
                                    " (%" PRIu64 ", %" PRIu16 ") to %" PRIu64
                                    " (%s) is not within bounds",
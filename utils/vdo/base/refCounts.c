@@ -677,6 +677,49 @@ int adjustReferenceCount(RefCounts          *refCounts,
   return VDO_SUCCESS;
 }
 
+/**********************************************************************/
+bool cancelReferenceCountAdjustments(RefCounts          *refCounts,
+                                     ReferenceOperation  first,
+                                     ReferenceOperation  second)
+{
+  if ((first.pbn != second.pbn)
+      || !isSlabOpen(refCounts->slab)
+      || isUnrecoveredSlab(refCounts->slab)) {
+    return false;
+  }
+
+  ReferenceOperation increment;
+  if ((first.type == DATA_INCREMENT) && (second.type == DATA_DECREMENT)) {
+    increment = first;
+  } else if ((first.type == DATA_DECREMENT)
+             && (second.type == DATA_INCREMENT)) {
+    increment = second;
+  } else {
+    return false;
+  }
+
+  SlabBlockNumber slabBlockNumber;
+  int result = slabBlockNumberFromPBN(refCounts->slab, first.pbn,
+                                      &slabBlockNumber);
+  if (result != VDO_SUCCESS) {
+    return false;
+  }
+
+  ReferenceCount count = refCounts->counters[slabBlockNumber];
+  if ((referenceCountToStatus(count) != RS_SHARED)
+      || (count >= (MAXIMUM_REFERENCE_COUNT - 1))) {
+    return false;
+  }
+
+  // The increment would have released any provisional reference.
+  PBNLock *lock = getReferenceOperationPBNLock(increment);
+  if (lock != NULL) {
+    unassignProvisionalReference(lock);
+  }
+
+  return true;
+}
+
 /**********************************************************************/
 int adjustReferenceCountForRebuild(RefCounts           *refCounts,
                                    PhysicalBlockNumber  pbn,
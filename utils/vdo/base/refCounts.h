@@ -110,6 +110,25 @@ int adjustReferenceCount(RefCounts          *refCounts,
                          bool               *freeStatusChanged)
   __attribute__((warn_unused_result));
 
+/**
+ * Apply a data increment and a data decrement of the same block as a pair if
+ * they cancel out, so that neither needs a slab journal entry or dirties a
+ * reference block. They cancel when the block is shared and has room for one
+ * more reference, since in either order the pair then leaves the reference
+ * count and free status of the block unchanged. The caller must ensure that
+ * recovery will replay either both adjustments or neither of them.
+ *
+ * @param refCounts  The refcounts object
+ * @param first      The first of the two adjustments
+ * @param second     The second of the two adjustments
+ *
+ * @return <code>true</code> if the adjustments cancelled out
+ **/
+bool cancelReferenceCountAdjustments(RefCounts          *refCounts,
+                                     ReferenceOperation  first,
+                                     ReferenceOperation  second)
+  __attribute__((warn_unused_result));
+
 /**
  * Adjust the reference count of a block during rebuild.
  *
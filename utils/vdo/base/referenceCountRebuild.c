@@ -62,6 +62,8 @@ typedef struct {
   BlockCount        *logicalBlocksUsed;
   /** The number of block map data blocks */
   BlockCount        *blockMapDataBlocks;
+  /** The high-water mark of tree pages referenced in the block map tier */
+  BlockCount         tierPagesUsed;
   /** the next page to fetch */
   PageCount          pageToFetch;
   /** the number of leaf pages in the block map */
@@ -380,7 +382,8 @@ static void fetchPage(RebuildCompletion *rebuild, VDOCompletion *completion)
       continue;
     }
 
-    if (!isPhysicalDataBlock(rebuild->depot, pbn)) {
+    if (!isPhysicalDataBlock(rebuild->depot, pbn)
+        && !isBlockMapTierBlock(rebuild->blockMap, pbn)) {
       abortRebuild(rebuild, VDO_BAD_MAPPING);
       if (finishIfDone(rebuild)) {
         return;
@@ -411,6 +414,10 @@ static void rebuildFromLeaves(VDOCompletion *completion)
   RebuildCompletion *rebuild = asRebuildCompletion(completion->parent);
   *rebuild->logicalBlocksUsed = 0;
 
+  // Tier pages are handed out in order, so count every tier page up to the
+  // last one referenced as in use, even if some of them were lost in a crash.
+  *rebuild->blockMapDataBlocks += rebuild->tierPagesUsed;
+
   // The PBN calculation doesn't work until the tree pages have been loaded,
   // so we can't set this value at the start of rebuild.
   rebuild->lastSlot = (BlockMapSlot) {
@@ -440,6 +447,14 @@ static void rebuildFromLeaves(VDOCompletion *completion)
 static int processEntry(PhysicalBlockNumber pbn, VDOCompletion *completion)
 {
   RebuildCompletion *rebuild = asRebuildCompletion(completion->parent);
+  BlockMap          *map     = rebuild->blockMap;
+  if ((pbn != ZERO_BLOCK) && isBlockMapTierBlock(map, pbn)) {
+    // Tier pages have no reference counts.
+    rebuild->tierPagesUsed = maxBlockCount(rebuild->tierPagesUsed,
+                                           pbn - map->tierOrigin + 1);
+    return VDO_SUCCESS;
+  }
+
   if ((pbn == ZERO_BLOCK) || !isPhysicalDataBlock(rebuild->depot, pbn)) {
     return logErrorWithStringError(VDO_BAD_CONFIGURATION,
                                    "PBN %" PRIu64 " out of range",
@@ -724,6 +724,30 @@ BlockAllocator *getBlockAllocatorForZone(SlabDepot *depot,
   return depot->allocators[zoneNumber];
 }
 
+/**********************************************************************/
+void setSlabJournalBatching(SlabDepot *depot, bool batch)
+{
+  for (ZoneCount zone = 0; zone < depot->zoneCount; zone++) {
+    depot->allocators[zone]->batchSlabJournalEntries = batch;
+  }
+}
+
+/**********************************************************************/
+void setReferenceUpdateCoalescing(SlabDepot *depot, bool coalesce)
+{
+  for (ZoneCount zone = 0; zone < depot->zoneCount; zone++) {
+    depot->allocators[zone]->coalesceReferenceUpdates = coalesce;
+  }
+}
+
+/**********************************************************************/
+void setSlabDepotVIOPoolGrowth(SlabDepot *depot, unsigned int factor)
+{
+  for (ZoneCount zone = 0; zone < depot->zoneCount; zone++) {
+    setVIOPoolGrowthFactor(depot->allocators[zone]->vioPool, factor);
+  }
+}
+
 /**********************************************************************/
 int getSlabNumber(const SlabDepot     *depot,
                   PhysicalBlockNumber  pbn,
@@ -1091,9 +1115,12 @@ getDepotBlockAllocatorStatistics(const SlabDepot *depot)
   for (ZoneCount zone = 0; zone < depot->zoneCount; zone++) {
     BlockAllocator *allocator = depot->allocators[zone];
     BlockAllocatorStatistics stats = getBlockAllocatorStatistics(allocator);
-    totals.slabCount     += stats.slabCount;
-    totals.slabsOpened   += stats.slabsOpened;
-    totals.slabsReopened += stats.slabsReopened;
+    totals.slabCount      += stats.slabCount;
+    totals.slabsOpened    += stats.slabsOpened;
+    totals.slabsReopened  += stats.slabsReopened;
+    totals.vioPoolWaits   += stats.vioPoolWaits;
+    totals.vioPoolGrowths += stats.vioPoolGrowths;
+    totals.vioPoolSize    += stats.vioPoolSize;
   }
 
   return totals;
@@ -1128,6 +1155,16 @@ SlabJournalStatistics getDepotSlabJournalStatistics(const SlabDepot *depot)
     depotStats.blockedCount  += stats.blockedCount;
     depotStats.blocksWritten += stats.blocksWritten;
     depotStats.tailBusyCount += stats.tailBusyCount;
+    depotStats.committedBlocksUnder25Percent
+      += stats.committedBlocksUnder25Percent;
+    depotStats.committedBlocksUnder50Percent
+      += stats.committedBlocksUnder50Percent;
+    depotStats.committedBlocksUnder75Percent
+      += stats.committedBlocksUnder75Percent;
+    depotStats.committedBlocksUnder100Percent
+      += stats.committedBlocksUnder100Percent;
+    depotStats.committedFullBlocks += stats.committedFullBlocks;
+    depotStats.entriesCoalesced    += stats.entriesCoalesced;
   }
 
   return depotStats;
@@ -190,6 +190,36 @@ BlockAllocator *getBlockAllocatorForZone(SlabDepot *depot,
                                          ZoneCount  zoneNumber)
   __attribute__((warn_unused_result));
 
+/**
+ * Set whether the allocators of a depot add slab journal entries as they
+ * arrive, or gather them and add them once per pass of their zone threads.
+ * This must be set before the depot is in use.
+ *
+ * @param depot  The depot
+ * @param batch  Whether to batch slab journal entries
+ **/
+void setSlabJournalBatching(SlabDepot *depot, bool batch);
+
+/**
+ * Set whether the allocators of a depot skip the slab journal entries of
+ * adjacent reference count adjustments which cancel out. This must be set
+ * before the depot is in use.
+ *
+ * @param depot     The depot
+ * @param coalesce  Whether to coalesce reference count adjustments
+ **/
+void setReferenceUpdateCoalescing(SlabDepot *depot, bool coalesce);
+
+/**
+ * Set the multiple of its preallocated size to which the VIO pool of each
+ * allocator of a depot may grow while metadata I/O is backed up. This must be
+ * set before the depot is in use.
+ *
+ * @param depot   The depot
+ * @param factor  The growth factor (0 or 1 keep the pools at a fixed size)
+ **/
+void setSlabDepotVIOPoolGrowth(SlabDepot *depot, unsigned int factor);
+
 /**
  * Get the number of the slab that contains a specified block.
  *
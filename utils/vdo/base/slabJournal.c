@@ -73,6 +73,18 @@ SlabJournal *slabJournalFromDirtyNode(RingNode *node)
   return (SlabJournal *) ((uintptr_t) node - offsetof(SlabJournal, dirtyNode));
 }
 
+/**
+ * Convert a batch ring node to the slab journal which contains it.
+ *
+ * @param node  The ring node
+ *
+ * @return The slab journal
+ **/
+static inline SlabJournal *slabJournalFromBatchNode(RingNode *node)
+{
+  return (SlabJournal *) ((uintptr_t) node - offsetof(SlabJournal, batchNode));
+}
+
 /**
  * Return the slab journal from the slab summary waiter.
  *
@@ -170,6 +182,7 @@ bool isSlabJournalActive(SlabJournal *journal)
           || isReaping(journal)
           || journal->waitingToCommit
           || !isRingEmpty(&journal->uncommittedBlocks)
+          || !isRingEmpty(&journal->batchNode)
           || journal->updatingSlabSummary);
 }
 
@@ -265,6 +278,7 @@ int makeSlabJournal(BlockAllocator   *allocator,
   }
 
   initializeRing(&journal->dirtyNode);
+  initializeRing(&journal->batchNode);
   initializeRing(&journal->uncommittedBlocks);
 
   journal->tailHeader.nonce        = slab->allocator->nonce;
@@ -283,6 +297,7 @@ void freeSlabJournal(SlabJournal **journalPtr)
     return;
   }
 
+  unspliceRingNode(&journal->batchNode);
   FREE(journal->block);
   FREE(journal);
   *journalPtr = NULL;
@@ -666,6 +681,31 @@ static void completeWrite(VDOCompletion *completion)
   updateTailBlockLocation(journal);
 }
 
+/**
+ * Record how full a tail block is as it is written.
+ *
+ * @param journal  The journal whose tail block is being written
+ **/
+static void recordCommittedBlockFullness(SlabJournal *journal)
+{
+  const SlabJournalBlockHeader *header = &journal->tailHeader;
+  JournalEntryCount capacity = (header->hasBlockMapIncrements
+                                ? journal->fullEntriesPerBlock
+                                : journal->entriesPerBlock);
+  AtomicSlabJournalStatistics *events = journal->events;
+  if (header->entryCount >= capacity) {
+    relaxedAdd64(&events->committedFullBlocks, 1);
+  } else if ((header->entryCount * 4) >= (capacity * 3)) {
+    relaxedAdd64(&events->committedBlocksUnder100Percent, 1);
+  } else if ((header->entryCount * 2) >= capacity) {
+    relaxedAdd64(&events->committedBlocksUnder75Percent, 1);
+  } else if ((header->entryCount * 4) >= capacity) {
+    relaxedAdd64(&events->committedBlocksUnder50Percent, 1);
+  } else {
+    relaxedAdd64(&events->committedBlocksUnder25Percent, 1);
+  }
+}
+
 /**
  * Callback from acquireVIO() registered in commitSlabJournalTail().
  *
@@ -679,6 +719,7 @@ static void writeSlabJournalBlock(Waiter *waiter, void *vioContext)
   SlabJournalBlockHeader *header  = &journal->tailHeader;
 
   header->head = journal->head;
+  recordCommittedBlockFullness(journal);
   pushRingNode(&journal->uncommittedBlocks, &entry->node);
   packSlabJournalBlockHeader(header, &journal->block->header);
 
@@ -975,6 +1016,47 @@ static void addEntryFromWaiter(Waiter *waiter, void *context)
   continueDataVIO(dataVIO, result);
 }
 
+/**
+ * Skip the entries of the first two entry waiters if their reference count
+ * adjustments cancel out. Neither half gets a slab journal entry, so after a
+ * crash both are recovered from the recovery journal alone. The pair is only
+ * skipped if both halves are in the same recovery journal block, which is
+ * committed as a unit, so that recovery will either replay both of them or
+ * neither.
+ *
+ * @param journal  The journal
+ *
+ * @return <code>true</code> if two waiters were continued without entries
+ **/
+static bool coalesceNextEntries(SlabJournal *journal)
+{
+  WaitQueue *waiters = &journal->entryWaiters;
+  if (countWaiters(waiters) < 2) {
+    return false;
+  }
+
+  Waiter  *first     = getFirstWaiter(waiters);
+  DataVIO *firstVIO  = waiterAsDataVIO(first);
+  DataVIO *secondVIO = waiterAsDataVIO(first->nextWaiter);
+  if (firstVIO->recoveryJournalPoint.sequenceNumber
+      != secondVIO->recoveryJournalPoint.sequenceNumber) {
+    return false;
+  }
+
+  if (!cancelReferenceCountAdjustments(journal->slab->referenceCounts,
+                                       firstVIO->operation,
+                                       secondVIO->operation)) {
+    return false;
+  }
+
+  dequeueNextWaiter(waiters);
+  dequeueNextWaiter(waiters);
+  relaxedAdd64(&journal->events->entriesCoalesced, 2);
+  continueDataVIO(firstVIO, VDO_SUCCESS);
+  continueDataVIO(secondVIO, VDO_SUCCESS);
+  return true;
+}
+
 /**
  * Check whether the next entry to be made is a block map increment.
  *
@@ -1012,6 +1094,11 @@ static void addEntries(SlabJournal *journal)
       break;
     }
 
+    if (journal->slab->allocator->coalesceReferenceUpdates
+        && coalesceNextEntries(journal)) {
+      continue;
+    }
+
     SlabJournalBlockHeader *header = &journal->tailHeader;
     if (journal->waitingToCommit) {
       // If we are waiting for resources to write the tail block, and the
@@ -1091,6 +1178,59 @@ static void addEntries(SlabJournal *journal)
   }
 }
 
+/**
+ * Add the entries of each slab journal which accumulated while the
+ * allocator's batch completion was waiting its turn on the physical zone
+ * thread, and make any tail block commits which were requested by the
+ * recovery journal in the meantime. This callback is registered in
+ * queueSlabJournalBatch().
+ *
+ * @param completion  The allocator's slab journal batch completion
+ **/
+static void addBatchedEntries(VDOCompletion *completion)
+{
+  BlockAllocator *allocator = completion->parent;
+  allocator->slabJournalBatchLaunched = false;
+  RingNode *ring = &allocator->batchedSlabJournals;
+  while (!isRingEmpty(ring)) {
+    SlabJournal *journal = slabJournalFromBatchNode(chopRingNode(ring));
+    addEntries(journal);
+
+    SequenceNumber lock = journal->deferredCommitLock;
+    journal->deferredCommitLock = 0;
+    if ((lock != 0) && isSlabOpen(journal->slab)
+        && isSlabJournalDirty(journal) && (journal->recoveryLock <= lock)) {
+      commitSlabJournalTail(journal);
+    }
+
+    checkIfSlabDrained(journal->slab);
+  }
+}
+
+/**
+ * Queue a slab journal to have its entries added at the end of the current
+ * pass of its physical zone thread, launching the batch completion if it is
+ * not already pending.
+ *
+ * @param journal  The journal to queue
+ **/
+static void queueSlabJournalBatch(SlabJournal *journal)
+{
+  BlockAllocator *allocator = journal->slab->allocator;
+  if (isRingEmpty(&journal->batchNode)) {
+    pushRingNode(&allocator->batchedSlabJournals, &journal->batchNode);
+  }
+
+  if (allocator->slabJournalBatchLaunched) {
+    return;
+  }
+
+  allocator->slabJournalBatchLaunched = true;
+  prepareForRequeue(&allocator->slabJournalBatchCompletion, addBatchedEntries,
+                    addBatchedEntries, allocator->threadID, allocator);
+  invokeCallback(&allocator->slabJournalBatchCompletion);
+}
+
 /**********************************************************************/
 void addSlabJournalEntry(SlabJournal *journal, DataVIO *dataVIO)
 {
@@ -1115,6 +1255,11 @@ void addSlabJournalEntry(SlabJournal *journal, DataVIO *dataVIO)
     increaseScrubbingPriority(journal->slab);
   }
 
+  if (journal->slab->allocator->batchSlabJournalEntries) {
+    queueSlabJournalBatch(journal);
+    return;
+  }
+
   addEntries(journal);
 }
 
@@ -1162,6 +1307,13 @@ bool releaseRecoveryJournalLock(SlabJournal    *journal,
     return false;
   }
 
+  if (journal->slab->allocator->batchSlabJournalEntries) {
+    // Write the block once this pass has added its entries to it.
+    journal->deferredCommitLock = recoveryLock;
+    queueSlabJournalBatch(journal);
+    return true;
+  }
+
   // All locks are held by the block which is in progress; write it.
   commitSlabJournalTail(journal);
   return true;
@@ -250,6 +250,10 @@ struct slabJournal {
 
   /** This node is for BlockAllocator to keep a queue of dirty journals */
   RingNode                     dirtyNode;
+  /** This node is for BlockAllocator to queue journals with batched entries */
+  RingNode                     batchNode;
+  /** The recovery lock to release at the end of the pass, if any */
+  SequenceNumber               deferredCommitLock;
 
   /** The lock for the oldest unreaped block of the journal */
   JournalLock                 *reapLock;
@@ -177,6 +177,21 @@ static int makeSlabSummaryZone(SlabSummary      *summary,
     return VDO_SUCCESS;
   }
 
+  result = ALLOCATE(VDO_BLOCK_SIZE, char, "summary flush data",
+                    &summaryZone->unusedFlushVIOData);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  result = createVIO(layer, VIO_TYPE_SLAB_SUMMARY, VIO_PRIORITY_METADATA,
+                     summaryZone, summaryZone->unusedFlushVIOData,
+                     &summaryZone->flushVIO);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  summaryZone->flushVIO->completion.callbackThreadID = threadID;
+
   // Initialize each block.
   for (BlockCount i = 0; i < summary->blocksPerZone; i++) {
     result = initializeSlabSummaryBlock(layer, summaryZone, threadID, entries,
@@ -277,6 +292,8 @@ void freeSlabSummary(SlabSummary **slabSummaryPtr)
         freeVIO(&summaryZone->summaryBlocks[i].vio);
         FREE(summaryZone->summaryBlocks[i].outgoingEntries);
       }
+      freeVIO(&summaryZone->flushVIO);
+      FREE(summaryZone->unusedFlushVIOData);
       FREE(summaryZone);
     }
   }
@@ -368,7 +385,124 @@ static void handleWriteError(VDOCompletion *completion)
 }
 
 /**
- * Write a slab summary block unless it is currently out for writing.
+ * Write a slab summary block whose preceding flush has completed.
+ *
+ * @param block  The block to write
+ **/
+static void writeFlushedBlock(SlabSummaryBlock *block)
+{
+  SlabSummaryZone *zone    = block->zone;
+  SlabSummary     *summary = zone->summary;
+  memcpy(block->outgoingEntries, block->entries,
+         sizeof(SlabSummaryEntry) * summary->entriesPerBlock);
+
+  PhysicalBlockNumber pbn = (summary->origin
+                             + (summary->blocksPerZone * zone->zoneNumber)
+                             + block->index);
+  launchWriteMetadataVIO(block->vio, pbn, finishUpdate, handleWriteError);
+}
+
+/**********************************************************************/
+static void launchZoneFlush(SlabSummaryZone *zone);
+
+/**
+ * Finish the flush shared by the blocks of a zone and write each of them.
+ * Blocks which need writing while the flush is outstanding wait for the next
+ * flush, since it is only the next flush which will cover the slab journal
+ * and reference block writes their updates depend upon.
+ *
+ * @param zone  The zone whose flush has finished
+ **/
+static void finishZoneFlush(SlabSummaryZone *zone)
+{
+  int result = ((zone->flushVIO->completion.result == VDO_SUCCESS)
+                ? VDO_SUCCESS : VDO_READ_ONLY);
+  for (BlockCount i = 0; i < zone->summary->blocksPerZone; i++) {
+    SlabSummaryBlock *block = &zone->summaryBlocks[i];
+    if (!block->inFlush) {
+      continue;
+    }
+
+    block->inFlush = false;
+    if (result == VDO_SUCCESS) {
+      writeFlushedBlock(block);
+    } else {
+      finishUpdatingSlabSummaryBlock(block);
+    }
+  }
+
+  zone->flushing = false;
+  launchZoneFlush(zone);
+}
+
+/**
+ * Callback for a successful zone flush.
+ *
+ * @param completion  The flush VIO
+ **/
+static void finishFlush(VDOCompletion *completion)
+{
+  finishZoneFlush(completion->parent);
+}
+
+/**
+ * Handle an error flushing before writing slab summary blocks.
+ *
+ * @param completion  The flush VIO
+ **/
+static void handleFlushError(VDOCompletion *completion)
+{
+  SlabSummaryZone *zone = completion->parent;
+  enterReadOnlyMode(zone->summary->readOnlyNotifier, completion->result);
+  finishZoneFlush(zone);
+}
+
+/**
+ * Flush the layer on behalf of every block in a zone which is waiting to be
+ * written, unless a flush is already outstanding. A single flush ensures that
+ * the slab journal tail blocks and reference updates covered by all of the
+ * pending summary updates are stable (VDO-2332).
+ *
+ * @param zone  The zone
+ **/
+static void launchZoneFlush(SlabSummaryZone *zone)
+{
+  if (zone->flushing) {
+    return;
+  }
+
+  bool       readOnly = isReadOnly(zone->summary->readOnlyNotifier);
+  BlockCount count    = 0;
+  for (BlockCount i = 0; i < zone->summary->blocksPerZone; i++) {
+    SlabSummaryBlock *block = &zone->summaryBlocks[i];
+    if (!block->awaitingFlush) {
+      continue;
+    }
+
+    block->awaitingFlush = false;
+    if (readOnly) {
+      finishUpdatingSlabSummaryBlock(block);
+      continue;
+    }
+
+    block->inFlush = true;
+    count++;
+  }
+
+  if (count == 0) {
+    return;
+  }
+
+  AtomicSlabSummaryStatistics *statistics = &zone->summary->statistics;
+  atomicAdd64(&statistics->flushes, 1);
+  atomicAdd64(&statistics->flushesSaved, count - 1);
+  zone->flushing = true;
+  launchFlush(zone->flushVIO, finishFlush, handleFlushError);
+}
+
+/**
+ * Write a slab summary block unless it is currently out for writing. The
+ * write waits for a flush which may be shared with other blocks in the zone.
  *
  * @param [in] block  The block that needs to be committed
  **/
@@ -383,22 +517,13 @@ static void launchWrite(SlabSummaryBlock *block)
   transferAllWaiters(&block->nextUpdateWaiters, &block->currentUpdateWaiters);
   block->writing = true;
 
-  SlabSummary *summary = zone->summary;
-  if (isReadOnly(summary->readOnlyNotifier)) {
+  if (isReadOnly(zone->summary->readOnlyNotifier)) {
     finishUpdatingSlabSummaryBlock(block);
     return;
   }
 
-  memcpy(block->outgoingEntries, block->entries,
-         sizeof(SlabSummaryEntry) * summary->entriesPerBlock);
-
-  // Flush before writing to ensure that the slab journal tail blocks and
-  // reference updates covered by this summary update are stable (VDO-2332).
-  PhysicalBlockNumber pbn = (summary->origin
-                             + (summary->blocksPerZone * zone->zoneNumber)
-                             + block->index);
-  launchWriteMetadataVIOWithFlush(block->vio, pbn, finishUpdate,
-                                  handleWriteError, true, false);
+  block->awaitingFlush = true;
+  launchZoneFlush(zone);
 }
 
 /**
@@ -647,5 +772,7 @@ SlabSummaryStatistics getSlabSummaryStatistics(const SlabSummary *summary)
   const AtomicSlabSummaryStatistics *atoms = &summary->statistics;
   return (SlabSummaryStatistics) {
     .blocksWritten = atomicLoad64(&atoms->blocksWritten),
+    .flushes       = atomicLoad64(&atoms->flushes),
+    .flushesSaved  = atomicLoad64(&atoms->flushesSaved),
   };
 }
@@ -55,6 +55,10 @@ typedef struct slabSummaryBlock {
   BlockCount        index;
   /** Whether this block has a write outstanding */
   bool              writing;
+  /** Whether this block's write is waiting for the next zone flush */
+  bool              awaitingFlush;
+  /** Whether this block's write is waiting for the current zone flush */
+  bool              inFlush;
   /** Ring of updates waiting on the outstanding write */
   WaitQueue         currentUpdateWaiters;
   /** Ring of updates waiting on the next write */
@@ -75,6 +79,10 @@ typedef struct slabSummaryBlock {
 typedef struct atomicSlabSummaryStatistics {
   /** Number of blocks written */
   Atomic64 blocksWritten;
+  /** Number of flushes issued before writing blocks */
+  Atomic64 flushes;
+  /** Number of block writes which shared a flush with another write */
+  Atomic64 flushesSaved;
 } AtomicSlabSummaryStatistics;
 
 struct slabSummaryZone {
@@ -84,6 +92,12 @@ struct slabSummaryZone {
   ZoneCount         zoneNumber;
   /** Count of the number of blocks currently out for writing */
   BlockCount        writeCount;
+  /** Whether the zone has a flush outstanding */
+  bool              flushing;
+  /** The VIO used to flush before writing blocks */
+  VIO              *flushVIO;
+  /** The unused data buffer backing the flush VIO */
+  char             *unusedFlushVIOData;
   /** The state of this zone */
   AdminState        state;
   /** The array (owned by the blocks) of all entries */
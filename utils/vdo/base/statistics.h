@@ -24,7 +24,7 @@
 #include "types.h"
 
 enum {
-  STATISTICS_VERSION = 31,
+  STATISTICS_VERSION = 41,
 };
 
 typedef struct {
@@ -34,6 +34,12 @@ typedef struct {
   uint64_t slabsOpened;
   /** The number of times since loading that a slab has been re-opened */
   uint64_t slabsReopened;
+  /** Number of metadata VIO requests which waited for the VIO pool */
+  uint64_t vioPoolWaits;
+  /** Number of VIOs added to the VIO pool while it was exhausted */
+  uint64_t vioPoolGrowths;
+  /** Current number of VIOs in the VIO pool */
+  uint64_t vioPoolSize;
 } BlockAllocatorStatistics;
 
 /**
@@ -72,6 +78,20 @@ typedef struct {
   uint64_t compressedBlocksWritten;
   /** Number of VIOs that are pending in the packer */
   uint64_t compressedFragmentsInPacker;
+  /** Number of fragments which left the packer in under 1 ms */
+  uint64_t residencyUnder1ms;
+  /** Number of fragments which left the packer in 1 to 10 ms */
+  uint64_t residencyUnder10ms;
+  /** Number of fragments which left the packer in 10 to 100 ms */
+  uint64_t residencyUnder100ms;
+  /** Number of fragments which left the packer in 100 ms to 1 s */
+  uint64_t residencyUnder1s;
+  /** Number of fragments which left the packer after 1 s or more */
+  uint64_t residencyOver1s;
+  /** Number of bins written because the maximum residency was exceeded */
+  uint64_t residencyTimeouts;
+  /** Number of fragments packed after the preceding block of their run */
+  uint64_t runFragmentsPacked;
 } PackerStatistics;
 
 /** The statistics for the slab journals. */
@@ -86,12 +106,28 @@ typedef struct {
   uint64_t blocksWritten;
   /** Number of times we had to wait for the tail to write */
   uint64_t tailBusyCount;
+  /** Number of tail blocks written less than 25% full */
+  uint64_t committedBlocksUnder25Percent;
+  /** Number of tail blocks written at least 25% but less than 50% full */
+  uint64_t committedBlocksUnder50Percent;
+  /** Number of tail blocks written at least 50% but less than 75% full */
+  uint64_t committedBlocksUnder75Percent;
+  /** Number of tail blocks written at least 75% full but not full */
+  uint64_t committedBlocksUnder100Percent;
+  /** Number of tail blocks written full */
+  uint64_t committedFullBlocks;
+  /** Number of entries not made because they cancelled out */
+  uint64_t entriesCoalesced;
 } SlabJournalStatistics;
 
 /** The statistics for the slab summary. */
 typedef struct {
   /** Number of blocks written */
   uint64_t blocksWritten;
+  /** Number of flushes issued before writing blocks */
+  uint64_t flushes;
+  /** Number of block writes which shared a flush with another write */
+  uint64_t flushesSaved;
 } SlabSummaryStatistics;
 
 /** The statistics for the reference counts. */
@@ -142,6 +178,12 @@ typedef struct {
   uint64_t pagesSaved;
   /** the number of flushes issued */
   uint64_t flushCount;
+  /** number of tree page requests which waited for the VIO pool */
+  uint64_t vioPoolWaits;
+  /** number of VIOs added to the VIO pool while it was exhausted */
+  uint64_t vioPoolGrowths;
+  /** current number of VIOs in the VIO pool */
+  uint64_t vioPoolSize;
 } BlockMapStatistics;
 
 /** The dedupe statistics from hash locks */
@@ -154,8 +196,34 @@ typedef struct {
   uint64_t concurrentDataMatches;
   /** Number of writes whose hash collided with an in-flight write */
   uint64_t concurrentHashCollisions;
+  /** Number of UDS queries skipped for regions which do not deduplicate */
+  uint64_t dedupeQueriesBypassed;
+  /** Number of UDS queries sampled from regions which do not deduplicate */
+  uint64_t dedupeQueriesSampled;
+  /** Number of UDS updates for data unlikely to dedupe which were sent */
+  uint64_t indexPostsSampled;
+  /** Number of UDS updates for data unlikely to dedupe which were skipped */
+  uint64_t indexPostsSkipped;
+  /** Number of dedupe verifications made against recently written data */
+  uint64_t dedupeVerificationsCached;
 } HashLockStatistics;
 
+/** The classification of writes by the logical zone stream detectors */
+typedef struct {
+  /** Number of writes classified */
+  uint64_t writesClassified;
+  /** Number of writes to regions written sequentially */
+  uint64_t sequentialWrites;
+  /** Number of writes to regions written randomly */
+  uint64_t randomWrites;
+  /** Number of writes to regions being overwritten frequently */
+  uint64_t hotWrites;
+  /** Number of writes to regions whose data does not compress */
+  uint64_t incompressibleWrites;
+  /** Number of writes to regions whose data does not deduplicate */
+  uint64_t nonDuplicateWrites;
+} StreamStatistics;
+
 /** Counts of error conditions in VDO. */
 typedef struct {
   /** number of times VDO got an invalid dedupe advice PBN from UDS */
@@ -212,6 +280,8 @@ struct vdoStatistics {
   BlockMapStatistics blockMap;
   /** The dedupe statistics from hash locks */
   HashLockStatistics hashLock;
+  /** The classification of writes by region */
+  StreamStatistics streams;
   /** Counts of error conditions */
   ErrorStatistics errors;
 };
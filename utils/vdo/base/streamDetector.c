@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2020 Red Hat, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA. 
+ *
+ * $Id: //eng/vdo-releases/aluminum/src/c++/vdo/base/streamDetector.c#1 $
+ */
+
+#include "streamDetector.h"
+
+#include "memoryAlloc.h"
+
+#include "atomic.h"
+
+enum {
+  /** log2 of the number of logical blocks in a region (1 MB of 4K blocks) */
+  STREAM_REGION_SHIFT   = 8,
+  /** log2 of the number of regions each detector tracks */
+  STREAM_TABLE_SHIFT    = 8,
+  /** The number of regions each detector tracks */
+  STREAM_TABLE_SIZE     = 1 << STREAM_TABLE_SHIFT,
+  /** The number of writes to a zone between halvings of the region counts */
+  STREAM_EPOCH_WRITES   = 4096,
+  /** The largest number of halvings which leaves a count non-zero */
+  STREAM_MAX_DECAY      = 15,
+  /** The number of recent observations needed to classify a region */
+  STREAM_MIN_SAMPLES    = 16,
+  /** The number of recent overwrites which makes a region hot */
+  STREAM_HOT_OVERWRITES = 64,
+};
+
+/** Fibonacci hashing multiplier for spreading region numbers over the table */
+static const uint64_t STREAM_REGION_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+/**
+ * The recent history of writes to one region of logical blocks.
+ **/
+typedef struct {
+  /** The region number plus one, or zero if this entry is unused */
+  uint64_t           tag;
+  /** The epoch at which the counts were last decayed */
+  uint64_t           epoch;
+  /** The block following the most recent write to the region */
+  LogicalBlockNumber nextLBN;
+  /** The recent writes to the region */
+  uint16_t           writes;
+  /** The recent writes which followed on from the previous write */
+  uint16_t           sequential;
+  /** The recent completed writes of data */
+  uint16_t           outcomes;
+  /** The recent completed writes which replaced an existing mapping */
+  uint16_t           overwrites;
+  /** The recent completed writes which showed whether data deduplicates */
+  uint16_t           dedupeSamples;
+  /** The recent completed writes whose data was a duplicate */
+  uint16_t           duplicates;
+  /** The recent completed writes whose data failed to compress */
+  uint16_t           incompressible;
+} StreamRegion;
+
+/**
+ * The counts of classified writes, which are read by other threads.
+ **/
+typedef struct {
+  Atomic64 writesClassified;
+  Atomic64 sequentialWrites;
+  Atomic64 randomWrites;
+  Atomic64 hotWrites;
+  Atomic64 incompressibleWrites;
+  Atomic64 nonDuplicateWrites;
+} AtomicStreamStatistics;
+
+struct streamDetector {
+  /** The number of halvings of the region counts so far */
+  uint64_t               epoch;
+  /** The number of writes recorded in the current epoch */
+  uint32_t               epochWrites;
+  /** The classification statistics */
+  AtomicStreamStatistics statistics;
+  /** The regions, indexed by a hash of the region number */
+  StreamRegion           regions[STREAM_TABLE_SIZE];
+};
+
+/**********************************************************************/
+int makeStreamDetector(StreamDetector **detectorPtr)
+{
+  StreamDetector *detector;
+  int result = ALLOCATE(1, StreamDetector, __func__, &detector);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  *detectorPtr = detector;
+  return VDO_SUCCESS;
+}
+
+/**********************************************************************/
+void freeStreamDetector(StreamDetector **detectorPtr)
+{
+  StreamDetector *detector = *detectorPtr;
+  if (detector == NULL) {
+    return;
+  }
+
+  FREE(detector);
+  *detectorPtr = NULL;
+}
+
+/**
+ * Get the region tag of a logical block.
+ *
+ * @param lbn  The logical block
+ *
+ * @return The tag of the region containing the block
+ **/
+static inline uint64_t getRegionTag(LogicalBlockNumber lbn)
+{
+  return (lbn >> STREAM_REGION_SHIFT) + 1;
+}
+
+/**
+ * Get the index of the table entry to which a region tag hashes.
+ *
+ * @param tag  The region tag
+ *
+ * @return The index of the table entry for the tag, which may hold another
+ *         region
+ **/
+static inline unsigned int getRegionIndex(uint64_t tag)
+{
+  return ((tag * STREAM_REGION_MULTIPLIER) >> (64 - STREAM_TABLE_SHIFT));
+}
+
+/**
+ * Halve the counts of a region once for each epoch which has passed since
+ * they were last decayed.
+ *
+ * @param detector  The detector
+ * @param region    The region to decay
+ **/
+static void decayRegion(const StreamDetector *detector, StreamRegion *region)
+{
+  uint64_t elapsed = detector->epoch - region->epoch;
+  if (elapsed == 0) {
+    return;
+  }
+
+  unsigned int shift = ((elapsed > STREAM_MAX_DECAY)
+                        ? STREAM_MAX_DECAY + 1 : (unsigned int) elapsed);
+  region->writes         >>= shift;
+  region->sequential     >>= shift;
+  region->outcomes       >>= shift;
+  region->overwrites     >>= shift;
+  region->dedupeSamples  >>= shift;
+  region->duplicates     >>= shift;
+  region->incompressible >>= shift;
+  region->epoch            = detector->epoch;
+}
+
+/**
+ * Classify a region from its recent counts.
+ *
+ * @param region  The region
+ *
+ * @return The StreamClass flags of the region
+ **/
+static StreamHints classifyRegion(const StreamRegion *region)
+{
+  StreamHints hints = 0;
+  if (region->writes >= STREAM_MIN_SAMPLES) {
+    if ((region->sequential * 4) >= (region->writes * 3)) {
+      hints |= STREAM_SEQUENTIAL;
+    } else if ((region->sequential * 4) < region->writes) {
+      hints |= STREAM_RANDOM;
+    }
+  }
+
+  if (region->overwrites >= STREAM_HOT_OVERWRITES) {
+    hints |= STREAM_HOT;
+  }
+
+  // Writes which skipped the index are excluded from the dedupe rate, so
+  // that a region which has stopped being queried is still judged only by
+  // the sample of writes which were.
+  if ((region->dedupeSamples >= STREAM_MIN_SAMPLES)
+      && ((region->duplicates * 16) <= region->dedupeSamples)) {
+    hints |= STREAM_NON_DUPLICATE;
+  }
+
+  if (region->outcomes >= STREAM_MIN_SAMPLES) {
+    // Only new data is compressed, so judge compression by new data alone.
+    uint16_t newData = region->outcomes - region->duplicates;
+    if ((newData >= STREAM_MIN_SAMPLES)
+        && ((region->incompressible * 8) >= (newData * 7))) {
+      hints |= STREAM_INCOMPRESSIBLE;
+    }
+  }
+
+  return hints;
+}
+
+/**
+ * Count a classified write in the detector's statistics.
+ *
+ * @param detector  The detector
+ * @param hints     The classification of the write
+ **/
+static void countClassifiedWrite(StreamDetector *detector, StreamHints hints)
+{
+  AtomicStreamStatistics *stats = &detector->statistics;
+  relaxedAdd64(&stats->writesClassified, 1);
+  if ((hints & STREAM_SEQUENTIAL) != 0) {
+    relaxedAdd64(&stats->sequentialWrites, 1);
+  }
+  if ((hints & STREAM_RANDOM) != 0) {
+    relaxedAdd64(&stats->randomWrites, 1);
+  }
+  if ((hints & STREAM_HOT) != 0) {
+    relaxedAdd64(&stats->hotWrites, 1);
+  }
+  if ((hints & STREAM_INCOMPRESSIBLE) != 0) {
+    relaxedAdd64(&stats->incompressibleWrites, 1);
+  }
+  if ((hints & STREAM_NON_DUPLICATE) != 0) {
+    relaxedAdd64(&stats->nonDuplicateWrites, 1);
+  }
+}
+
+/**********************************************************************/
+StreamHints recordStreamWrite(StreamDetector *detector, LogicalBlockNumber lbn)
+{
+  if (++detector->epochWrites >= STREAM_EPOCH_WRITES) {
+    detector->epochWrites = 0;
+    detector->epoch++;
+  }
+
+  uint64_t      tag    = getRegionTag(lbn);
+  StreamRegion *region = &detector->regions[getRegionIndex(tag)];
+  if (region->tag != tag) {
+    // Take over the entry; the region it held has not been written lately.
+    *region = (StreamRegion) {
+      .tag     = tag,
+      .epoch   = detector->epoch,
+      .nextLBN = lbn,
+    };
+  } else {
+    decayRegion(detector, region);
+  }
+
+  if (lbn == region->nextLBN) {
+    region->sequential++;
+  }
+  region->writes++;
+  region->nextLBN = lbn + 1;
+
+  StreamHints hints = classifyRegion(region);
+  countClassifiedWrite(detector, hints);
+  return hints;
+}
+
+/**********************************************************************/
+void recordStreamOutcome(StreamDetector     *detector,
+                         LogicalBlockNumber  lbn,
+                         bool                overwrite,
+                         bool                duplicate,
+                         bool                incompressible,
+                         bool                bypassed)
+{
+  uint64_t      tag    = getRegionTag(lbn);
+  StreamRegion *region = &detector->regions[getRegionIndex(tag)];
+  if (region->tag != tag) {
+    // The region was displaced while the write was in progress.
+    return;
+  }
+
+  decayRegion(detector, region);
+  region->outcomes++;
+  if (overwrite) {
+    region->overwrites++;
+  }
+  if (duplicate || !bypassed) {
+    region->dedupeSamples++;
+  }
+  if (duplicate) {
+    region->duplicates++;
+  }
+  if (incompressible) {
+    region->incompressible++;
+  }
+}
+
+/**********************************************************************/
+StreamHints getStreamHints(const StreamDetector *detector,
+                           LogicalBlockNumber    lbn)
+{
+  uint64_t            tag    = getRegionTag(lbn);
+  const StreamRegion *region = &detector->regions[getRegionIndex(tag)];
+  if (region->tag != tag) {
+    return 0;
+  }
+
+  // Classify a decayed copy so that this query does not modify the detector.
+  StreamRegion decayed = *region;
+  decayRegion(detector, &decayed);
+  return classifyRegion(&decayed);
+}
+
+/**********************************************************************/
+StreamStatistics getStreamDetectorStatistics(const StreamDetector *detector)
+{
+  const AtomicStreamStatistics *atoms = &detector->statistics;
+  return (StreamStatistics) {
+    .writesClassified     = relaxedLoad64(&atoms->writesClassified),
+    .sequentialWrites     = relaxedLoad64(&atoms->sequentialWrites),
+    .randomWrites         = relaxedLoad64(&atoms->randomWrites),
+    .hotWrites            = relaxedLoad64(&atoms->hotWrites),
+    .incompressibleWrites = relaxedLoad64(&atoms->incompressibleWrites),
+    .nonDuplicateWrites   = relaxedLoad64(&atoms->nonDuplicateWrites),
+  };
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2020 Red Hat, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA. 
+ *
+ * $Id: //eng/vdo-releases/aluminum/src/c++/vdo/base/streamDetector.h#1 $
+ */
+
+#ifndef STREAM_DETECTOR_H
+#define STREAM_DETECTOR_H
+
+#include "statistics.h"
+#include "types.h"
+
+/**
+ * A StreamDetector classifies the writes handled by a logical zone by the
+ * region of logical blocks they fall in. Each region keeps counts of its
+ * recent writes and of what became of them, which are halved periodically so
+ * that the classification follows changes in the workload. The detector is
+ * only used from its logical zone's thread.
+ **/
+
+/**
+ * The classes of write traffic a StreamDetector recognizes. A region may be
+ * in several classes at once, although never both sequential and random.
+ **/
+typedef enum {
+  /** Most recent writes continued from the previous write to the region */
+  STREAM_SEQUENTIAL     = 0x01,
+  /** Few recent writes continued from the previous write to the region */
+  STREAM_RANDOM         = 0x02,
+  /** The region's mapped blocks are being overwritten frequently */
+  STREAM_HOT            = 0x04,
+  /** Nearly all recent new data in the region failed to compress */
+  STREAM_INCOMPRESSIBLE = 0x08,
+  /** Hardly any recent writes to the region were duplicates */
+  STREAM_NON_DUPLICATE  = 0x10,
+} StreamClass;
+
+/**
+ * Make a stream detector.
+ *
+ * @param [out] detectorPtr  A pointer to hold the new detector
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+int makeStreamDetector(StreamDetector **detectorPtr)
+  __attribute__((warn_unused_result));
+
+/**
+ * Free a stream detector and null out the reference to it.
+ *
+ * @param detectorPtr  A reference to the detector to free
+ **/
+void freeStreamDetector(StreamDetector **detectorPtr);
+
+/**
+ * Note the arrival of a write and get the classification of its region.
+ *
+ * @param detector  The detector of the logical zone of the write
+ * @param lbn       The logical block being written
+ *
+ * @return The StreamClass flags of the region containing the block
+ **/
+StreamHints recordStreamWrite(StreamDetector *detector, LogicalBlockNumber lbn)
+  __attribute__((warn_unused_result));
+
+/**
+ * Note what became of a completed write of data (not of zeros or a trim).
+ *
+ * @param detector        The detector of the logical zone of the write
+ * @param lbn             The logical block which was written
+ * @param overwrite       Whether the block was mapped before the write
+ * @param duplicate       Whether the data was a duplicate
+ * @param incompressible  Whether the data failed to compress
+ * @param bypassed        Whether the write skipped the UDS query, in which
+ *                        case its data is only known to be a duplicate if it
+ *                        matched another write in flight
+ **/
+void recordStreamOutcome(StreamDetector     *detector,
+                         LogicalBlockNumber  lbn,
+                         bool                overwrite,
+                         bool                duplicate,
+                         bool                incompressible,
+                         bool                bypassed);
+
+/**
+ * Get the classification of a region without recording a write to it.
+ *
+ * @param detector  The detector of the logical zone of the block
+ * @param lbn       The logical block
+ *
+ * @return The StreamClass flags of the region containing the block
+ **/
+StreamHints getStreamHints(const StreamDetector *detector,
+                           LogicalBlockNumber    lbn)
+  __attribute__((warn_unused_result));
+
+/**
+ * Get the classification statistics of a stream detector. This may be called
+ * from any thread.
+ *
+ * @param detector  The detector
+ *
+ * @return The counts of writes in each class
+ **/
+StreamStatistics getStreamDetectorStatistics(const StreamDetector *detector)
+  __attribute__((warn_unused_result));
+
+#endif /* STREAM_DETECTOR_H */
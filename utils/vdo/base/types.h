@@ -116,6 +116,12 @@ typedef uint16_t SlabCount;
  **/
 typedef uint16_t SlotNumber;
 
+/**
+ * A set of StreamClass flags describing the recent writes to a region of
+ * logical blocks.
+ **/
+typedef uint8_t StreamHints;
+
 /**
  * A number of VIOs.
  **/
@@ -199,6 +205,7 @@ typedef enum __attribute__((packed)) {
   BLOCK_ALLOCATOR_PARTITION  = 1,
   RECOVERY_JOURNAL_PARTITION = 2,
   SLAB_SUMMARY_PARTITION     = 3,
+  BLOCK_MAP_TIER_PARTITION   = 4,
 } PartitionID;
 
 /**
@@ -349,6 +356,26 @@ typedef struct vdoLoadConfig {
   WritePolicy           writePolicy;
   /** the maximum age of a dirty block map page in recovery journal blocks */
   BlockCount            maximumAge;
+  /** the maximum time a fragment may wait in the packer, in ms (0 = none) */
+  uint32_t              maxPackerResidency;
+  /** whether the packer keeps fragments of sequential runs together */
+  bool                  packSequentialRuns;
+  /** whether to add slab journal entries once per physical zone pass */
+  bool                  batchSlabJournalEntries;
+  /** whether cancelling reference count adjustments skip the slab journal */
+  bool                  coalesceReferenceUpdates;
+  /** the multiple of its preallocated size to which each metadata VIO pool
+   *  may grow while metadata I/O is backed up (0 or 1 = fixed size) */
+  uint32_t              vioPoolGrowthFactor;
+  /** log2 of the inverse of the fraction of names of data unlikely to
+   *  deduplicate whose advice is updated in UDS (0 = update every name);
+   *  queries, which also post new names, are not affected */
+  uint8_t               indexPostSampleShift;
+  /** the number of recently written data blocks each physical zone keeps in
+   *  memory to verify dedupe advice without reading (0 = none); requires a
+   *  layer providing exportData and compareDataToBuffer, which no layer in
+   *  this tree does */
+  BlockCount            recentWriteCacheBlocks;
 } VDOLoadConfig;
 
 /**
@@ -385,6 +412,7 @@ typedef struct slabJournalEntry    SlabJournalEntry;
 typedef struct slabScrubber        SlabScrubber;
 typedef struct slabSummary         SlabSummary;
 typedef struct slabSummaryZone     SlabSummaryZone;
+typedef struct streamDetector      StreamDetector;
 typedef struct vdo                 VDO;
 typedef struct vdoCompletion       VDOCompletion;
 typedef struct vdoExtent           VDOExtent;
@@ -46,6 +46,7 @@
 #include "slabSummary.h"
 #include "statistics.h"
 #include "statusCodes.h"
+#include "streamDetector.h"
 #include "threadConfig.h"
 #include "vdoLayout.h"
 #include "vioWrite.h"
@@ -825,10 +826,43 @@ static HashLockStatistics getHashLockStatistics(const VDO *vdo)
   const ThreadConfig *threadConfig = getThreadConfig(vdo);
   for (ZoneCount zone = 0; zone < threadConfig->hashZoneCount; zone++) {
     HashLockStatistics stats  = getHashZoneStatistics(vdo->hashZones[zone]);
-    totals.dedupeAdviceValid        += stats.dedupeAdviceValid;
-    totals.dedupeAdviceStale        += stats.dedupeAdviceStale;
-    totals.concurrentDataMatches    += stats.concurrentDataMatches;
-    totals.concurrentHashCollisions += stats.concurrentHashCollisions;
+    totals.dedupeAdviceValid         += stats.dedupeAdviceValid;
+    totals.dedupeAdviceStale         += stats.dedupeAdviceStale;
+    totals.concurrentDataMatches     += stats.concurrentDataMatches;
+    totals.concurrentHashCollisions  += stats.concurrentHashCollisions;
+    totals.dedupeQueriesBypassed     += stats.dedupeQueriesBypassed;
+    totals.dedupeQueriesSampled      += stats.dedupeQueriesSampled;
+    totals.indexPostsSampled         += stats.indexPostsSampled;
+    totals.indexPostsSkipped         += stats.indexPostsSkipped;
+    totals.dedupeVerificationsCached += stats.dedupeVerificationsCached;
+  }
+
+  return totals;
+}
+
+/**
+ * Get the write classification statistics from all logical zones.
+ *
+ * @param vdo  The vdo to query
+ *
+ * @return The sum of the stream statistics from all logical zones
+ **/
+static StreamStatistics getStreamStatistics(const VDO *vdo)
+{
+  StreamStatistics totals;
+  memset(&totals, 0, sizeof(totals));
+
+  const ThreadConfig *threadConfig = getThreadConfig(vdo);
+  for (ZoneCount zone = 0; zone < threadConfig->logicalZoneCount; zone++) {
+    LogicalZone      *logicalZone = getLogicalZone(vdo->logicalZones, zone);
+    StreamStatistics  stats
+      = getStreamDetectorStatistics(getStreamDetector(logicalZone));
+    totals.writesClassified     += stats.writesClassified;
+    totals.sequentialWrites     += stats.sequentialWrites;
+    totals.randomWrites         += stats.randomWrites;
+    totals.hotWrites            += stats.hotWrites;
+    totals.incompressibleWrites += stats.incompressibleWrites;
+    totals.nonDuplicateWrites   += stats.nonDuplicateWrites;
   }
 
   return totals;
@@ -903,6 +937,7 @@ void getVDOStatistics(const VDO *vdo, VDOStatistics *stats)
   stats->refCounts          = getDepotRefCountsStatistics(depot);
   stats->blockMap           = getBlockMapStatistics(vdo->blockMap);
   stats->hashLock           = getHashLockStatistics(vdo);
+  stats->streams            = getStreamStatistics(vdo);
   stats->errors             = getVDOErrorStatistics(vdo);
   SlabCount slabTotal       = getDepotSlabCount(depot);
   stats->recoveryPercentage
@@ -941,7 +976,8 @@ BlockCount getPhysicalBlocksOverhead(const VDO *vdo)
 BlockCount getTotalBlockMapBlocks(const VDO *vdo)
 {
   return (getNumberOfFixedBlockMapPages(vdo->blockMap)
-          + getJournalBlockMapDataBlocksUsed(vdo->recoveryJournal));
+          + getJournalBlockMapDataBlocksUsed(vdo->recoveryJournal)
+          + getJournalBlockMapTierPagesUsed(vdo->recoveryJournal));
 }
 
 /**********************************************************************/
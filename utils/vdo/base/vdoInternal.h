@@ -61,6 +61,8 @@ struct vdo {
   VDOConfig             config;
   /* The load-time configuration of this VDO */
   VDOLoadConfig         loadConfig;
+  /* The block map cache size requested by a cache resize */
+  PageCount             nextCacheSize;
   /* The nonce for this VDO */
   Nonce                 nonce;
 
@@ -22,10 +22,14 @@
 #include "vdoLayout.h"
 #include "vdoLayoutInternals.h"
 
+#include "buffer.h"
 #include "logger.h"
 #include "memoryAlloc.h"
 
 #include "blockMap.h"
+#include "completion.h"
+#include "constants.h"
+#include "header.h"
 #include "partitionCopy.h"
 #include "slab.h"
 #include "slabSummary.h"
@@ -43,14 +47,88 @@ static const PartitionID REQUIRED_PARTITIONS[] = {
 
 static const uint8_t REQUIRED_PARTITION_COUNT = 4;
 
+enum {
+  /** The number of blocks at the start of an external device for its label */
+  EXTERNAL_LABEL_BLOCKS = 1,
+};
+
+/**
+ * The label written in the first block of an external metadata device.
+ **/
+typedef struct {
+  Nonce      nonce;
+  BlockCount blockCount;
+} __attribute__((packed)) ExternalLabel1_0;
+
+static const Header EXTERNAL_LABEL_HEADER_1_0 = {
+  .id = EXTERNAL_LABEL,
+  .version = {
+    .majorVersion = 1,
+    .minorVersion = 0,
+  },
+  .size = sizeof(ExternalLabel1_0),
+};
+
+/**
+ * The first encoding of the layout of an external metadata device was a full
+ * FixedLayout. It is still decoded, but no longer written, since it did not
+ * fit in the super block once the device held more than one partition.
+ **/
+static const Header EXTERNAL_LAYOUT_HEADER_1_0 = {
+  .id = EXTERNAL_LAYOUT,
+  .version = {
+    .majorVersion = 1,
+    .minorVersion = 0,
+  },
+  .size = 0, // Minimum size; the encoded FixedLayout is variable size.
+};
+
+/**
+ * The encoding of the layout of an external metadata device. Only the
+ * partition sizes are recorded; the layout is recomputed when it is decoded.
+ * Version 2.0 predates the block map tier and is decoded as having none.
+ **/
+typedef struct {
+  BlockCount blockCount;
+  BlockCount journalBlocks;
+  BlockCount summaryBlocks;
+} __attribute__((packed)) ExternalLayout2_0;
+
+typedef struct {
+  BlockCount blockCount;
+  BlockCount journalBlocks;
+  BlockCount summaryBlocks;
+  BlockCount blockMapTierBlocks;
+} __attribute__((packed)) ExternalLayout3_0;
+
+static const Header EXTERNAL_LAYOUT_HEADER_2_0 = {
+  .id = EXTERNAL_LAYOUT,
+  .version = {
+    .majorVersion = 2,
+    .minorVersion = 0,
+  },
+  .size = sizeof(ExternalLayout2_0),
+};
+
+static const Header EXTERNAL_LAYOUT_HEADER_3_0 = {
+  .id = EXTERNAL_LAYOUT,
+  .version = {
+    .majorVersion = 3,
+    .minorVersion = 0,
+  },
+  .size = sizeof(ExternalLayout3_0),
+};
+
 /**
  * Make a fixed layout for a VDO.
  *
  * @param [in]  physicalBlocks  The number of physical blocks in the VDO
  * @param [in]  startingOffset  The starting offset of the layout
  * @param [in]  blockMapBlocks  The size of the block map partition
- * @param [in]  journalBlocks   The size of the journal partition
- * @param [in]  summaryBlocks   The size of the slab summary partition
+ * @param [in]  journalBlocks   The size of the journal partition (0 if it is
+ *                              on the external metadata device)
+ * @param [in]  summaryBlocks   The size of the slab summary partition (0 if it
+ *                              is on the external metadata device)
  * @param [out] layoutPtr       A pointer to hold the new FixedLayout
  *
  * @return VDO_SUCCESS or an error
@@ -84,18 +162,22 @@ static int makeVDOFixedLayout(BlockCount            physicalBlocks,
     return result;
   }
 
-  result = makeFixedLayoutPartition(layout, SLAB_SUMMARY_PARTITION,
-                                    summaryBlocks, FROM_END, 0);
-  if (result != VDO_SUCCESS) {
-    freeFixedLayout(&layout);
-    return result;
+  if (summaryBlocks > 0) {
+    result = makeFixedLayoutPartition(layout, SLAB_SUMMARY_PARTITION,
+                                      summaryBlocks, FROM_END, 0);
+    if (result != VDO_SUCCESS) {
+      freeFixedLayout(&layout);
+      return result;
+    }
   }
 
-  result = makeFixedLayoutPartition(layout, RECOVERY_JOURNAL_PARTITION,
-                                    journalBlocks, FROM_END, 0);
-  if (result != VDO_SUCCESS) {
-    freeFixedLayout(&layout);
-    return result;
+  if (journalBlocks > 0) {
+    result = makeFixedLayoutPartition(layout, RECOVERY_JOURNAL_PARTITION,
+                                      journalBlocks, FROM_END, 0);
+    if (result != VDO_SUCCESS) {
+      freeFixedLayout(&layout);
+      return result;
+    }
   }
 
   /*
@@ -116,6 +198,105 @@ static int makeVDOFixedLayout(BlockCount            physicalBlocks,
   return VDO_SUCCESS;
 }
 
+/**
+ * Make the fixed layout of an external metadata device. The recovery journal
+ * always goes on the external device, followed by the slab summary and the
+ * block map tier if the config requests them.
+ *
+ * @param [in]  external       The placement of metadata on the device
+ * @param [in]  journalBlocks  The size of the journal partition
+ * @param [in]  summaryBlocks  The size of the slab summary partition
+ * @param [out] layoutPtr      A pointer to hold the new FixedLayout
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+__attribute__((warn_unused_result))
+static int makeExternalFixedLayout(const ExternalMetadataConfig  *external,
+                                   BlockCount                     journalBlocks,
+                                   BlockCount                     summaryBlocks,
+                                   FixedLayout                  **layoutPtr)
+{
+  if (external->blockCount > MAXIMUM_EXTERNAL_METADATA_BLOCKS) {
+    return logErrorWithStringError(VDO_OUT_OF_RANGE, "external metadata"
+                                   " device size %" PRIu64 " exceeds the"
+                                   " maximum of %" PRIu64 " blocks",
+                                   external->blockCount,
+                                   MAXIMUM_EXTERNAL_METADATA_BLOCKS);
+  }
+
+  BlockCount necessarySize = (EXTERNAL_LABEL_BLOCKS + journalBlocks
+                              + (external->slabSummary ? summaryBlocks : 0)
+                              + external->blockMapTierBlocks);
+  if (necessarySize > external->blockCount) {
+    return logErrorWithStringError(VDO_NO_SPACE, "Not enough space on the"
+                                   " external metadata device");
+  }
+
+  FixedLayout *layout;
+  int result = makeFixedLayout(external->blockCount - EXTERNAL_LABEL_BLOCKS,
+                               EXTERNAL_METADATA_ORIGIN + EXTERNAL_LABEL_BLOCKS,
+                               &layout);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  result = makeFixedLayoutPartition(layout, RECOVERY_JOURNAL_PARTITION,
+                                    journalBlocks, FROM_BEGINNING, 0);
+  if (result != VDO_SUCCESS) {
+    freeFixedLayout(&layout);
+    return result;
+  }
+
+  if (external->slabSummary) {
+    result = makeFixedLayoutPartition(layout, SLAB_SUMMARY_PARTITION,
+                                      summaryBlocks, FROM_BEGINNING, 0);
+    if (result != VDO_SUCCESS) {
+      freeFixedLayout(&layout);
+      return result;
+    }
+  }
+
+  if (external->blockMapTierBlocks > 0) {
+    result = makeFixedLayoutPartition(layout, BLOCK_MAP_TIER_PARTITION,
+                                      external->blockMapTierBlocks,
+                                      FROM_BEGINNING, 0);
+    if (result != VDO_SUCCESS) {
+      freeFixedLayout(&layout);
+      return result;
+    }
+  }
+
+  *layoutPtr = layout;
+  return VDO_SUCCESS;
+}
+
+/**
+ * Find a partition of a VDOLayout, looking first in the specified FixedLayout
+ * and then on the external metadata device, which does not change when the
+ * VDO grows.
+ *
+ * @param [in]  vdoLayout     The VDOLayout
+ * @param [in]  layout        The FixedLayout to search first
+ * @param [in]  id            The ID of the partition to find
+ * @param [out] partitionPtr  A pointer to hold the partition
+ *
+ * @return VDO_SUCCESS or VDO_UNKNOWN_PARTITION
+ **/
+__attribute__((warn_unused_result))
+static int findPartition(const VDOLayout  *vdoLayout,
+                         FixedLayout      *layout,
+                         PartitionID       id,
+                         Partition       **partitionPtr)
+{
+  int result = getPartition(layout, id, partitionPtr);
+  if ((result != VDO_UNKNOWN_PARTITION)
+      || (vdoLayout->externalLayout == NULL)) {
+    return result;
+  }
+
+  return getPartition(vdoLayout->externalLayout, id, partitionPtr);
+}
+
 /**
  * Get the offset of a given partition.
  *
@@ -131,13 +312,35 @@ static BlockCount getPartitionOffset(VDOLayout   *layout,
   return getFixedLayoutPartitionOffset(getVDOPartition(layout, partitionID));
 }
 
+/**
+ * Check that the physical space of a VDO with an external metadata device
+ * does not reach the PBNs at which the external device is addressed.
+ *
+ * @param physicalBlocks  The number of physical blocks in the VDO
+ *
+ * @return VDO_SUCCESS or VDO_OUT_OF_RANGE
+ **/
+__attribute__((warn_unused_result))
+static int validateExternalAddressSpace(BlockCount physicalBlocks)
+{
+  if (physicalBlocks > EXTERNAL_METADATA_ORIGIN) {
+    return logErrorWithStringError(VDO_OUT_OF_RANGE, "a VDO with an external"
+                                   " metadata device may have at most %"
+                                   PRIu64 " physical blocks",
+                                   EXTERNAL_METADATA_ORIGIN);
+  }
+
+  return VDO_SUCCESS;
+}
+
 /**********************************************************************/
-int makeVDOLayout(BlockCount            physicalBlocks,
-                  PhysicalBlockNumber   startingOffset,
-                  BlockCount            blockMapBlocks,
-                  BlockCount            journalBlocks,
-                  BlockCount            summaryBlocks,
-                  VDOLayout           **vdoLayoutPtr)
+int makeVDOLayout(BlockCount                     physicalBlocks,
+                  PhysicalBlockNumber            startingOffset,
+                  BlockCount                     blockMapBlocks,
+                  BlockCount                     journalBlocks,
+                  BlockCount                     summaryBlocks,
+                  const ExternalMetadataConfig  *external,
+                  VDOLayout                    **vdoLayoutPtr)
 {
   VDOLayout *vdoLayout;
   int result = ALLOCATE(1, VDOLayout, __func__, &vdoLayout);
@@ -145,19 +348,124 @@ int makeVDOLayout(BlockCount            physicalBlocks,
     return result;
   }
 
+  bool externalJournal = ((external != NULL) && (external->blockCount > 0));
+  bool externalSummary = (externalJournal && external->slabSummary);
+  if (externalJournal) {
+    result = validateExternalAddressSpace(physicalBlocks);
+    if (result != VDO_SUCCESS) {
+      freeVDOLayout(&vdoLayout);
+      return result;
+    }
+  }
+
   result = makeVDOFixedLayout(physicalBlocks, startingOffset, blockMapBlocks,
-                              journalBlocks, summaryBlocks, &vdoLayout->layout);
+                              (externalJournal ? 0 : journalBlocks),
+                              (externalSummary ? 0 : summaryBlocks),
+                              &vdoLayout->layout);
   if (result != VDO_SUCCESS) {
     freeVDOLayout(&vdoLayout);
     return result;
   }
 
+  if (externalJournal) {
+    result = makeExternalFixedLayout(external, journalBlocks, summaryBlocks,
+                                     &vdoLayout->externalLayout);
+    if (result != VDO_SUCCESS) {
+      freeVDOLayout(&vdoLayout);
+      return result;
+    }
+  }
+
   vdoLayout->startingOffset = startingOffset;
 
   *vdoLayoutPtr = vdoLayout;
   return VDO_SUCCESS;
 }
 
+/**
+ * Decode the layout of the external metadata device, if the VDOLayout has
+ * one. Layouts without an external device are encoded exactly as they were
+ * before external devices existed, so the absence of the external layout
+ * header is not an error.
+ *
+ * @param buffer     A buffer positioned just after the encoded FixedLayout
+ * @param vdoLayout  The VDOLayout being decoded
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+__attribute__((warn_unused_result))
+static int decodeExternalLayout(Buffer *buffer, VDOLayout *vdoLayout)
+{
+  if (contentLength(buffer) < ENCODED_HEADER_SIZE) {
+    return VDO_SUCCESS;
+  }
+
+  Header header;
+  int result = decodeHeader(buffer, &header);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  if (header.id != EXTERNAL_LAYOUT) {
+    // This is the header of the next component.
+    return rewindBuffer(buffer, ENCODED_HEADER_SIZE);
+  }
+
+  if (areSameVersion(EXTERNAL_LAYOUT_HEADER_1_0.version, header.version)) {
+    result = validateHeader(&EXTERNAL_LAYOUT_HEADER_1_0, &header, false,
+                            __func__);
+    if (result != VDO_SUCCESS) {
+      return result;
+    }
+
+    return decodeFixedLayout(buffer, &vdoLayout->externalLayout);
+  }
+
+  bool hasTier = areSameVersion(EXTERNAL_LAYOUT_HEADER_3_0.version,
+                                header.version);
+  result = validateHeader((hasTier
+                           ? &EXTERNAL_LAYOUT_HEADER_3_0
+                           : &EXTERNAL_LAYOUT_HEADER_2_0),
+                          &header, true, __func__);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  BlockCount blockCount;
+  result = getUInt64LEFromBuffer(buffer, &blockCount);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  BlockCount journalBlocks;
+  result = getUInt64LEFromBuffer(buffer, &journalBlocks);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  BlockCount summaryBlocks;
+  result = getUInt64LEFromBuffer(buffer, &summaryBlocks);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  BlockCount blockMapTierBlocks = 0;
+  if (hasTier) {
+    result = getUInt64LEFromBuffer(buffer, &blockMapTierBlocks);
+    if (result != UDS_SUCCESS) {
+      return result;
+    }
+  }
+
+  ExternalMetadataConfig external = {
+    .blockCount         = blockCount,
+    .slabSummary        = (summaryBlocks > 0),
+    .blockMapTierBlocks = blockMapTierBlocks,
+  };
+  return makeExternalFixedLayout(&external, journalBlocks, summaryBlocks,
+                                 &vdoLayout->externalLayout);
+}
+
 /**********************************************************************/
 int decodeVDOLayout(Buffer *buffer, VDOLayout **vdoLayoutPtr)
 {
@@ -173,11 +481,17 @@ int decodeVDOLayout(Buffer *buffer, VDOLayout **vdoLayoutPtr)
     return result;
   }
 
+  result = decodeExternalLayout(buffer, vdoLayout);
+  if (result != VDO_SUCCESS) {
+    freeVDOLayout(&vdoLayout);
+    return result;
+  }
+
   // Check that all the expected partitions exist
   Partition *partition;
   for (uint8_t i = 0; i < REQUIRED_PARTITION_COUNT; i++) {
-    result = getPartition(vdoLayout->layout, REQUIRED_PARTITIONS[i],
-                          &partition);
+    result = findPartition(vdoLayout, vdoLayout->layout,
+                           REQUIRED_PARTITIONS[i], &partition);
     if (result != VDO_SUCCESS) {
       freeVDOLayout(&vdoLayout);
       return logErrorWithStringError(result,
@@ -206,24 +520,28 @@ void freeVDOLayout(VDOLayout **vdoLayoutPtr)
   freeFixedLayout(&vdoLayout->nextLayout);
   freeFixedLayout(&vdoLayout->layout);
   freeFixedLayout(&vdoLayout->previousLayout);
+  freeFixedLayout(&vdoLayout->externalLayout);
   FREE(vdoLayout);
   *vdoLayoutPtr = NULL;
 }
 
 /**
- * Get a partition from a FixedLayout in conditions where we expect that it can
- * not fail.
+ * Get a partition from a FixedLayout (or the external metadata device) in
+ * conditions where we expect that it can not fail.
  *
- * @param layout  The FixedLayout from which to get the partition
- * @param id      The ID of the partition to retrieve
+ * @param vdoLayout  The VDOLayout containing the FixedLayout
+ * @param layout     The FixedLayout from which to get the partition
+ * @param id         The ID of the partition to retrieve
  *
  * @return The desired partition
  **/
 __attribute__((warn_unused_result))
-static Partition *retrievePartition(FixedLayout *layout, PartitionID id)
+static Partition *retrievePartition(VDOLayout   *vdoLayout,
+                                    FixedLayout *layout,
+                                    PartitionID  id)
 {
   Partition *partition;
-  int result = getPartition(layout, id, &partition);
+  int result = findPartition(vdoLayout, layout, id, &partition);
   ASSERT_LOG_ONLY(result == VDO_SUCCESS, "VDOLayout has expected partition");
   return partition;
 }
@@ -231,7 +549,211 @@ static Partition *retrievePartition(FixedLayout *layout, PartitionID id)
 /**********************************************************************/
 Partition *getVDOPartition(VDOLayout *vdoLayout, PartitionID id)
 {
-  return retrievePartition(vdoLayout->layout, id);
+  return retrievePartition(vdoLayout, vdoLayout->layout, id);
+}
+
+/**********************************************************************/
+bool hasExternalMetadata(const VDOLayout *vdoLayout)
+{
+  return (vdoLayout->externalLayout != NULL);
+}
+
+/**********************************************************************/
+bool isExternalPartition(const VDOLayout *vdoLayout, PartitionID id)
+{
+  return (hasExternalMetadata(vdoLayout)
+          && (getPartition(vdoLayout->externalLayout, id, NULL)
+              == VDO_SUCCESS));
+}
+
+/**********************************************************************/
+BlockCount getExternalMetadataSize(const VDOLayout *vdoLayout)
+{
+  if (!hasExternalMetadata(vdoLayout)) {
+    return 0;
+  }
+
+  return (getTotalFixedLayoutSize(vdoLayout->externalLayout)
+          + EXTERNAL_LABEL_BLOCKS);
+}
+
+/**
+ * Allocate a block-size buffer for the label of an external metadata device
+ * and wrap it in a Buffer.
+ *
+ * @param [in]  layer          The layer which will read or write the label
+ * @param [in]  contentLength  The initial content length of the Buffer
+ * @param [out] blockPtr       A pointer to hold the block
+ * @param [out] bufferPtr      A pointer to hold the Buffer wrapping the block
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+__attribute__((warn_unused_result))
+static int makeLabelBuffer(PhysicalLayer  *layer,
+                           size_t          contentLength,
+                           char          **blockPtr,
+                           Buffer        **bufferPtr)
+{
+  char *block;
+  int result = layer->allocateIOBuffer(layer, VDO_BLOCK_SIZE,
+                                       "external metadata label", &block);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  result = wrapBuffer((byte *) block, VDO_BLOCK_SIZE, contentLength,
+                      bufferPtr);
+  if (result != UDS_SUCCESS) {
+    FREE(block);
+    return result;
+  }
+
+  *blockPtr = block;
+  return VDO_SUCCESS;
+}
+
+/**
+ * Encode the label of an external metadata device.
+ *
+ * @param nonce       The nonce of the VDO
+ * @param blockCount  The size of the external device
+ * @param buffer      A buffer positioned at the start of the label
+ *
+ * @return UDS_SUCCESS or an error
+ **/
+__attribute__((warn_unused_result))
+static int encodeExternalLabel(Nonce       nonce,
+                               BlockCount  blockCount,
+                               Buffer     *buffer)
+{
+  int result = encodeHeader(&EXTERNAL_LABEL_HEADER_1_0, buffer);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  result = putUInt64LEIntoBuffer(buffer, nonce);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  return putUInt64LEIntoBuffer(buffer, blockCount);
+}
+
+/**********************************************************************/
+int writeExternalMetadataLabel(PhysicalLayer   *layer,
+                               const VDOLayout *vdoLayout,
+                               Nonce            nonce)
+{
+  int result = ASSERT(hasExternalMetadata(vdoLayout),
+                      "VDO layout has an external metadata device");
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  char   *block;
+  Buffer *buffer;
+  result = makeLabelBuffer(layer, 0, &block, &buffer);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  result = encodeExternalLabel(nonce, getExternalMetadataSize(vdoLayout),
+                               buffer);
+  freeBuffer(&buffer);
+  if (result != UDS_SUCCESS) {
+    FREE(block);
+    return result;
+  }
+
+  result = layer->writer(layer, EXTERNAL_METADATA_ORIGIN, 1, block, NULL);
+  FREE(block);
+  return result;
+}
+
+/**
+ * Decode the label of an external metadata device.
+ *
+ * @param [in]  buffer         A buffer positioned at the start of the label
+ * @param [out] noncePtr       A pointer to hold the nonce of the VDO
+ * @param [out] blockCountPtr  A pointer to hold the size of the device
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+__attribute__((warn_unused_result))
+static int decodeExternalLabel(Buffer     *buffer,
+                               Nonce      *noncePtr,
+                               BlockCount *blockCountPtr)
+{
+  Header header;
+  int result = decodeHeader(buffer, &header);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  result = validateHeader(&EXTERNAL_LABEL_HEADER_1_0, &header, true,
+                          __func__);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  result = getUInt64LEFromBuffer(buffer, noncePtr);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  return getUInt64LEFromBuffer(buffer, blockCountPtr);
+}
+
+/**********************************************************************/
+int validateExternalMetadataLabel(PhysicalLayer   *layer,
+                                  const VDOLayout *vdoLayout,
+                                  Nonce            nonce)
+{
+  int result = ASSERT(hasExternalMetadata(vdoLayout),
+                      "VDO layout has an external metadata device");
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  char   *block;
+  Buffer *buffer;
+  result = makeLabelBuffer(layer, VDO_BLOCK_SIZE, &block, &buffer);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  result = layer->reader(layer, EXTERNAL_METADATA_ORIGIN, 1, block, NULL);
+  if (result != VDO_SUCCESS) {
+    freeBuffer(&buffer);
+    FREE(block);
+    return logErrorWithStringError(result, "cannot read external metadata"
+                                   " device label");
+  }
+
+  Nonce      labelNonce;
+  BlockCount labelBlockCount;
+  result = decodeExternalLabel(buffer, &labelNonce, &labelBlockCount);
+  freeBuffer(&buffer);
+  FREE(block);
+  if (result != VDO_SUCCESS) {
+    return logErrorWithStringError(result, "invalid external metadata"
+                                   " device label");
+  }
+
+  if (labelNonce != nonce) {
+    return logErrorWithStringError(VDO_BAD_NONCE, "external metadata device"
+                                   " belongs to a different VDO");
+  }
+
+  if (labelBlockCount != getExternalMetadataSize(vdoLayout)) {
+    return logErrorWithStringError(VDO_PARAMETER_MISMATCH,
+                                   "external metadata device size %" PRIu64
+                                   " does not match the VDO layout size %"
+                                   PRIu64, labelBlockCount,
+                                   getExternalMetadataSize(vdoLayout));
+  }
+
+  return VDO_SUCCESS;
 }
 
 /**
@@ -249,7 +771,7 @@ static Partition *getPartitionFromNextLayout(VDOLayout   *vdoLayout,
 {
   ASSERT_LOG_ONLY(vdoLayout->nextLayout != NULL,
                   "VDOLayout is prepared to grow");
-  return retrievePartition(vdoLayout->nextLayout, id);
+  return retrievePartition(vdoLayout, vdoLayout->nextLayout, id);
 }
 
 /**
@@ -266,6 +788,23 @@ static BlockCount getPartitionSize(VDOLayout *layout, PartitionID partitionID)
   return getFixedLayoutPartitionSize(getVDOPartition(layout, partitionID));
 }
 
+/**
+ * Get the size of a given partition on the VDO's own device.
+ *
+ * @param layout       The layout containing the partition
+ * @param partitionID  The partition ID whose size to find
+ *
+ * @return The size of the partition (in blocks), or 0 if the partition is on
+ *         the external metadata device
+ **/
+__attribute__((warn_unused_result))
+static BlockCount getInternalPartitionSize(VDOLayout   *layout,
+                                           PartitionID  partitionID)
+{
+  return (isExternalPartition(layout, partitionID)
+          ? 0 : getPartitionSize(layout, partitionID));
+}
+
 /**********************************************************************/
 int prepareToGrowVDOLayout(VDOLayout     *vdoLayout,
                            BlockCount     oldPhysicalBlocks,
@@ -277,6 +816,13 @@ int prepareToGrowVDOLayout(VDOLayout     *vdoLayout,
     return VDO_SUCCESS;
   }
 
+  if (hasExternalMetadata(vdoLayout)) {
+    int result = validateExternalAddressSpace(newPhysicalBlocks);
+    if (result != VDO_SUCCESS) {
+      return result;
+    }
+  }
+
   // Make a copy completion if there isn't one
   if (vdoLayout->copyCompletion == NULL) {
     int result = makeCopyCompletion(layer, &vdoLayout->copyCompletion);
@@ -289,15 +835,17 @@ int prepareToGrowVDOLayout(VDOLayout     *vdoLayout,
   freeFixedLayout(&vdoLayout->nextLayout);
 
   // Make a new layout with the existing partition sizes for everything but the
-  // block allocator partition.
+  // block allocator partition. Partitions on the external metadata device
+  // stay where they are.
+  BlockCount journalBlocks
+    = getInternalPartitionSize(vdoLayout, RECOVERY_JOURNAL_PARTITION);
+  BlockCount summaryBlocks
+    = getInternalPartitionSize(vdoLayout, SLAB_SUMMARY_PARTITION);
   int result = makeVDOFixedLayout(newPhysicalBlocks,
                                   vdoLayout->startingOffset,
                                   getPartitionSize(vdoLayout,
                                                    BLOCK_MAP_PARTITION),
-                                  getPartitionSize(vdoLayout,
-                                                   RECOVERY_JOURNAL_PARTITION),
-                                  getPartitionSize(vdoLayout,
-                                                   SLAB_SUMMARY_PARTITION),
+                                  journalBlocks, summaryBlocks,
                                   &vdoLayout->nextLayout);
   if (result != VDO_SUCCESS) {
     freeCopyCompletion(&vdoLayout->copyCompletion);
@@ -305,14 +853,7 @@ int prepareToGrowVDOLayout(VDOLayout     *vdoLayout,
   }
 
   // Ensure the new journal and summary are entirely within the added blocks.
-  Partition *slabSummaryPartition
-    = getPartitionFromNextLayout(vdoLayout, SLAB_SUMMARY_PARTITION);
-  Partition *recoveryJournalPartition
-    = getPartitionFromNextLayout(vdoLayout, RECOVERY_JOURNAL_PARTITION);
-  BlockCount minNewSize
-    = (oldPhysicalBlocks
-       + getFixedLayoutPartitionSize(slabSummaryPartition)
-       + getFixedLayoutPartitionSize(recoveryJournalPartition));
+  BlockCount minNewSize = oldPhysicalBlocks + summaryBlocks + journalBlocks;
   if (minNewSize > newPhysicalBlocks) {
     // Copying the journal and summary would destroy some old metadata.
     freeFixedLayout(&vdoLayout->nextLayout);
@@ -404,6 +945,11 @@ void copyPartition(VDOLayout     *layout,
                    PartitionID    partitionID,
                    VDOCompletion *parent)
 {
+  if (isExternalPartition(layout, partitionID)) {
+    finishCompletion(parent, VDO_SUCCESS);
+    return;
+  }
+
   copyPartitionAsync(layout->copyCompletion,
                      getVDOPartition(layout, partitionID),
                      getPartitionFromNextLayout(layout, partitionID), parent);
@@ -412,12 +958,73 @@ void copyPartition(VDOLayout     *layout,
 /**********************************************************************/
 size_t getVDOLayoutEncodedSize(const VDOLayout *vdoLayout)
 {
-  return getFixedLayoutEncodedSize(vdoLayout->layout);
+  size_t size = getFixedLayoutEncodedSize(vdoLayout->layout);
+  if (hasExternalMetadata(vdoLayout)) {
+    size += ENCODED_HEADER_SIZE + sizeof(ExternalLayout3_0);
+  }
+
+  return size;
+}
+
+/**
+ * Get the size of a partition of the external metadata device.
+ *
+ * @param layout  The FixedLayout of the external device
+ * @param id      The ID of the partition
+ *
+ * @return The size of the partition, or 0 if the device does not have it
+ **/
+__attribute__((warn_unused_result))
+static BlockCount getExternalPartitionSize(FixedLayout *layout,
+                                           PartitionID  id)
+{
+  Partition *partition;
+  if (getPartition(layout, id, &partition) != VDO_SUCCESS) {
+    return 0;
+  }
+
+  return getFixedLayoutPartitionSize(partition);
 }
 
 /**********************************************************************/
 int encodeVDOLayout(const VDOLayout *vdoLayout, Buffer *buffer)
 {
-  return encodeFixedLayout(vdoLayout->layout, buffer);
+  int result = encodeFixedLayout(vdoLayout->layout, buffer);
+  if ((result != UDS_SUCCESS) || !hasExternalMetadata(vdoLayout)) {
+    return result;
+  }
+
+  result = encodeHeader(&EXTERNAL_LAYOUT_HEADER_3_0, buffer);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  FixedLayout       *layout  = vdoLayout->externalLayout;
+  ExternalLayout3_0  encoded = {
+    .blockCount         = getExternalMetadataSize(vdoLayout),
+    .journalBlocks      = getExternalPartitionSize(layout,
+                                                   RECOVERY_JOURNAL_PARTITION),
+    .summaryBlocks      = getExternalPartitionSize(layout,
+                                                   SLAB_SUMMARY_PARTITION),
+    .blockMapTierBlocks = getExternalPartitionSize(layout,
+                                                   BLOCK_MAP_TIER_PARTITION),
+  };
+
+  result = putUInt64LEIntoBuffer(buffer, encoded.blockCount);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  result = putUInt64LEIntoBuffer(buffer, encoded.journalBlocks);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  result = putUInt64LEIntoBuffer(buffer, encoded.summaryBlocks);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  return putUInt64LEIntoBuffer(buffer, encoded.blockMapTierBlocks);
 }
 
@@ -29,14 +29,33 @@
  *
  * The VDOLayout also manages the preparation and growth of the layout for grow
  * physical operations.
+ *
+ * The recovery journal, and optionally the slab summary, may be placed on an
+ * external metadata device. The layer maps that device into its block address
+ * space starting at EXTERNAL_METADATA_ORIGIN, so the partitions on it are
+ * addressed like any other partition. The first block of the external device
+ * holds a label identifying the VDO to which it belongs.
  **/
 
 #ifndef VDO_LAYOUT_H
 #define VDO_LAYOUT_H
 
 #include "fixedLayout.h"
+#include "physicalLayer.h"
 #include "types.h"
 
+/**
+ * The placement of metadata on an external metadata device.
+ **/
+typedef struct {
+  /** The size of the external device in blocks (0 if there is none) */
+  BlockCount blockCount;
+  /** Whether the slab summary is also on the external device */
+  bool       slabSummary;
+  /** The number of blocks reserved for block map tree pages (0 for none) */
+  BlockCount blockMapTierBlocks;
+} ExternalMetadataConfig;
+
 /**
  * Make a VDO layout with the specified parameters.
  *
@@ -45,16 +64,19 @@
  * @param [in]  blockMapBlocks  The size of the block map partition
  * @param [in]  journalBlocks   The size of the journal partition
  * @param [in]  summaryBlocks   The size of the slab summary partition
+ * @param [in]  external        The placement of metadata on an external
+ *                              device (may be NULL if there is none)
  * @param [out] vdoLayoutPtr    A pointer to hold the new VDOLayout
  *
  * @return VDO_SUCCESS or an error
  **/
-int makeVDOLayout(BlockCount            physicalBlocks,
-                  PhysicalBlockNumber   startingOffset,
-                  BlockCount            blockMapBlocks,
-                  BlockCount            journalBlocks,
-                  BlockCount            summaryBlocks,
-                  VDOLayout           **vdoLayoutPtr)
+int makeVDOLayout(BlockCount                     physicalBlocks,
+                  PhysicalBlockNumber            startingOffset,
+                  BlockCount                     blockMapBlocks,
+                  BlockCount                     journalBlocks,
+                  BlockCount                     summaryBlocks,
+                  const ExternalMetadataConfig  *external,
+                  VDOLayout                    **vdoLayoutPtr)
   __attribute__((warn_unused_result));
 
 /**
@@ -87,6 +109,69 @@ void freeVDOLayout(VDOLayout **vdoLayoutPtr);
 Partition *getVDOPartition(VDOLayout *vdoLayout, PartitionID id)
   __attribute__((warn_unused_result));
 
+/**
+ * Check whether a VDOLayout places any partitions on an external metadata
+ * device.
+ *
+ * @param vdoLayout  The layout to check
+ *
+ * @return <code>true</code> if the layout has an external metadata device
+ **/
+bool hasExternalMetadata(const VDOLayout *vdoLayout)
+  __attribute__((warn_unused_result));
+
+/**
+ * Check whether a partition of a VDOLayout is on the external metadata device.
+ *
+ * @param vdoLayout  The layout containing the partition
+ * @param id         The ID of the partition
+ *
+ * @return <code>true</code> if the partition is on the external device
+ **/
+bool isExternalPartition(const VDOLayout *vdoLayout, PartitionID id)
+  __attribute__((warn_unused_result));
+
+/**
+ * Get the size of the external metadata device of a VDOLayout.
+ *
+ * @param vdoLayout  The layout
+ *
+ * @return The size of the external device in blocks, or 0 if there is none
+ **/
+BlockCount getExternalMetadataSize(const VDOLayout *vdoLayout)
+  __attribute__((warn_unused_result));
+
+/**
+ * Write the label which identifies an external metadata device as belonging
+ * to a particular VDO. This function uses the synchronous writer of the layer.
+ *
+ * @param layer      The layer to which the external device is attached
+ * @param vdoLayout  The layout of the VDO, which must have an external device
+ * @param nonce      The nonce of the VDO
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+int writeExternalMetadataLabel(PhysicalLayer   *layer,
+                               const VDOLayout *vdoLayout,
+                               Nonce            nonce)
+  __attribute__((warn_unused_result));
+
+/**
+ * Check that the external metadata device attached to a layer is the one
+ * recorded in a VDOLayout. This function uses the synchronous reader of the
+ * layer.
+ *
+ * @param layer      The layer to which the external device is attached
+ * @param vdoLayout  The layout of the VDO, which must have an external device
+ * @param nonce      The nonce of the VDO
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+int validateExternalMetadataLabel(PhysicalLayer   *layer,
+                                  const VDOLayout *vdoLayout,
+                                  Nonce            nonce)
+  __attribute__((warn_unused_result));
+
 /**
  * Prepare the layout to be grown.
  *
@@ -154,7 +239,8 @@ void finishVDOLayoutGrowth(VDOLayout *vdoLayout);
 
 /**
  * Copy a partition from the location specified in the current layout to that in
- * the next layout.
+ * the next layout. A partition on the external metadata device does not move,
+ * so the parent is notified immediately.
  *
  * @param layout       The VDOLayout which is prepared to grow
  * @param partitionID  The ID of the partition to copy
@@ -36,6 +36,8 @@ struct vdoLayout {
   PhysicalBlockNumber  startingOffset;
   // A pointer to the copy completion (if there is one)
   VDOCompletion       *copyCompletion;
+  // The layout of the external metadata device (if there is one)
+  FixedLayout         *externalLayout;
 };
 
 #endif // VDO_LAYOUT_INTERNALS_H
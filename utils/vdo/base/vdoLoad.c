@@ -26,6 +26,7 @@
 
 #include "adminCompletion.h"
 #include "blockMap.h"
+#include "blockMapEntry.h"
 #include "completion.h"
 #include "constants.h"
 #include "hashZone.h"
@@ -40,6 +41,7 @@
 #include "threadConfig.h"
 #include "types.h"
 #include "vdoInternal.h"
+#include "vdoLayout.h"
 #include "vdoRecovery.h"
 #include "volumeGeometry.h"
 
@@ -352,12 +354,36 @@ static int finishVDODecode(VDO *vdo)
     return result;
   }
 
+  setSlabJournalBatching(vdo->depot, vdo->loadConfig.batchSlabJournalEntries);
+  setReferenceUpdateCoalescing(vdo->depot,
+                               vdo->loadConfig.coalesceReferenceUpdates);
+  setSlabDepotVIOPoolGrowth(vdo->depot, vdo->loadConfig.vioPoolGrowthFactor);
+
   result = decodeBlockMap(buffer, vdo->config.logicalBlocks, threadConfig,
                           &vdo->blockMap);
   if (result != VDO_SUCCESS) {
     return result;
   }
 
+  if (isExternalPartition(vdo->layout, BLOCK_MAP_TIER_PARTITION)) {
+    Partition *tier = getVDOPartition(vdo->layout, BLOCK_MAP_TIER_PARTITION);
+    PhysicalBlockNumber origin = getFixedLayoutPartitionOffset(tier);
+    BlockCount          size   = getFixedLayoutPartitionSize(tier);
+
+    // Tier page PBNs are stored in block map and journal entries, so the
+    // whole tier must survive packing into them.
+    PhysicalBlockNumber last   = origin + size - 1;
+    BlockMapEntry       packed = packPBN(last, MAPPING_STATE_UNCOMPRESSED);
+    if (unpackBlockMapEntry(&packed).pbn != last) {
+      return logErrorWithStringError(VDO_OUT_OF_RANGE, "block map tier PBN %"
+                                     PRIu64 " is not representable in a"
+                                     " block map entry", last);
+    }
+
+    setBlockMapTier(vdo->blockMap, origin, size);
+    setRecoveryJournalBlockMapTier(vdo->recoveryJournal, origin, size);
+  }
+
   ASSERT_LOG_ONLY((contentLength(buffer) == 0),
                   "All decoded component data was used");
   return VDO_SUCCESS;
@@ -424,6 +450,8 @@ static int decodeVDO(VDO *vdo, bool validateConfig)
     return result;
   }
 
+  setBlockMapVIOPoolGrowth(vdo->blockMap, vdo->loadConfig.vioPoolGrowthFactor);
+
   result = ALLOCATE(threadConfig->hashZoneCount, HashZone *, __func__,
                     &vdo->hashZones);
   if (result != VDO_SUCCESS) {
@@ -456,7 +484,10 @@ static int decodeVDO(VDO *vdo, bool validateConfig)
   }
 
   return makePacker(vdo->layer, DEFAULT_PACKER_INPUT_BINS,
-                    DEFAULT_PACKER_OUTPUT_BINS, threadConfig, &vdo->packer);
+                    DEFAULT_PACKER_OUTPUT_BINS,
+                    vdo->loadConfig.maxPackerResidency,
+                    vdo->loadConfig.packSequentialRuns, threadConfig,
+                    &vdo->packer);
 }
 
 /**
@@ -540,6 +571,15 @@ int loadVDOSuperblock(PhysicalLayer   *layer,
     return result;
   }
 
+  if (validateConfig && (vdo->layout != NULL)
+      && hasExternalMetadata(vdo->layout)) {
+    result = validateExternalMetadataLabel(layer, vdo->layout, vdo->nonce);
+    if (result != VDO_SUCCESS) {
+      freeVDO(&vdo);
+      return result;
+    }
+  }
+
   *vdoPtr = vdo;
   return VDO_SUCCESS;
 
@@ -59,7 +59,8 @@ int prepareToLoadVDO(VDO *vdo, const VDOLoadConfig *loadConfig)
 
 /**
  * Synchronously load a VDO from a specified super block location for use by
- * user-space tools.
+ * user-space tools. If the config is validated and the VDO has an external
+ * metadata device, the device attached to the layer is validated as well.
  *
  * @param [in]  layer           The physical layer the VDO sits on
  * @param [in]  geometry        A pointer to the geometry for the volume
@@ -43,60 +43,238 @@ enum {
   DISPLAY_INTERVAL            = 100000,
 };
 
-/**********************************************************************/
-static char *getPageBuffer(PageInfo *info)
+/** The multiplier for Fibonacci hashing of page numbers (2^64 / phi) */
+static const uint64_t PAGE_TABLE_MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+
+/**
+ * Get the number of slots in a cache's page table.
+ *
+ * @param cache  The cache
+ *
+ * @return The number of slots in the page table
+ **/
+static inline size_t getPageTableSize(const VDOPageCache *cache)
 {
-  VDOPageCache *cache = info->cache;
-  return &cache->pages[(info - cache->infos) * VDO_BLOCK_SIZE];
+  return ((size_t) 1) << (64 - cache->pageTableShift);
 }
 
 /**
- * Allocate components of the cache which require their own allocation. The
- * caller is responsible for all clean up on errors.
+ * Get the slot at which the search for a page begins in a cache's page table.
+ * Block map pages are allocated from slabs in runs, so multiplicative hashing
+ * spreads dense runs of page numbers across the table.
  *
- * @param cache     The cache being constructed
+ * @param cache  The cache
+ * @param pbn    The page number
  *
- * @return VDO_SUCCESS or an error code
+ * @return The index of the home slot for the page
+ **/
+static inline size_t getPageTableSlot(const VDOPageCache *cache,
+                                      PhysicalBlockNumber  pbn)
+{
+  return (size_t) ((pbn * PAGE_TABLE_MULTIPLIER) >> cache->pageTableShift);
+}
+
+/**
+ * Get the slot which follows a given slot in a cache's page table.
+ *
+ * @param cache  The cache
+ * @param slot   The slot
+ *
+ * @return The next slot, wrapping around at the end of the table
+ **/
+static inline size_t nextPageTableSlot(const VDOPageCache *cache, size_t slot)
+{
+  return (slot + 1) & (getPageTableSize(cache) - 1);
+}
+
+/**
+ * Add a mapped page to a cache's page table. The table must not already
+ * contain the page.
+ *
+ * @param cache  The cache
+ * @param info   The info of the page to add
+ **/
+static void addToPageTable(VDOPageCache *cache, PageInfo *info)
+{
+  size_t slot = getPageTableSlot(cache, info->pbn);
+  while (cache->pageTable[slot] != NULL) {
+    slot = nextPageTableSlot(cache, slot);
+  }
+  cache->pageTable[slot] = info;
+}
+
+/**
+ * Remove a page from a cache's page table, moving back any later pages in the
+ * same run of occupied slots which could otherwise no longer be found. Pages
+ * which are not in the table, because the cache has been invalidated, are
+ * ignored.
+ *
+ * @param cache  The cache
+ * @param info   The info of the page to remove
+ **/
+static void removeFromPageTable(VDOPageCache *cache, PageInfo *info)
+{
+  size_t slot = getPageTableSlot(cache, info->pbn);
+  while (cache->pageTable[slot] != info) {
+    if (cache->pageTable[slot] == NULL) {
+      return;
+    }
+    slot = nextPageTableSlot(cache, slot);
+  }
+
+  size_t hole = slot;
+  for (slot = nextPageTableSlot(cache, slot);
+       cache->pageTable[slot] != NULL;
+       slot = nextPageTableSlot(cache, slot)) {
+    // An entry may fill the hole only if its home slot does not lie
+    // cyclically in (hole, slot].
+    size_t home = getPageTableSlot(cache, cache->pageTable[slot]->pbn);
+    size_t mask = getPageTableSize(cache) - 1;
+    if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+      cache->pageTable[hole] = cache->pageTable[slot];
+      hole = slot;
+    }
+  }
+  cache->pageTable[hole] = NULL;
+}
+
+/**
+ * Look up a page in a cache's page table.
+ *
+ * @param cache  The cache
+ * @param pbn    The page number to look up
+ *
+ * @return The info of the page or NULL if the page is not in the cache
+ **/
+static PageInfo *findInPageTable(const VDOPageCache *cache,
+                                 PhysicalBlockNumber  pbn)
+{
+  for (size_t slot = getPageTableSlot(cache, pbn);
+       cache->pageTable[slot] != NULL;
+       slot = nextPageTableSlot(cache, slot)) {
+    if (cache->pageTable[slot]->pbn == pbn) {
+      return cache->pageTable[slot];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Make sure that a cache's page table has at least twice as many slots as
+ * the cache will have pages, so that lookups stay short. If the table must
+ * grow, the pages which are currently mapped are moved to the new table.
+ *
+ * @param cache      The cache
+ * @param pageCount  The number of pages the cache will have
+ *
+ * @return VDO_SUCCESS or an error
  **/
 __attribute__((warn_unused_result))
-static int allocateCacheComponents(VDOPageCache *cache)
+static int reservePageTable(VDOPageCache *cache, PageCount pageCount)
 {
-  int result = ALLOCATE(cache->pageCount, PageInfo, "page infos",
-                        &cache->infos);
-  if (result != UDS_SUCCESS) {
-    return result;
+  unsigned int bits  = logBaseTwo(pageCount) + 2;
+  size_t       slots = ((size_t) 1) << bits;
+  if ((cache->pageTable != NULL) && (slots <= getPageTableSize(cache))) {
+    return VDO_SUCCESS;
   }
 
-  uint64_t size = cache->pageCount * (uint64_t) VDO_BLOCK_SIZE;
-  result = allocateMemory(size, VDO_BLOCK_SIZE, "cache pages", &cache->pages);
-  if (result != UDS_SUCCESS) {
+  PageInfo **table;
+  int result = ALLOCATE(slots, PageInfo *, "page cache table", &table);
+  if (result != VDO_SUCCESS) {
     return result;
   }
 
-  return makeIntMap(cache->pageCount, 0, &cache->pageMap);
+  FREE(cache->pageTable);
+  cache->pageTable      = table;
+  cache->pageTableShift = 64 - bits;
+  for (PageInfoChunk *chunk = cache->chunks; chunk != NULL;
+       chunk = chunk->next) {
+    for (PageInfo *info = chunk->infos; info < chunk->infos + chunk->count;
+         info++) {
+      if (info->pbn != NO_PAGE) {
+        addToPageTable(cache, info);
+      }
+    }
+  }
+
+  return VDO_SUCCESS;
+}
+
+/**********************************************************************/
+static char *getPageBuffer(PageInfo *info)
+{
+  PageInfoChunk *chunk = info->chunk;
+  return &chunk->pages[(info - chunk->infos) * VDO_BLOCK_SIZE];
 }
 
 /**
- * Initialize all page info structures and put them on the free list.
+ * Free a chunk of page infos along with their VIOs and page buffers.
  *
- * @param cache  The cache to initialize
+ * @param chunk  The chunk to free
+ **/
+static void freePageInfoChunk(PageInfoChunk *chunk)
+{
+  if (chunk == NULL) {
+    return;
+  }
+
+  if (chunk->infos != NULL) {
+    PageInfo *info;
+    for (info = chunk->infos; info < chunk->infos + chunk->count; ++info) {
+      freeVIO(&info->vio);
+    }
+  }
+
+  FREE(chunk->infos);
+  FREE(chunk->pages);
+  FREE(chunk);
+}
+
+/**
+ * Allocate a chunk of pages, initialize its page infos, and put them on the
+ * free list.
+ *
+ * @param cache  The cache to which to add the chunk
+ * @param count  The number of pages in the chunk
  *
  * @return VDO_SUCCESS or an error
  **/
-static int initializeInfo(VDOPageCache *cache)
+__attribute__((warn_unused_result))
+static int addPageInfoChunk(VDOPageCache *cache, PageCount count)
 {
-  initializeRing(&cache->freeList);
+  PageInfoChunk *chunk;
+  int result = ALLOCATE(1, PageInfoChunk, "page info chunk", &chunk);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  chunk->count = count;
+  result = ALLOCATE(count, PageInfo, "page infos", &chunk->infos);
+  if (result != UDS_SUCCESS) {
+    freePageInfoChunk(chunk);
+    return result;
+  }
+
+  uint64_t size = count * (uint64_t) VDO_BLOCK_SIZE;
+  result = allocateMemory(size, VDO_BLOCK_SIZE, "cache pages", &chunk->pages);
+  if (result != UDS_SUCCESS) {
+    freePageInfoChunk(chunk);
+    return result;
+  }
+
   PageInfo *info;
-  for (info = cache->infos; info < cache->infos + cache->pageCount; ++info) {
+  for (info = chunk->infos; info < chunk->infos + count; ++info) {
     info->cache = cache;
+    info->chunk = chunk;
     info->state = PS_FREE;
     info->pbn   = NO_PAGE;
 
     if (cache->layer->createMetadataVIO != NULL) {
-      int result = createVIO(cache->layer, VIO_TYPE_BLOCK_MAP,
-                             VIO_PRIORITY_METADATA, info, getPageBuffer(info),
-                             &info->vio);
+      result = createVIO(cache->layer, VIO_TYPE_BLOCK_MAP,
+                         VIO_PRIORITY_METADATA, info, getPageBuffer(info),
+                         &info->vio);
       if (result != VDO_SUCCESS) {
+        freePageInfoChunk(chunk);
         return result;
       }
 
@@ -105,11 +283,47 @@ static int initializeInfo(VDOPageCache *cache)
     }
 
     initializeRing(&info->listNode);
-    pushRingNode(&cache->freeList, &info->listNode);
     initializeRing(&info->lruNode);
   }
 
-  relaxedStore64(&cache->stats.counts.freePages, cache->pageCount);
+  // Nothing can fail from here on, so make the new pages available.
+  for (info = chunk->infos; info < chunk->infos + count; ++info) {
+    pushRingNode(&cache->freeList, &info->listNode);
+  }
+
+  chunk->next       = cache->chunks;
+  cache->chunks     = chunk;
+  cache->pageCount += count;
+  relaxedAdd64(&cache->stats.counts.freePages, count);
+  return VDO_SUCCESS;
+}
+
+/**
+ * Add pages to the cache, a chunk at a time.
+ *
+ * @param cache  The cache to grow
+ * @param count  The number of pages to add
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+__attribute__((warn_unused_result))
+static int addPages(VDOPageCache *cache, PageCount count)
+{
+  int result = reservePageTable(cache, cache->pageCount + count);
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  while (count > 0) {
+    PageCount chunkSize = minPageCount(count, MAX_PAGE_INFO_CHUNK_SIZE);
+    int result = addPageInfoChunk(cache, chunkSize);
+    if (result != VDO_SUCCESS) {
+      return result;
+    }
+
+    count -= chunkSize;
+  }
+
   return VDO_SUCCESS;
 }
 
@@ -140,18 +354,24 @@ int makeVDOPageCache(PhysicalLayer         *layer,
   }
 
   cache->layer            = layer;
-  cache->pageCount        = pageCount;
   cache->readHook         = readHook;
   cache->writeHook        = writeHook;
   cache->zone             = zone;
 
-  result = allocateCacheComponents(cache);
+  // initialize empty circular queues
+  initializeRing(&cache->freeList);
+  initializeRing(&cache->lruList);
+  initializeRing(&cache->outgoingList);
+
+  result = initializeEnqueueableCompletion(&cache->reaper,
+                                           PAGE_CACHE_REAPER_COMPLETION,
+                                           layer);
   if (result != VDO_SUCCESS) {
     freeVDOPageCache(&cache);
     return result;
   }
 
-  result = initializeInfo(cache);
+  result = addPages(cache, pageCount);
   if (result != VDO_SUCCESS) {
     freeVDOPageCache(&cache);
     return result;
@@ -164,10 +384,6 @@ int makeVDOPageCache(PhysicalLayer         *layer,
     return result;
   }
 
-  // initialize empty circular queues
-  initializeRing(&cache->lruList);
-  initializeRing(&cache->outgoingList);
-
   *cachePtr = cache;
   return VDO_SUCCESS;
 }
@@ -180,17 +396,15 @@ void freeVDOPageCache(VDOPageCache **cachePtr)
     return;
   }
 
-  if (cache->infos != NULL) {
-    PageInfo *info;
-    for (info = cache->infos; info < cache->infos + cache->pageCount; ++info) {
-      freeVIO(&info->vio);
-    }
+  while (cache->chunks != NULL) {
+    PageInfoChunk *chunk = cache->chunks;
+    cache->chunks = chunk->next;
+    freePageInfoChunk(chunk);
   }
 
+  destroyEnqueueable(&cache->reaper);
   freeDirtyLists(&cache->dirtyLists);
-  freeIntMap(&cache->pageMap);
-  FREE(cache->infos);
-  FREE(cache->pages);
+  FREE(cache->pageTable);
   FREE(cache);
   *cachePtr = NULL;
 }
@@ -262,7 +476,8 @@ const char *vpcPageStateName(PageState state)
     "FAILED",
     "RESIDENT",
     "DIRTY",
-    "OUTGOING"
+    "OUTGOING",
+    "RETIRED"
   };
   STATIC_ASSERT(COUNT_OF(stateNames) == PAGE_STATE_COUNT);
 
@@ -380,16 +595,13 @@ static int setInfoPBN(PageInfo *info, PhysicalBlockNumber pbn)
   }
 
   if (info->pbn != NO_PAGE) {
-    intMapRemove(cache->pageMap, info->pbn);
+    removeFromPageTable(cache, info);
   }
 
   info->pbn = pbn;
 
   if (pbn != NO_PAGE) {
-    result = intMapPut(cache->pageMap, pbn, info, true, NULL);
-    if (result != UDS_SUCCESS) {
-      return result;
-    }
+    addToPageTable(cache, info);
   }
   return VDO_SUCCESS;
 }
@@ -441,7 +653,7 @@ PageInfo *vpcFindPage(VDOPageCache *cache, PhysicalBlockNumber pbn)
       && (cache->lastFound->pbn == pbn)) {
     return cache->lastFound;
   }
-  cache->lastFound = intMapGet(cache->pageMap, pbn);
+  cache->lastFound = findInPageTable(cache, pbn);
   return cache->lastFound;
 }
 
@@ -468,7 +680,7 @@ static PageInfo *selectLRUPage(VDOPageCache *cache)
        lru != &cache->lruList;
        lru = lru->next) {
     PageInfo *info = pageInfoFromLRUNode(lru);
-    if ((info->busy == 0) && !isInFlight(info)) {
+    if ((info->busy == 0) && !isInFlight(info) && !isRetiring(info)) {
       return info;
     }
   }
@@ -602,9 +814,12 @@ static void setPersistentError(VDOPageCache *cache,
   distributeErrorOverQueue(result, &cache->freeWaiters);
   cache->waiterCount = 0;
 
-  PageInfo *info;
-  for (info = cache->infos; info < cache->infos + cache->pageCount; ++info) {
-    distributeErrorOverQueue(result, &info->waiting);
+  PageInfoChunk *chunk;
+  for (chunk = cache->chunks; chunk != NULL; chunk = chunk->next) {
+    PageInfo *info;
+    for (info = chunk->infos; info < chunk->infos + chunk->count; ++info) {
+      distributeErrorOverQueue(result, &info->waiting);
+    }
   }
 }
 
@@ -682,7 +897,8 @@ static VDOPageCompletion *validateCompletedPage(VDOCompletion *completion,
 /**********************************************************************/
 bool isPageCacheActive(VDOPageCache *cache)
 {
-  return ((cache->outstandingReads != 0) || (cache->outstandingWrites != 0));
+  return ((cache->outstandingReads != 0) || (cache->outstandingWrites != 0)
+          || cache->reaping);
 }
 
 /**
@@ -709,6 +925,9 @@ static void pageIsLoaded(VDOCompletion *completion)
   checkForDrainComplete(cache->zone);
 }
 
+/**********************************************************************/
+static void tryRetirePage(PageInfo *info);
+
 /**
  * Handle page load errors.
  *
@@ -726,6 +945,7 @@ static void handleLoadError(VDOCompletion *completion)
   setInfoState(info, PS_FAILED);
   distributeErrorOverQueue(result, &info->waiting);
   resetPageInfo(info);
+  tryRetirePage(info);
 
   /*
    * Don't decrement until right before calling checkForDrainComplete() to
@@ -900,6 +1120,95 @@ static void launchPageSave(PageInfo *info)
   savePages(info->cache);
 }
 
+/**
+ * Free any chunks all of whose pages have been retired. This callback is
+ * registered in launchReaper() so that a chunk is never freed out from under
+ * a callback of one of its own page VIOs.
+ *
+ * @param completion  The cache's reaper completion
+ **/
+static void reapRetiredChunks(VDOCompletion *completion)
+{
+  VDOPageCache *cache = completion->parent;
+  assertOnCacheThread(cache, __func__);
+  cache->reaping = false;
+
+  PageInfoChunk **chunkPtr = &cache->chunks;
+  while (*chunkPtr != NULL) {
+    PageInfoChunk *chunk = *chunkPtr;
+    if (!chunk->retiring || (chunk->retired < chunk->count)) {
+      chunkPtr = &chunk->next;
+      continue;
+    }
+
+    *chunkPtr             = chunk->next;
+    cache->pageCount     -= chunk->count;
+    cache->retiringCount -= chunk->count;
+    freePageInfoChunk(chunk);
+  }
+
+  checkForDrainComplete(cache->zone);
+}
+
+/**
+ * Launch the reaper to free fully retired chunks unless it is already pending.
+ *
+ * @param cache  The page cache
+ **/
+static void launchReaper(VDOPageCache *cache)
+{
+  if (cache->reaping) {
+    return;
+  }
+
+  cache->reaping = true;
+  prepareForRequeue(&cache->reaper, reapRetiredChunks, reapRetiredChunks,
+                    cache->zone->threadID, cache);
+  invokeCallback(&cache->reaper);
+}
+
+/**
+ * Retire a page which belongs to a chunk being removed from the cache, if the
+ * page is idle. A dirty page is written out first and retired once the write
+ * has finished.
+ *
+ * @param info  The page to retire
+ **/
+static void tryRetirePage(PageInfo *info)
+{
+  if (!isRetiring(info) || (info->state == PS_RETIRED) || (info->busy > 0)
+      || isInFlight(info) || hasWaiters(&info->waiting)
+      || (info->writeStatus != WRITE_STATUS_NORMAL)) {
+    return;
+  }
+
+  VDOPageCache *cache = info->cache;
+  if (isDirty(info)) {
+    // A quiescent cache may not issue I/O. The page will be written when its
+    // era expires after the cache resumes.
+    if (isNormal(&cache->zone->state)) {
+      launchPageSave(info);
+    }
+    return;
+  }
+
+  if (cache->lastFound == info) {
+    cache->lastFound = NULL;
+  }
+
+  int result = setInfoPBN(info, NO_PAGE);
+  if (result != VDO_SUCCESS) {
+    setPersistentError(cache, "cannot retire page", result);
+    return;
+  }
+
+  setInfoState(info, PS_RETIRED);
+  unspliceRingNode(&info->lruNode);
+  if (++info->chunk->retired == info->chunk->count) {
+    launchReaper(cache);
+  }
+}
+
 /**
  * Determine whether a given VDOPageCompletion (as a waiter) is requesting a
  * given page number. Implements WaiterMatch.
@@ -1113,7 +1422,10 @@ static void pageIsWrittenOut(VDOCompletion *completion)
     cache->discardCount--;
   }
 
-  if (reclaimed) {
+  if (isRetiring(info)) {
+    tryRetirePage(info);
+    discardPageIfNeeded(cache);
+  } else if (reclaimed) {
     discardPageIfNeeded(cache);
   } else {
     allocateFreePage(info);
@@ -1193,6 +1505,7 @@ void releaseVDOPageCompletion(VDOCompletion *completion)
       discardInfo->writeStatus = WRITE_STATUS_NORMAL;
       launchPageSave(discardInfo);
     }
+    tryRetirePage(discardInfo);
     // if there are excess requests for pages (that have not already started
     // discards) we need to discard some page (which may be this one)
     discardPageIfNeeded(cache);
@@ -1355,15 +1668,92 @@ int invalidateVDOPageCache(VDOPageCache *cache)
   assertOnCacheThread(cache, __func__);
 
   // Make sure we don't throw away any dirty pages.
-  PageInfo *info;
-  for (info = cache->infos; info < cache->infos + cache->pageCount; info++) {
-    int result = ASSERT(!isDirty(info), "cache must have no dirty pages");
+  PageInfoChunk *chunk;
+  for (chunk = cache->chunks; chunk != NULL; chunk = chunk->next) {
+    PageInfo *info;
+    for (info = chunk->infos; info < chunk->infos + chunk->count; info++) {
+      int result = ASSERT(!isDirty(info), "cache must have no dirty pages");
+      if (result != VDO_SUCCESS) {
+        return result;
+      }
+    }
+  }
+
+  // Free every mapped page, so that no info keeps a stale PBN which a later
+  // rehash of the page table would bring back.
+  for (chunk = cache->chunks; chunk != NULL; chunk = chunk->next) {
+    PageInfo *info;
+    for (info = chunk->infos; info < chunk->infos + chunk->count; info++) {
+      if (info->pbn == NO_PAGE) {
+        continue;
+      }
+
+      int result = resetPageInfo(info);
+      if (result != VDO_SUCCESS) {
+        return result;
+      }
+    }
+  }
+
+  cache->lastFound = NULL;
+  return VDO_SUCCESS;
+}
+
+/**********************************************************************/
+int resizeVDOPageCache(VDOPageCache *cache, PageCount pageCount)
+{
+  assertOnCacheThread(cache, __func__);
+  int result = ASSERT(pageCount > 0, "VDO page cache must have pages");
+  if (result != VDO_SUCCESS) {
+    return result;
+  }
+
+  if (cache->retiringCount > 0) {
+    return logErrorWithStringError(VDO_COMPONENT_BUSY,
+                                   "VDO page cache is still shrinking");
+  }
+
+  if (pageCount > cache->pageCount) {
+    result = addPages(cache, pageCount - cache->pageCount);
     if (result != VDO_SUCCESS) {
       return result;
     }
+
+    // Give the new pages to any requests which are waiting for a free page.
+    PageInfo *info;
+    while (hasWaiters(&cache->freeWaiters)
+           && ((info = findFreePage(cache)) != NULL)) {
+      allocateFreePage(info);
+    }
+
+    return VDO_SUCCESS;
+  }
+
+  // Retire the newest chunks which lie entirely beyond the new size.
+  PageInfoChunk *chunk;
+  for (chunk = cache->chunks;
+       ((chunk != NULL)
+        && ((cache->pageCount - cache->retiringCount - chunk->count)
+            >= pageCount));
+       chunk = chunk->next) {
+    chunk->retiring       = true;
+    cache->retiringCount += chunk->count;
+  }
+
+  for (chunk = cache->chunks;
+       (chunk != NULL) && chunk->retiring;
+       chunk = chunk->next) {
+    PageInfo *info;
+    for (info = chunk->infos; info < chunk->infos + chunk->count; ++info) {
+      tryRetirePage(info);
+    }
   }
 
-  // Reset the pageMap by re-allocating it.
-  freeIntMap(&cache->pageMap);
-  return makeIntMap(cache->pageCount, 0, &cache->pageMap);
+  return VDO_SUCCESS;
+}
+
+/**********************************************************************/
+PageCount getVDOPageCacheSize(const VDOPageCache *cache)
+{
+  return cache->pageCount - cache->retiringCount;
 }
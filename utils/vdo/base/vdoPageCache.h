@@ -370,8 +370,34 @@ void drainVDOPageCache(VDOPageCache *cache);
 int invalidateVDOPageCache(VDOPageCache *cache)
   __attribute__((warn_unused_result));
 
+/**
+ * Change the number of pages in a VDO page cache. Growing the cache takes
+ * effect immediately. Shrinking the cache removes whole chunks of pages, so
+ * the cache may be left slightly larger than requested; the memory for each
+ * removed chunk is released once all of its pages have been written out (if
+ * dirty) and are no longer in use.
+ *
+ * @param cache      The cache to resize
+ * @param pageCount  The desired number of pages
+ *
+ * @return VDO_SUCCESS or an error code
+ **/
+int resizeVDOPageCache(VDOPageCache *cache, PageCount pageCount)
+  __attribute__((warn_unused_result));
+
 // STATISTICS & TESTING
 
+/**
+ * Get the number of pages in a VDO page cache, not counting pages which are
+ * being removed by a shrink.
+ *
+ * @param cache  the page cache
+ *
+ * @return the number of pages in the cache
+ **/
+PageCount getVDOPageCacheSize(const VDOPageCache *cache)
+  __attribute__((warn_unused_result));
+
 /**
  * Get current cache statistics.
  *
@@ -31,12 +31,13 @@
 #include "blockMapInternals.h"
 #include "completion.h"
 #include "dirtyLists.h"
-#include "intMap.h"
 #include "physicalLayer.h"
 #include "ringNode.h"
 
 enum {
   MAX_PAGE_CONTEXT_SIZE = 8,
+  /** the maximum number of pages allocated together in a PageInfoChunk */
+  MAX_PAGE_INFO_CHUNK_SIZE = 1024,
 };
 
 static const PhysicalBlockNumber NO_PAGE = 0xFFFFFFFFFFFFFFFF;
@@ -46,14 +47,38 @@ static const PhysicalBlockNumber NO_PAGE = 0xFFFFFFFFFFFFFFFF;
  **/
 typedef RingNode PageInfoNode;
 
+/**
+ * A PageInfoChunk is a unit of page cache memory: an array of page infos and
+ * the page buffers they describe. The cache grows and shrinks a chunk at a
+ * time.
+ **/
+typedef struct pageInfoChunk PageInfoChunk;
+
+struct pageInfoChunk {
+  /** the next chunk in the cache (chunks are kept newest first) */
+  PageInfoChunk *next;
+  /** the number of pages in this chunk */
+  PageCount      count;
+  /** the number of pages in this chunk which have been retired */
+  PageCount      retired;
+  /** whether this chunk is being removed from the cache */
+  bool           retiring;
+  /** array of page information entries */
+  PageInfo      *infos;
+  /** raw memory for pages */
+  char          *pages;
+};
+
 /**
  * The VDO Page Cache abstraction.
  **/
 struct vdoPageCache {
   /** the physical layer to page to */
   PhysicalLayer             *layer;
-  /** number of pages in cache */
+  /** number of pages in cache, including those not yet retired */
   PageCount                  pageCount;
+  /** number of pages in chunks which are being retired */
+  PageCount                  retiringCount;
   /** function to call on page read */
   VDOPageReadFunction       *readHook;
   /** function to call on page write */
@@ -63,14 +88,14 @@ struct vdoPageCache {
   /** Whether the VDO is doing a read-only rebuild */
   bool                       rebuilding;
 
-  /** array of page information entries */
-  PageInfo                  *infos;
-  /** raw memory for pages */
-  char                      *pages;
+  /** the chunks of page infos and pages, newest first */
+  PageInfoChunk             *chunks;
   /** cache last found page info */
   PageInfo                  *lastFound;
-  /** map of page number to info */
-  IntMap                    *pageMap;
+  /** open-addressed table of the infos of mapped pages, indexed by pbn */
+  PageInfo                 **pageTable;
+  /** the shift which reduces a hashed pbn to an index in pageTable */
+  unsigned int               pageTableShift;
   /** master LRU list (all infos) */
   PageInfoNode               lruList;
   /** dirty pages by period */
@@ -99,6 +124,10 @@ struct vdoPageCache {
   uint32_t                   pressureReport;
   /** the block map zone to which this cache belongs */
   BlockMapZone              *zone;
+  /** completion for freeing chunks whose pages have all been retired */
+  VDOCompletion              reaper;
+  /** whether the reaper has been launched */
+  bool                       reaping;
 };
 
 /**
@@ -124,6 +153,8 @@ typedef enum __attribute__((packed)) pageState {
   PS_DIRTY,
   /* this page is being written and should not be used */
   PS_OUTGOING,
+  /* this page buffer is being removed from the cache by a shrink */
+  PS_RETIRED,
   /* not a state */
   PAGE_STATE_COUNT,
 } PageState;
@@ -145,6 +176,8 @@ struct pageInfo {
   VIO                 *vio;
   /** back-link for references */
   VDOPageCache        *cache;
+  /** the chunk which holds this info and its page buffer */
+  PageInfoChunk       *chunk;
   /** the pbn of the page */
   PhysicalBlockNumber  pbn;
   /** page is busy (temporarily locked) */
@@ -233,6 +266,12 @@ static inline bool isOutgoing(const PageInfo *info)
   return info->state == PS_OUTGOING;
 }
 
+/**********************************************************************/
+static inline bool isRetiring(const PageInfo *info)
+{
+  return info->chunk->retiring;
+}
+
 /**********************************************************************/
 static inline bool isValid(const PageInfo *info)
 {
@@ -698,7 +698,9 @@ static void addSlabJournalEntries(VDOCompletion *completion)
       return;
     }
 
-    if (entry.mapping.pbn == ZERO_BLOCK) {
+    if ((entry.mapping.pbn == ZERO_BLOCK)
+        || isBlockMapTierBlock(vdo->blockMap, entry.mapping.pbn)) {
+      // Neither the zero block nor the block map tier is in any slab.
       continue;
     }
 
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2020 Red Hat, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA. 
+ *
+ * $Id: //eng/vdo-releases/aluminum/src/c++/vdo/base/vdoResizeCache.c#1 $
+ */
+
+#include "vdoResizeCache.h"
+
+#include "logger.h"
+
+#include "adminCompletion.h"
+#include "blockMap.h"
+#include "completion.h"
+#include "readOnlyNotifier.h"
+#include "threadConfig.h"
+#include "vdoInternal.h"
+
+typedef enum {
+  RESIZE_CACHE_PHASE_START = 0,
+  RESIZE_CACHE_PHASE_RESIZE,
+  RESIZE_CACHE_PHASE_END,
+} ResizeCachePhase;
+
+static const char *RESIZE_CACHE_PHASE_NAMES[] = {
+  "RESIZE_CACHE_PHASE_START",
+  "RESIZE_CACHE_PHASE_RESIZE",
+  "RESIZE_CACHE_PHASE_END",
+};
+
+/**
+ * Implements ThreadIDGetterForPhase.
+ **/
+__attribute__((warn_unused_result))
+static ThreadID getThreadIDForPhase(AdminCompletion *adminCompletion)
+{
+  const ThreadConfig *threadConfig
+    = getThreadConfig(adminCompletion->completion.parent);
+  return ((adminCompletion->phase == RESIZE_CACHE_PHASE_RESIZE)
+          ? getJournalZoneThread(threadConfig)
+          : getAdminThread(threadConfig));
+}
+
+/**
+ * Callback to initiate a cache resize, registered in
+ * performResizeBlockMapCache().
+ *
+ * @param completion  The sub-task completion
+ **/
+static void resizeCacheCallback(VDOCompletion *completion)
+{
+  AdminCompletion *adminCompletion = adminCompletionFromSubTask(completion);
+  assertAdminOperationType(adminCompletion, ADMIN_OPERATION_RESIZE_CACHE);
+  assertAdminPhaseThread(adminCompletion, __func__, RESIZE_CACHE_PHASE_NAMES);
+
+  VDO *vdo = adminCompletion->completion.parent;
+  switch (adminCompletion->phase++) {
+  case RESIZE_CACHE_PHASE_START:
+    if (isReadOnly(vdo->readOnlyNotifier)) {
+      finishCompletion(completion->parent, VDO_READ_ONLY);
+      return;
+    }
+
+    completeCompletion(resetAdminSubTask(completion));
+    return;
+
+  case RESIZE_CACHE_PHASE_RESIZE:
+    resizeBlockMapCaches(vdo->blockMap, vdo->nextCacheSize,
+                         resetAdminSubTask(completion));
+    return;
+
+  case RESIZE_CACHE_PHASE_END:
+    vdo->loadConfig.cacheSize = vdo->nextCacheSize;
+    logInfo("block map cache resized to %u pages", vdo->nextCacheSize);
+    break;
+
+  default:
+    setCompletionResult(completion, UDS_BAD_STATE);
+  }
+
+  finishCompletion(completion->parent, completion->result);
+}
+
+/**********************************************************************/
+int performResizeBlockMapCache(VDO *vdo, PageCount cacheSize)
+{
+  if (cacheSize == vdo->loadConfig.cacheSize) {
+    return VDO_SUCCESS;
+  }
+
+  vdo->nextCacheSize = cacheSize;
+  return performAdminOperation(vdo, ADMIN_OPERATION_RESIZE_CACHE,
+                               getThreadIDForPhase, resizeCacheCallback,
+                               finishParentCallback);
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2020 Red Hat, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA. 
+ *
+ * $Id: //eng/vdo-releases/aluminum/src/c++/vdo/base/vdoResizeCache.h#1 $
+ */
+
+#ifndef VDO_RESIZE_CACHE_H
+#define VDO_RESIZE_CACHE_H
+
+#include "types.h"
+
+/**
+ * Change the size of the block map page cache of a running VDO. Growing takes
+ * effect immediately; shrinking releases memory as the pages being removed
+ * are written out and go idle. This method must not be called from a base
+ * thread.
+ *
+ * @param vdo        The VDO whose cache is to be resized
+ * @param cacheSize  The new block map cache size, in pages
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+int performResizeBlockMapCache(VDO *vdo, PageCount cacheSize);
+
+#endif /* VDO_RESIZE_CACHE_H */
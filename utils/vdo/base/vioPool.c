@@ -25,7 +25,9 @@
 #include "memoryAlloc.h"
 #include "permassert.h"
 
+#include "atomic.h"
 #include "constants.h"
+#include "numeric.h"
 #include "vio.h"
 #include "types.h"
 
@@ -34,25 +36,135 @@
  **/
 struct vioPool {
   /** The number of objects managed by the pool */
-  size_t         size;
+  size_t          size;
+  /** The number of preallocated objects, which are never freed while idle */
+  size_t          baseSize;
+  /** The number of objects to which the pool may grow during an outage */
+  size_t          maxSize;
+  /** The layer in which the pool's VIOs operate */
+  PhysicalLayer  *layer;
+  /** The constructor for VIOs added when the pool grows */
+  VIOConstructor *vioConstructor;
+  /** The context given to each entry */
+  void           *context;
   /** The list of objects which are available */
-  RingNode       available;
+  RingNode        available;
   /** The queue of requestors waiting for objects from the pool */
-  WaitQueue      waiting;
+  WaitQueue       waiting;
   /** The number of objects currently in use */
-  size_t         busyCount;
+  size_t          busyCount;
   /** The list of objects which are in use */
-  RingNode       busy;
-  /** The number of requests when no object was available */
-  uint64_t       outageCount;
+  RingNode        busy;
+  /** The number of requests which had to wait for an object */
+  Atomic64        outageCount;
+  /** The number of objects added beyond the preallocated ones */
+  Atomic64        growCount;
+  /** The number of objects managed by the pool, for statistics */
+  Atomic64        reportedSize;
   /** The ID of the thread on which this pool may be used */
-  ThreadID       threadID;
-  /** The buffer backing the pool's VIOs */
-  char          *buffer;
-  /** The pool entries */
-  VIOPoolEntry   entries[];
+  ThreadID        threadID;
+  /** The buffer backing the preallocated VIOs */
+  char           *buffer;
+  /** The preallocated pool entries */
+  VIOPoolEntry    entries[];
 };
 
+/**
+ * Check whether a pool entry was added when the pool grew, rather than being
+ * one of the pool's preallocated entries.
+ *
+ * @param pool   The pool
+ * @param entry  The entry to check
+ *
+ * @return <code>true</code> if the entry was allocated by growVIOPool()
+ **/
+static inline bool isGrownEntry(const VIOPool *pool, const VIOPoolEntry *entry)
+{
+  return ((entry < pool->entries)
+          || (entry >= &pool->entries[pool->baseSize]));
+}
+
+/**
+ * Free an entry which was added when the pool grew.
+ *
+ * @param entry  The entry to free
+ **/
+static void freeGrownEntry(VIOPoolEntry *entry)
+{
+  freeVIO(&entry->vio);
+  FREE(entry->buffer);
+  FREE(entry);
+}
+
+/**
+ * Add an entry to a pool which has run out of available entries, provided
+ * the pool has not reached its maximum size.
+ *
+ * @param pool  The pool to grow
+ *
+ * @return <code>true</code> if an entry was added to the available list
+ **/
+static bool growVIOPool(VIOPool *pool)
+{
+  if (pool->size >= pool->maxSize) {
+    return false;
+  }
+
+  VIOPoolEntry *entry;
+  int result = ALLOCATE(1, VIOPoolEntry, __func__, &entry);
+  if (result != VDO_SUCCESS) {
+    return false;
+  }
+
+  result = ALLOCATE(VDO_BLOCK_SIZE, char, "VIO pool entry buffer",
+                    &entry->buffer);
+  if (result != VDO_SUCCESS) {
+    FREE(entry);
+    return false;
+  }
+
+  entry->context = pool->context;
+  result = pool->vioConstructor(pool->layer, entry, entry->buffer,
+                                &entry->vio);
+  if (result != VDO_SUCCESS) {
+    FREE(entry->buffer);
+    FREE(entry);
+    return false;
+  }
+
+  initializeRing(&entry->node);
+  pushRingNode(&pool->available, &entry->node);
+  pool->size++;
+  relaxedAdd64(&pool->growCount, 1);
+  relaxedStore64(&pool->reportedSize, pool->size);
+  return true;
+}
+
+/**
+ * Free the available entries which were added when the pool grew. This is
+ * called when the pool becomes idle, from the callback of the VIO whose
+ * return made it so. That VIO can not be freed from within its own callback,
+ * so its entry is kept until a later pass.
+ *
+ * @param pool      The pool to shrink
+ * @param returned  The entry which was just returned to the pool
+ **/
+static void shrinkVIOPool(VIOPool *pool, VIOPoolEntry *returned)
+{
+  RingNode *node = pool->available.next;
+  while (node != &pool->available) {
+    VIOPoolEntry *entry = asVIOPoolEntry(node);
+    node = node->next;
+    if ((entry != returned) && isGrownEntry(pool, entry)) {
+      unspliceRingNode(&entry->node);
+      freeGrownEntry(entry);
+      pool->size--;
+    }
+  }
+
+  relaxedStore64(&pool->reportedSize, pool->size);
+}
+
 /**********************************************************************/
 int makeVIOPool(PhysicalLayer   *layer,
                 size_t           poolSize,
@@ -68,7 +180,12 @@ int makeVIOPool(PhysicalLayer   *layer,
     return result;
   }
 
-  pool->threadID = threadID;
+  pool->threadID       = threadID;
+  pool->baseSize       = poolSize;
+  pool->maxSize        = poolSize;
+  pool->layer          = layer;
+  pool->vioConstructor = vioConstructor;
+  pool->context        = context;
   initializeRing(&pool->available);
   initializeRing(&pool->busy);
 
@@ -96,6 +213,7 @@ int makeVIOPool(PhysicalLayer   *layer,
     pool->size++;
   }
 
+  relaxedStore64(&pool->reportedSize, pool->size);
   *poolPtr = pool;
   return VDO_SUCCESS;
 }
@@ -119,11 +237,15 @@ void freeVIOPool(VIOPool **poolPtr)
 
   VIOPoolEntry *entry;
   while ((entry = asVIOPoolEntry(chopRingNode(&pool->available))) != NULL) {
-    freeVIO(&entry->vio);
+    if (isGrownEntry(pool, entry)) {
+      freeGrownEntry(entry);
+    } else {
+      freeVIO(&entry->vio);
+    }
   }
 
-  // Make sure every VIOPoolEntry has been removed.
-  for (size_t i = 0; i < pool->size; i++) {
+  // Make sure every preallocated VIOPoolEntry has been removed.
+  for (size_t i = 0; i < pool->baseSize; i++) {
     VIOPoolEntry *entry = &pool->entries[i];
     ASSERT_LOG_ONLY(isRingEmpty(&entry->node), "VIO Pool entry still in use:"
                     " VIO is in use for physical block %" PRIu64
@@ -137,6 +259,12 @@ void freeVIOPool(VIOPool **poolPtr)
   *poolPtr = NULL;
 }
 
+/**********************************************************************/
+void setVIOPoolGrowthFactor(VIOPool *pool, unsigned int factor)
+{
+  pool->maxSize = pool->baseSize * maxUInt(factor, 1);
+}
+
 /**********************************************************************/
 bool isVIOPoolBusy(VIOPool *pool)
 {
@@ -149,8 +277,8 @@ int acquireVIOFromPool(VIOPool *pool, Waiter *waiter)
   ASSERT_LOG_ONLY((pool->threadID == getCallbackThreadID()),
                   "acquire from active VIOPool called from correct thread");
 
-  if (isRingEmpty(&pool->available)) {
-    pool->outageCount++;
+  if (isRingEmpty(&pool->available) && !growVIOPool(pool)) {
+    relaxedAdd64(&pool->outageCount, 1);
     return enqueueWaiter(&pool->waiting, waiter);
   }
 
@@ -173,11 +301,23 @@ void returnVIOToPool(VIOPool *pool, VIOPoolEntry *entry)
   }
 
   pushRingNode(&pool->available, &entry->node);
-  --pool->busyCount;
+  if ((--pool->busyCount == 0) && (pool->size > pool->baseSize)) {
+    shrinkVIOPool(pool, entry);
+  }
 }
 
 /**********************************************************************/
 uint64_t getVIOPoolOutageCount(VIOPool *pool)
 {
-  return pool->outageCount;
+  return relaxedLoad64(&pool->outageCount);
+}
+
+/**********************************************************************/
+VIOPoolStatistics getVIOPoolStatistics(const VIOPool *pool)
+{
+  return (VIOPoolStatistics) {
+    .waits = relaxedLoad64(&pool->outageCount),
+    .grows = relaxedLoad64(&pool->growCount),
+    .size  = relaxedLoad64(&pool->reportedSize),
+  };
 }
@@ -44,6 +44,18 @@ typedef struct {
   void     *context;
 } VIOPoolEntry;
 
+/**
+ * The statistics for a VIO pool, which may be read from any thread.
+ **/
+typedef struct {
+  /** The number of acquisition requests which had to wait */
+  uint64_t waits;
+  /** The number of entries added because the pool ran out */
+  uint64_t grows;
+  /** The current number of entries in the pool */
+  uint64_t size;
+} VIOPoolStatistics;
+
 /**
  * A function which constructs a VIO for a pool.
  *
@@ -58,10 +70,14 @@ typedef int VIOConstructor(PhysicalLayer  *layer,
                            VIO           **vioPtr);
 
 /**
- * Create a new VIO pool.
+ * Create a new VIO pool. The pool has a fixed size unless it is given a
+ * growth factor with setVIOPoolGrowthFactor(). When a request to a pool
+ * which may grow finds no available VIO, the pool will allocate another one
+ * rather than making the request wait, until it reaches its maximum size.
+ * Those additional VIOs are freed once the pool becomes idle.
  *
  * @param [in]  layer           the physical layer to write to and read from
- * @param [in]  poolSize        the number of VIOs in the pool
+ * @param [in]  poolSize        the number of VIOs to preallocate
  * @param [in]  threadID        the ID of the thread using this pool
  * @param [in]  vioConstructor  the constructor for VIOs in the pool
  * @param [in]  context         the context that each entry will have
@@ -84,6 +100,15 @@ int makeVIOPool(PhysicalLayer   *layer,
  **/
 void freeVIOPool(VIOPool **poolPtr);
 
+/**
+ * Set the multiple of its preallocated size to which a VIO pool may grow.
+ * This must be called from the pool's thread or before the pool is in use.
+ *
+ * @param pool    The pool
+ * @param factor  The growth factor (0 or 1 keep the pool at a fixed size)
+ **/
+void setVIOPoolGrowthFactor(VIOPool *pool, unsigned int factor);
+
 /**
  * Check whether an VIO pool has outstanding entries.
  *
@@ -133,4 +158,14 @@ static inline VIOPoolEntry *asVIOPoolEntry(RingNode *node)
 uint64_t getVIOPoolOutageCount(VIOPool *pool)
   __attribute__((warn_unused_result));
 
+/**
+ * Get the statistics of a VIO pool. This may be called from any thread.
+ *
+ * @param pool  The pool
+ *
+ * @return the current statistics of the pool
+ **/
+VIOPoolStatistics getVIOPoolStatistics(const VIOPool *pool)
+  __attribute__((warn_unused_result));
+
 #endif // VIO_POOL_H
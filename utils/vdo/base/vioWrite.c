@@ -198,6 +198,7 @@
 #include "slab.h"
 #include "slabDepot.h"
 #include "slabJournal.h"
+#include "streamDetector.h"
 #include "vdoInternal.h"
 #include "vioRead.h"
 
@@ -263,6 +264,15 @@ static void releaseLogicalLock(VDOCompletion *completion)
 {
   DataVIO *dataVIO = asDataVIO(completion);
   assertInLogicalZone(dataVIO);
+  if (isWriteDataVIO(dataVIO) && !dataVIO->isZeroBlock
+      && !isTrimDataVIO(dataVIO)
+      && (completion->result == VDO_SUCCESS)) {
+    recordStreamOutcome(getStreamDetector(dataVIO->logical.zone),
+                        dataVIO->logical.lbn, dataVIO->wasMapped,
+                        dataVIO->isDuplicate, dataVIO->isIncompressible,
+                        dataVIO->isDedupeBypassed);
+  }
+
   releaseLogicalBlockLock(dataVIO);
   releaseFlushGenerationLock(dataVIO);
   performCleanupStage(dataVIO, VIO_CLEANUP_DONE);
@@ -578,6 +588,11 @@ static void journalUnmappingForDedupe(VDOCompletion *completion)
     return;
   }
 
+  if (isAsync(dataVIO)) {
+    // In sync mode, the old mapping was already read for the write.
+    dataVIO->wasMapped = (dataVIO->mapped.pbn != ZERO_BLOCK);
+  }
+
   if (dataVIO->mapped.pbn == ZERO_BLOCK) {
     setLogicalCallback(dataVIO, updateBlockMapForDedupe,
                        THIS_LOCATION("$F;j=dedupe;js=unmap;cb=updateBM"));
@@ -951,6 +966,7 @@ static void journalUnmappingForWrite(VDOCompletion *completion)
     return;
   }
 
+  dataVIO->wasMapped = (dataVIO->mapped.pbn != ZERO_BLOCK);
   if (dataVIO->mapped.pbn == ZERO_BLOCK) {
     setLogicalCallback(dataVIO, updateBlockMapForWrite,
                        THIS_LOCATION("$F;js=unmap;cb=updateBMwrite"));
@@ -1042,7 +1058,9 @@ static void incrementForWrite(VDOCompletion *completion)
    * block. Downgrade the allocation lock to a read lock so it can be used
    * later by the hash lock (which we don't have yet in sync mode).
    */
-  downgradePBNWriteLock(dataVIOAsAllocatingVIO(dataVIO)->allocationLock);
+  AllocatingVIO *allocatingVIO = dataVIOAsAllocatingVIO(dataVIO);
+  downgradePBNWriteLock(allocatingVIO->allocationLock);
+  cacheRecentWrite(allocatingVIO->zone, dataVIO);
 
   dataVIO->lastAsyncOperation = JOURNAL_INCREMENT_FOR_WRITE;
   setLogicalCallback(dataVIO, getWriteIncrementCallback(dataVIO),
@@ -1188,6 +1206,10 @@ void launchWriteDataVIO(DataVIO *dataVIO)
     return;
   }
 
+  dataVIO->streamHints
+    = recordStreamWrite(getStreamDetector(dataVIO->logical.zone),
+                        dataVIO->logical.lbn);
+
   // Go find the block map slot for the LBN mapping.
   dataVIO->lastAsyncOperation = FIND_BLOCK_MAP_SLOT;
   findBlockMapSlotAsync(dataVIO, continueWriteWithBlockMapSlot,
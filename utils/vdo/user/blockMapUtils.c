@@ -26,6 +26,7 @@
 #include "syscalls.h"
 #include "memoryAlloc.h"
 
+#include "blockMap.h"
 #include "blockMapInternals.h"
 #include "blockMapPage.h"
 #include "physicalLayer.h"
@@ -46,6 +47,13 @@ bool isValidDataBlock(const SlabDepot *depot, PhysicalBlockNumber pbn)
   return (sbn < getSlabConfig(depot)->dataBlocks);
 }
 
+/**********************************************************************/
+bool isValidTreePage(VDO *vdo, PhysicalBlockNumber pbn)
+{
+  return (isValidDataBlock(vdo->depot, pbn)
+          || isBlockMapTierBlock(getBlockMap(vdo), pbn));
+}
+
 /**
  * Read a block map page call the examiner on every defined mapping in it.
  * Also recursively call itself to examine an entire tree.
@@ -98,7 +106,7 @@ static int readAndExaminePage(VDO                 *vdo,
       continue;
     }
 
-    if ((height > 0) && isValidDataBlock(vdo->depot, mapped.pbn)) {
+    if ((height > 0) && isValidTreePage(vdo, mapped.pbn)) {
       result = readAndExaminePage(vdo, mapped.pbn, height - 1, examiner);
       if (result != VDO_SUCCESS) {
         FREE(page);
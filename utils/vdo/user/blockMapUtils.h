@@ -56,6 +56,18 @@ typedef int MappingExaminer(BlockMapSlot        slot,
 bool isValidDataBlock(const SlabDepot *depot, PhysicalBlockNumber pbn)
   __attribute__((warn_unused_result));
 
+/**
+ * Check whether a given PBN is a valid PBN for a block map tree page, which
+ * may be either a data block or a block in the block map tier.
+ *
+ * @param vdo  The VDO
+ * @param pbn  The PBN to check
+ *
+ * @return true if the PBN can be used for a tree page
+ **/
+bool isValidTreePage(VDO *vdo, PhysicalBlockNumber pbn)
+  __attribute__((warn_unused_result));
+
 /**
  * Apply a mapping examiner to each mapped block map entry in a VDO.
  *
@@ -36,10 +36,15 @@
 #include "statusCodes.h"
 
 typedef struct fileLayer {
-  PhysicalLayer common;
-  BlockCount    blockCount;
-  int           fd;
-  char          name[];
+  PhysicalLayer  common;
+  BlockCount     blockCount;
+  int            fd;
+  bool           readOnly;
+  // The external metadata device, mapped at EXTERNAL_METADATA_ORIGIN
+  BlockCount     externalBlockCount;
+  int            externalFD;
+  char          *externalName;
+  char           name[];
 } FileLayer;
 
 /**********************************************************************/
@@ -84,6 +89,51 @@ static int bufferAllocator(PhysicalLayer   *header,
   return allocateMemory(bytes, statbuf.st_blksize, why, bufferPtr);
 }
 
+/**
+ * Map an extent of the layer's block address space to the file which holds
+ * it. If an external metadata device is attached, blocks at or beyond
+ * EXTERNAL_METADATA_ORIGIN are on it; otherwise all blocks are on the main
+ * file.
+ *
+ * @param [in]  layer       The layer
+ * @param [in]  startBlock  The physical block number of the start of the
+ *                          extent
+ * @param [in]  blockCount  The number of blocks in the extent
+ * @param [out] fdPtr       A pointer to hold the descriptor of the file
+ * @param [out] namePtr     A pointer to hold the name of the file
+ * @param [out] offsetPtr   A pointer to hold the byte offset in the file
+ *
+ * @return VDO_SUCCESS or VDO_OUT_OF_RANGE
+ **/
+static int mapExtent(FileLayer            *layer,
+                     PhysicalBlockNumber   startBlock,
+                     size_t                blockCount,
+                     int                  *fdPtr,
+                     const char          **namePtr,
+                     off_t                *offsetPtr)
+{
+  int         fd     = layer->fd;
+  const char *name   = layer->name;
+  BlockCount  blocks = layer->blockCount;
+  if ((layer->externalName != NULL)
+      && (startBlock >= EXTERNAL_METADATA_ORIGIN)) {
+    startBlock -= EXTERNAL_METADATA_ORIGIN;
+    fd          = layer->externalFD;
+    name        = layer->externalName;
+    blocks      = layer->externalBlockCount;
+  }
+
+  if (startBlock + blockCount > blocks) {
+    return VDO_OUT_OF_RANGE;
+  }
+
+  *fdPtr     = fd;
+  *namePtr   = name;
+  // Make sure we cast so we get a proper 64 bit value on the calculation
+  *offsetPtr = (off_t) startBlock * VDO_BLOCK_SIZE;
+  return VDO_SUCCESS;
+}
+
 /**********************************************************************/
 static int fileReader(PhysicalLayer       *header,
                       PhysicalBlockNumber  startBlock,
@@ -91,26 +141,26 @@ static int fileReader(PhysicalLayer       *header,
                       char                *buffer,
                       size_t              *blocksRead)
 {
-  FileLayer *layer = asFileLayer(header);
-
-  if (startBlock + blockCount > layer->blockCount) {
-    return VDO_OUT_OF_RANGE;
+  FileLayer  *layer = asFileLayer(header);
+  int         fd;
+  const char *name;
+  off_t       offset;
+  int result = mapExtent(layer, startBlock, blockCount, &fd, &name, &offset);
+  if (result != VDO_SUCCESS) {
+    return result;
   }
 
   logDebug("FL: Reading %zu blocks from block %" PRIu64,
            blockCount, startBlock);
 
-  // Make sure we cast so we get a proper 64 bit value on the calculation
-  off_t  offset = (off_t)startBlock * VDO_BLOCK_SIZE;
   size_t remain = blockCount * VDO_BLOCK_SIZE;
-
   while (remain > 0) {
-    ssize_t n = pread(layer->fd, buffer, remain, offset);
+    ssize_t n = pread(fd, buffer, remain, offset);
     if (n <= 0) {
       if (n == 0) {
         errno = VDO_UNEXPECTED_EOF;
       }
-      return logErrorWithStringError(errno, "pread %s", layer->name);
+      return logErrorWithStringError(errno, "pread %s", name);
     }
     offset += n;
     buffer += n;
@@ -130,23 +180,23 @@ static int fileWriter(PhysicalLayer       *header,
                       char                *buffer,
                       size_t              *blocksWritten)
 {
-  FileLayer *layer = asFileLayer(header);
-
-  if (startBlock + blockCount > layer->blockCount) {
-    return VDO_OUT_OF_RANGE;
+  FileLayer  *layer = asFileLayer(header);
+  int         fd;
+  const char *name;
+  off_t       offset;
+  int result = mapExtent(layer, startBlock, blockCount, &fd, &name, &offset);
+  if (result != VDO_SUCCESS) {
+    return result;
   }
 
   logDebug("FL: Writing %zu blocks from block %" PRIu64,
            blockCount, startBlock);
 
-  // Make sure we cast so we get a proper 64 bit value on the calculation
-  off_t  offset = (off_t)startBlock * VDO_BLOCK_SIZE;
   size_t remain = blockCount * VDO_BLOCK_SIZE;
-
   while (remain > 0) {
-    ssize_t n = pwrite(layer->fd, buffer, remain, offset);
+    ssize_t n = pwrite(fd, buffer, remain, offset);
     if (n < 0) {
-      return logErrorWithStringError(errno, "pwrite %s", layer->name);
+      return logErrorWithStringError(errno, "pwrite %s", name);
     }
     offset += n;
     buffer += n;
@@ -201,92 +251,119 @@ static void freeLayer(PhysicalLayer **layerPtr)
   }
 
   FileLayer *fileLayer = asFileLayer(layer);
+  if (fileLayer->externalName != NULL) {
+    trySyncAndCloseFile(fileLayer->externalFD);
+    FREE(fileLayer->externalName);
+  }
   trySyncAndCloseFile(fileLayer->fd);
   FREE(fileLayer);
   *layerPtr = NULL;
 }
 
 /**
- * Internal constructor to make a file layer.
+ * Open a file or block device for a file layer and determine its size.
  *
- * @param [in]  name        the name of the underlying file
- * @param [in]  readOnly    whether the layer is not allowed to write
- * @param [in]  blockCount  the span of the file, in blocks (may be zero for
- *                            read-only layers in which case it is computed)
- * @param [out] layerPtr    the pointer to hold the result
+ * @param [in]  name           The name of the file
+ * @param [in]  readOnly       Whether the file is to be opened read-only
+ * @param [out] fdPtr          A pointer to hold the file descriptor
+ * @param [out] blockCountPtr  A pointer to hold the size of the file in blocks
  *
  * @return a success or error code
  **/
-static int setupFileLayer(const char     *name,
-                          bool            readOnly,
-                          BlockCount      blockCount,
-                          PhysicalLayer **layerPtr)
+static int openLayerFile(const char *name,
+                         bool        readOnly,
+                         int        *fdPtr,
+                         BlockCount *blockCountPtr)
 {
-  int result = ASSERT(layerPtr != NULL, "layerPtr must not be NULL");
-  if (result != UDS_SUCCESS) {
-    return result;
-  }
-
-  size_t     nameLen = strlen(name);
-  FileLayer *layer;
-
-  result = ALLOCATE_EXTENDED(FileLayer, nameLen, char, "file layer", &layer);
-  if (result != UDS_SUCCESS) {
-    return result;
-  }
-
-  layer->blockCount = blockCount;
-  strcpy(layer->name, name);
-
   bool exists = false;
-
-  result = fileExists(layer->name, &exists);
+  int result = fileExists(name, &exists);
   if (result != UDS_SUCCESS) {
-    FREE(layer);
     return result;
   }
   if (!exists) {
-    FREE(layer);
     return ENOENT;
   }
 
+  int fd;
   FileAccess access = readOnly ? FU_READ_ONLY_DIRECT : FU_READ_WRITE_DIRECT;
-  result = openFile(layer->name, access, &layer->fd);
+  result = openFile(name, access, &fd);
   if (result != UDS_SUCCESS) {
-    FREE(layer);
     return result;
   }
 
   bool blockDevice = false;
-  result = isBlockDevice(layer->name, &blockDevice);
+  result = isBlockDevice(name, &blockDevice);
   if (result != UDS_SUCCESS) {
-    tryCloseFile(layer->fd);
-    FREE(layer);
+    tryCloseFile(fd);
     return result;
   }
 
-  // Make sure the physical blocks == size of the block device
   BlockCount deviceBlocks;
   if (blockDevice) {
     uint64_t bytes;
-    if (ioctl(layer->fd, BLKGETSIZE64, &bytes) < 0) {
-      result = logErrorWithStringError(errno, "get size of %s", layer->name);
-      tryCloseFile(layer->fd);
-      FREE(layer);
+    if (ioctl(fd, BLKGETSIZE64, &bytes) < 0) {
+      result = logErrorWithStringError(errno, "get size of %s", name);
+      tryCloseFile(fd);
       return result;
     }
     deviceBlocks = bytes / VDO_BLOCK_SIZE;
   } else {
     struct stat statbuf;
-    result = loggingStat(layer->name, &statbuf, __func__);
+    result = loggingStat(name, &statbuf, __func__);
     if (result != UDS_SUCCESS) {
-      tryCloseFile(layer->fd);
-      FREE(layer);
+      tryCloseFile(fd);
       return result;
     }
     deviceBlocks = statbuf.st_size / VDO_BLOCK_SIZE;
   }
 
+  *fdPtr         = fd;
+  *blockCountPtr = deviceBlocks;
+  return UDS_SUCCESS;
+}
+
+/**
+ * Internal constructor to make a file layer.
+ *
+ * @param [in]  name        the name of the underlying file
+ * @param [in]  readOnly    whether the layer is not allowed to write
+ * @param [in]  blockCount  the span of the file, in blocks (may be zero for
+ *                            read-only layers in which case it is computed)
+ * @param [out] layerPtr    the pointer to hold the result
+ *
+ * @return a success or error code
+ **/
+static int setupFileLayer(const char     *name,
+                          bool            readOnly,
+                          BlockCount      blockCount,
+                          PhysicalLayer **layerPtr)
+{
+  int result = ASSERT(layerPtr != NULL, "layerPtr must not be NULL");
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  size_t     nameLen = strlen(name);
+  FileLayer *layer;
+
+  result = ALLOCATE_EXTENDED(FileLayer, nameLen, char, "file layer", &layer);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  layer->blockCount = blockCount;
+  layer->readOnly   = readOnly;
+  layer->externalFD = -1;
+  strcpy(layer->name, name);
+
+  // Make sure the physical blocks == size of the block device
+  BlockCount deviceBlocks;
+  result = openLayerFile(layer->name, readOnly, &layer->fd, &deviceBlocks);
+  if (result != UDS_SUCCESS) {
+    FREE(layer);
+    return result;
+  }
+
   if (layer->blockCount == 0) {
     layer->blockCount = deviceBlocks;
   } else if (layer->blockCount != deviceBlocks) {
@@ -325,3 +402,38 @@ int makeReadOnlyFileLayer(const char *name, PhysicalLayer **layerPtr)
 {
   return setupFileLayer(name, true, 0, layerPtr);
 }
+
+/**********************************************************************/
+int attachExternalMetadataFile(PhysicalLayer *header, const char *name)
+{
+  FileLayer *layer = asFileLayer(header);
+  int result = ASSERT(layer->externalName == NULL,
+                      "file layer %s already has an external metadata file",
+                      layer->name);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  result = duplicateString(name, "external metadata file name",
+                           &layer->externalName);
+  if (result != UDS_SUCCESS) {
+    return result;
+  }
+
+  result = openLayerFile(name, layer->readOnly, &layer->externalFD,
+                         &layer->externalBlockCount);
+  if (result != UDS_SUCCESS) {
+    FREE(layer->externalName);
+    layer->externalName = NULL;
+    layer->externalFD   = -1;
+    return result;
+  }
+
+  return VDO_SUCCESS;
+}
+
+/**********************************************************************/
+BlockCount getExternalMetadataBlockCount(PhysicalLayer *header)
+{
+  return asFileLayer(header)->externalBlockCount;
+}
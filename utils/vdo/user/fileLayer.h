@@ -49,4 +49,28 @@ int makeFileLayer(const char     *name,
 int makeReadOnlyFileLayer(const char *name, PhysicalLayer **layerPtr)
   __attribute__((warn_unused_result));
 
+/**
+ * Attach a file to a file layer as its external metadata device. The file is
+ * opened with the same access as the layer, and its blocks are addressed
+ * starting at EXTERNAL_METADATA_ORIGIN.
+ *
+ * @param layer  The file layer
+ * @param name   The name of the external metadata file
+ *
+ * @return a success or error code
+ **/
+int attachExternalMetadataFile(PhysicalLayer *layer, const char *name)
+  __attribute__((warn_unused_result));
+
+/**
+ * Get the size of the external metadata file attached to a file layer.
+ *
+ * @param layer  The file layer
+ *
+ * @return The size of the external metadata file in blocks, or 0 if none is
+ *         attached
+ **/
+BlockCount getExternalMetadataBlockCount(PhysicalLayer *layer)
+  __attribute__((warn_unused_result));
+
 #endif // FILE_LAYER_H
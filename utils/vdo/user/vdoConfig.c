@@ -44,15 +44,17 @@
 #include "volumeGeometry.h"
 
 /**********************************************************************/
-int makeVDOLayoutFromConfig(const VDOConfig      *config,
-                            PhysicalBlockNumber   startingOffset,
-                            VDOLayout           **vdoLayoutPtr)
+int makeVDOLayoutFromConfig(const VDOConfig               *config,
+                            PhysicalBlockNumber            startingOffset,
+                            const ExternalMetadataConfig  *external,
+                            VDOLayout                    **vdoLayoutPtr)
 {
   VDOLayout *vdoLayout;
   int result = makeVDOLayout(config->physicalBlocks, startingOffset,
                              DEFAULT_BLOCK_MAP_TREE_ROOT_COUNT,
                              config->recoveryJournalSize,
-                             getSlabSummarySize(VDO_BLOCK_SIZE), &vdoLayout);
+                             getSlabSummarySize(VDO_BLOCK_SIZE), external,
+                             &vdoLayout);
   if (result != VDO_SUCCESS) {
     return result;
   }
@@ -64,18 +66,20 @@ int makeVDOLayoutFromConfig(const VDOConfig      *config,
 /**
  * Configure a new VDO.
  *
- * @param vdo  The VDO to configure
+ * @param vdo       The VDO to configure
+ * @param external  The placement of metadata on an external device (may be
+ *                  NULL if there is none)
  *
  * @return VDO_SUCCESS or an error
  **/
 __attribute__((warn_unused_result))
-static int configureVDO(VDO *vdo)
+static int configureVDO(VDO *vdo, const ExternalMetadataConfig *external)
 {
   // The layout starts 1 block past the beginning of the data region, as the
   // data region contains the super block but the layout does not.
   int result = makeVDOLayoutFromConfig(&vdo->config,
                                        getFirstBlockOffset(vdo) + 1,
-                                       &vdo->layout);
+                                       external, &vdo->layout);
   if (result != VDO_SUCCESS) {
     return result;
   }
@@ -138,20 +142,6 @@ static int configureVDO(VDO *vdo)
   return VDO_SUCCESS;
 }
 
-/**********************************************************************/
-int formatVDO(const VDOConfig *config,
-              IndexConfig     *indexConfig,
-              PhysicalLayer   *layer)
-{
-  STATIC_ASSERT(sizeof(uuid_t) == sizeof(UUID));
-
-  // Generate a UUID.
-  uuid_t uuid;
-  uuid_generate(uuid);
-
-  return formatVDOWithNonce(config, indexConfig, layer, nowUsec(), uuid);
-}
-
 /**********************************************************************/
 int calculateMinimumVDOFromConfig(const VDOConfig *config,
 				  IndexConfig     *indexConfig,
@@ -232,10 +222,13 @@ static int clearPartition(PhysicalLayer *layer,
  * @param config            The configuration parameters for the VDO
  * @param layer             The physical layer the VDO will sit on
  * @param geometry          The geometry of the physical layer
+ * @param external          The placement of metadata on an external device
+ *                          (may be NULL if there is none)
  **/
-static int makeAndWriteVDO(const VDOConfig      *config,
-                           PhysicalLayer        *layer,
-                           VolumeGeometry       *geometry)
+static int makeAndWriteVDO(const VDOConfig              *config,
+                           PhysicalLayer                *layer,
+                           VolumeGeometry               *geometry,
+                           const ExternalMetadataConfig *external)
 {
   VDO *vdo;
   int result = makeVDO(layer, &vdo);
@@ -246,7 +239,7 @@ static int makeAndWriteVDO(const VDOConfig      *config,
   vdo->config                      = *config;
   vdo->nonce                       = geometry->nonce;
   vdo->loadConfig.firstBlockOffset = getDataRegionOffset(*geometry);
-  result = configureVDO(vdo);
+  result = configureVDO(vdo, external);
   if (result != VDO_SUCCESS) {
     freeVDO(&vdo);
     return result;
@@ -266,6 +259,16 @@ static int makeAndWriteVDO(const VDOConfig      *config,
     return result;
   }
 
+  if (hasExternalMetadata(vdo->layout)) {
+    result = writeExternalMetadataLabel(layer, vdo->layout, vdo->nonce);
+    if (result != VDO_SUCCESS) {
+      logErrorWithStringError(result,
+                              "cannot label external metadata device");
+      freeVDO(&vdo);
+      return result;
+    }
+  }
+
   result = saveVDOComponents(vdo);
   if (result != VDO_SUCCESS) {
     freeVDO(&vdo);
@@ -276,12 +279,27 @@ static int makeAndWriteVDO(const VDOConfig      *config,
   return VDO_SUCCESS;
 }
 
-/**********************************************************************/
-int formatVDOWithNonce(const VDOConfig *config,
-                       IndexConfig     *indexConfig,
-                       PhysicalLayer   *layer,
-                       Nonce            nonce,
-                       UUID             uuid)
+/**
+ * Format a physical layer, and optionally an external metadata device, to
+ * function as a new VDO with the given nonce and uuid.
+ *
+ * @param config       The configuration parameters for the VDO
+ * @param indexConfig  The configuration parameters for the index
+ * @param layer        The physical layer the VDO will sit on
+ * @param external     The placement of metadata on an external device (may be
+ *                     NULL if there is none)
+ * @param nonce        The nonce for the VDO
+ * @param uuid         The uuid for the VDO
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+__attribute__((warn_unused_result))
+static int formatVDOInternal(const VDOConfig              *config,
+                             IndexConfig                  *indexConfig,
+                             PhysicalLayer                *layer,
+                             const ExternalMetadataConfig *external,
+                             Nonce                         nonce,
+                             UUID                          uuid)
 {
   int result = registerStatusCodes();
   if (result != VDO_SUCCESS) {
@@ -304,7 +322,7 @@ int formatVDOWithNonce(const VDOConfig *config,
     return result;
   }
 
-  result = makeAndWriteVDO(config, layer, &geometry);
+  result = makeAndWriteVDO(config, layer, &geometry, external);
   if (result != VDO_SUCCESS) {
     return result;
   }
@@ -313,6 +331,40 @@ int formatVDOWithNonce(const VDOConfig *config,
   return result;
 }
 
+/**********************************************************************/
+int formatVDO(const VDOConfig *config,
+              IndexConfig     *indexConfig,
+              PhysicalLayer   *layer)
+{
+  return formatVDOWithExternalMetadata(config, indexConfig, layer, NULL);
+}
+
+/**********************************************************************/
+int formatVDOWithExternalMetadata(const VDOConfig              *config,
+                                  IndexConfig                  *indexConfig,
+                                  PhysicalLayer                *layer,
+                                  const ExternalMetadataConfig *external)
+{
+  STATIC_ASSERT(sizeof(uuid_t) == sizeof(UUID));
+
+  // Generate a UUID.
+  uuid_t uuid;
+  uuid_generate(uuid);
+
+  return formatVDOInternal(config, indexConfig, layer, external, nowUsec(),
+                           uuid);
+}
+
+/**********************************************************************/
+int formatVDOWithNonce(const VDOConfig *config,
+                       IndexConfig     *indexConfig,
+                       PhysicalLayer   *layer,
+                       Nonce            nonce,
+                       UUID             uuid)
+{
+  return formatVDOInternal(config, indexConfig, layer, NULL, nonce, uuid);
+}
+
 /**
  * Load the super block and decode the VDO component.
  *
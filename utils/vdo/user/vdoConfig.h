@@ -25,6 +25,7 @@
 #include "uds.h"
 
 #include "types.h"
+#include "vdoLayout.h"
 #include "volumeGeometry.h"
 
 // The VDOConfig structure is fully declared in types.h
@@ -46,6 +47,25 @@ int formatVDO(const VDOConfig *config,
               PhysicalLayer   *layer)
   __attribute__((warn_unused_result));
 
+/**
+ * Format a physical layer to function as a new VDO whose recovery journal,
+ * and optionally slab summary, are on an external metadata device. The
+ * external device must already be attached to the layer.
+ *
+ * @param config       The configuration parameters for the VDO
+ * @param indexConfig  The configuration parameters for the index
+ * @param layer        The physical layer the VDO will sit on
+ * @param external     The placement of metadata on the external device (may
+ *                     be NULL if there is none)
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+int formatVDOWithExternalMetadata(const VDOConfig              *config,
+                                  IndexConfig                  *indexConfig,
+                                  PhysicalLayer                *layer,
+                                  const ExternalMetadataConfig *external)
+  __attribute__((warn_unused_result));
+
 
 /**
  * Calculate minimal VDO based on config parameters.
@@ -66,13 +86,16 @@ int calculateMinimumVDOFromConfig(const VDOConfig *config,
  *
  * @param [in]  config          The VDOConfig to generate a VDOLayout from
  * @param [in]  startingOffset  The start of the layouts
+ * @param [in]  external        The placement of metadata on an external
+ *                              device (may be NULL if there is none)
  * @param [out] vdoLayoutPtr    A pointer to hold the new VDOLayout
  *
  * @return VDO_SUCCESS or an error
  **/
-int makeVDOLayoutFromConfig(const VDOConfig      *config,
-                            PhysicalBlockNumber   startingOffset,
-                            VDOLayout           **vdoLayoutPtr)
+int makeVDOLayoutFromConfig(const VDOConfig               *config,
+                            PhysicalBlockNumber            startingOffset,
+                            const ExternalMetadataConfig  *external,
+                            VDOLayout                    **vdoLayoutPtr)
   __attribute__((warn_unused_result));
 
 /**
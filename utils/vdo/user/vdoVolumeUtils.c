@@ -35,20 +35,45 @@
 
 #include "fileLayer.h"
 
+/**
+ * Check whether a VDO which failed to load keeps metadata on an external
+ * device which was not attached to its layer, so that the failure can be
+ * reported clearly.
+ *
+ * @param layer    The layer from which the VDO failed to load
+ * @param decoder  The VDO decoder which was used
+ *
+ * @return <code>true</code> if the VDO has an external metadata device
+ **/
+static bool needsExternalMetadata(PhysicalLayer *layer, VDODecoder *decoder)
+{
+  VDO *vdo;
+  if (loadVDO(layer, false, decoder, &vdo) != VDO_SUCCESS) {
+    return false;
+  }
+
+  bool external = ((vdo->layout != NULL) && hasExternalMetadata(vdo->layout));
+  freeVDO(&vdo);
+  return external;
+}
+
 /**
  * Load a VDO from a file.
  *
- * @param [in]  filename        The file name
- * @param [in]  readOnly        Whether the layer should be read-only.
- * @param [in]  validateConfig  Whether the VDO should validate its config
- * @param [in]  decoder         The VDO decoder to use, if NULL, the default
- *                              decoder will be used
- * @param [out] vdoPtr          A pointer to hold the VDO
+ * @param [in]  filename          The file name
+ * @param [in]  metadataFilename  The name of the external metadata file (may
+ *                                be NULL if the VDO has none)
+ * @param [in]  readOnly          Whether the layer should be read-only.
+ * @param [in]  validateConfig    Whether the VDO should validate its config
+ * @param [in]  decoder           The VDO decoder to use, if NULL, the default
+ *                                decoder will be used
+ * @param [out] vdoPtr            A pointer to hold the VDO
  *
  * @return VDO_SUCCESS or an error code
  **/
 __attribute__((warn_unused_result))
 static int loadVDOFromFile(const char  *filename,
+                           const char  *metadataFilename,
                            bool         readOnly,
                            bool         validateConfig,
                            VDODecoder  *decoder,
@@ -75,10 +100,25 @@ static int loadVDOFromFile(const char  *filename,
     return result;
   }
 
+  if (metadataFilename != NULL) {
+    result = attachExternalMetadataFile(layer, metadataFilename);
+    if (result != VDO_SUCCESS) {
+      layer->destroy(&layer);
+      char errBuf[ERRBUF_SIZE];
+      warnx("Failed to attach external metadata file '%s' with %s",
+            metadataFilename, stringError(result, errBuf, ERRBUF_SIZE));
+      return result;
+    }
+  }
+
   // Create the VDO.
   VDO *vdo;
   result = loadVDO(layer, validateConfig, decoder, &vdo);
   if (result != VDO_SUCCESS) {
+    if ((metadataFilename == NULL) && needsExternalMetadata(layer, decoder)) {
+      warnx("'%s' has an external journal device; specify it with"
+            " --journal-device", filename);
+    }
     layer->destroy(&layer);
     char errBuf[ERRBUF_SIZE];
     warnx("allocateVDO failed for '%s' with %s",
@@ -93,13 +133,23 @@ static int loadVDOFromFile(const char  *filename,
 /**********************************************************************/
 int makeVDOFromFile(const char *filename, bool readOnly, VDO **vdoPtr)
 {
-  return loadVDOFromFile(filename, readOnly, true, NULL, vdoPtr);
+  return loadVDOFromFile(filename, NULL, readOnly, true, NULL, vdoPtr);
+}
+
+/**********************************************************************/
+int makeVDOFromFiles(const char  *filename,
+                     const char  *metadataFilename,
+                     bool         readOnly,
+                     VDO        **vdoPtr)
+{
+  return loadVDOFromFile(filename, metadataFilename, readOnly, true, NULL,
+                         vdoPtr);
 }
 
 /**********************************************************************/
 int readVDOWithoutValidation(const char *filename, VDO **vdoPtr)
 {
-  return loadVDOFromFile(filename, true, false, NULL, vdoPtr);
+  return loadVDOFromFile(filename, NULL, true, false, NULL, vdoPtr);
 }
 
 /**********************************************************************/
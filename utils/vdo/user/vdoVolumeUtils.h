@@ -38,6 +38,23 @@
 int makeVDOFromFile(const char *filename, bool readOnly, VDO **vdoPtr)
   __attribute__((warn_unused_result));
 
+/**
+ * Load a VDO whose recovery journal may be on an external metadata device.
+ *
+ * @param [in]  filename          The file name
+ * @param [in]  metadataFilename  The name of the external metadata file (may
+ *                                be NULL if the VDO has none)
+ * @param [in]  readOnly          Whether the layer should be read-only.
+ * @param [out] vdoPtr            A pointer to hold the VDO
+ *
+ * @return VDO_SUCCESS or an error code
+ **/
+int makeVDOFromFiles(const char  *filename,
+                     const char  *metadataFilename,
+                     bool         readOnly,
+                     VDO        **vdoPtr)
+  __attribute__((warn_unused_result));
+
 /**
  * Load a VDO from a file without validating the config.
  *
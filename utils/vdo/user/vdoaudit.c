@@ -33,6 +33,7 @@
 #include "memoryAlloc.h"
 #include "syscalls.h"
 
+#include "blockMap.h"
 #include "blockMapInternals.h"
 #include "numUtils.h"
 #include "recoveryJournal.h"
@@ -79,13 +80,15 @@ typedef struct {
 } SlabAudit;
 
 static const char usageString[]
-  = "[--help] [ [--summary] | [--verbose] ] [--version] filename";
+  = "[--help] [--journal-device=<device>] [ [--summary] | [--verbose] ]"
+    " [--version] filename";
 
 static const char helpString[] =
   "vdoAudit - confirm the reference counts of a VDO device\n"
   "\n"
   "SYNOPSIS\n"
-  "  vdoAudit [ [--summary] | [--verbose] ] <filename>\n"
+  "  vdoAudit [--journal-device=<device>] [ [--summary] | [--verbose] ]\n"
+  "    <filename>\n"
   "\n"
   "DESCRIPTION\n"
   "  vdoAudit adds up the logical block references to all physical\n"
@@ -97,19 +100,24 @@ static const char helpString[] =
   "\n"
   "  If --verbose is specified, a line item will be reported for each\n"
   "  inconsistency; otherwise a summary of the problems will be displayed.\n"
+  "\n"
+  "  If the VDO was formatted with an external journal device, that device\n"
+  "  must be given with --journal-device.\n"
   "\n";
 
 static struct option options[] = {
-  { "help",    no_argument, NULL, 'h' },
-  { "summary", no_argument, NULL, 's' },
-  { "verbose", no_argument, NULL, 'v' },
-  { "version", no_argument, NULL, 'V' },
-  { NULL,      0,           NULL,  0  },
+  { "help",           no_argument,       NULL, 'h' },
+  { "journal-device", required_argument, NULL, 'j' },
+  { "summary",        no_argument,       NULL, 's' },
+  { "verbose",        no_argument,       NULL, 'v' },
+  { "version",        no_argument,       NULL, 'V' },
+  { NULL,             0,                 NULL,  0  },
 };
-static char optionString[] = "hsvV";
+static char optionString[] = "hj:svV";
 
 // Command-line options
 static const char  *filename;
+static const char  *journalDevice    = NULL;
 static bool         verbose          = false;
 
 // Values loaded from the volume
@@ -123,6 +131,9 @@ static BlockCount   lbnCount         = 0;
 /** Reference counts and audit counters for each slab */
 static SlabAudit    slabs[MAX_SLABS] = { { 0, }, };
 
+/** Whether each page of the block map tier is referenced by the tree */
+static bool        *tierReferences   = NULL;
+
 // Total number of errors of each type found
 static uint64_t     badBlockMappings = 0;
 static uint64_t     badRefCounts     = 0;
@@ -236,6 +247,7 @@ static void freeAuditAllocations(void)
   for (SlabCount i = 0; i < vdo->depot->slabCount; i++) {
     FREE(slabs[i].refCounts);
   }
+  FREE(tierReferences);
   freeVDOFromFile(&vdo);
 }
 
@@ -259,6 +271,10 @@ static int processAuditArgs(int argc, char *argv[])
       exit(0);
       break;
 
+    case 'j':
+      journalDevice = optarg;
+      break;
+
     case 's':
       verbose = false;
       break;
@@ -352,6 +368,34 @@ static void reportBlockMapEntry(const char          *message,
   }
 }
 
+/**
+ * Record a reference to a tree page in the block map tier, which has no
+ * reference counts to check.
+ **/
+static void examineTierPage(BlockMapSlot        slot,
+                            Height              height,
+                            PhysicalBlockNumber pbn,
+                            BlockMappingState   state)
+{
+  BlockCount offset = pbn - getBlockMap(vdo)->tierOrigin;
+  if (offset >= getJournalBlockMapTierPagesUsed(vdo->recoveryJournal)) {
+    reportBlockMapEntry("refers to unallocated block map tier page",
+                        slot, height, pbn, state);
+  }
+
+  if (tierReferences[offset]) {
+    reportBlockMapEntry("refers to previously referenced tree page",
+                        slot, height, pbn, state);
+  }
+
+  if (isCompressed(state)) {
+    reportBlockMapEntry("refers to compressed fragment",
+                        slot, height, pbn, state);
+  }
+
+  tierReferences[offset] = true;
+}
+
 /**
  * Record the given reference in a block map page.
  *
@@ -384,6 +428,11 @@ static int examineBlockMapEntry(BlockMapSlot        slot,
     }
   }
 
+  if ((height > 0) && isBlockMapTierBlock(getBlockMap(vdo), pbn)) {
+    examineTierPage(slot, height, pbn, state);
+    return VDO_SUCCESS;
+  }
+
   SlabCount slabNumber = 0;
   int result = getSlabNumber(vdo->depot, pbn, &slabNumber);
   if (result != VDO_SUCCESS) {
@@ -735,7 +784,7 @@ int main(int argc, char *argv[])
 
   openLogger();
 
-  result = makeVDOFromFile(filename, true, &vdo);
+  result = makeVDOFromFiles(filename, journalDevice, true, &vdo);
   if (result != VDO_SUCCESS) {
     errx(1, "Could not load VDO from '%s': %s",
          filename, stringError(result, errBuf, ERRBUF_SIZE));
@@ -763,6 +812,16 @@ int main(int argc, char *argv[])
     }
   }
 
+  BlockMap *map = getBlockMap(vdo);
+  if (hasBlockMapTier(map)) {
+    result = ALLOCATE(map->tierSize, bool, __func__, &tierReferences);
+    if (result != VDO_SUCCESS) {
+      freeAuditAllocations();
+      errx(1, "Could not allocate %" PRIu64 " tier references: %s",
+           map->tierSize, stringError(result, errBuf, ERRBUF_SIZE));
+    }
+  }
+
   bool passed = auditVDO();
   if (passed) {
     warnx("All pbn references matched.\n");
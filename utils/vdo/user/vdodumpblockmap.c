@@ -33,27 +33,35 @@
 #include "vdoVolumeUtils.h"
 
 static const char usageString[]
-  = "[--help] [--lba=<lba>] [--version] <filename>";
+  = "[--help] [--journal-device=<device>] [--lba=<lba>] [--version]"
+    " <filename>";
 
 static const char helpString[] =
   "vdoDumpBlockMap - dump the LBA->PBA mappings of a VDO device\n"
   "\n"
   "SYNOPSIS\n"
-  "  vdoDumpBlockMap [--lba=<lba>] <filename>\n"
+  "  vdoDumpBlockMap [--journal-device=<device>] [--lba=<lba>]"
+  " <filename>\n"
   "\n"
   "DESCRIPTION\n"
   "  vdoDumpBlockMap dumps all (or only the specified) LBA->PBA mappings\n"
-  "  from a cleanly shut down VDO device\n";
+  "  from a cleanly shut down VDO device\n"
+  "\n"
+  "  --journal-device names the device holding the recovery journal of a\n"
+  "  VDO which was formatted with an external journal device.\n";
 
 static struct option options[] = {
-  { "help",       no_argument,       NULL, 'h' },
-  { "lba",        required_argument, NULL, 'l' },
-  { "version",    no_argument,       NULL, 'V' },
-  { NULL,         0,                 NULL,  0  },
+  { "help",           no_argument,       NULL, 'h' },
+  { "journal-device", required_argument, NULL, 'j' },
+  { "lba",            required_argument, NULL, 'l' },
+  { "version",        no_argument,       NULL, 'V' },
+  { NULL,             0,                 NULL,  0  },
 };
 
 static LogicalBlockNumber lbn = 0xFFFFFFFFFFFFFFFF;
 
+static char *journalDevice = NULL;
+
 static VDO *vdo;
 
 /**
@@ -81,7 +89,7 @@ static void usage(const char *progname, const char *usageOptionsString)
 static int processDumpArgs(int argc, char *argv[], char **filename)
 {
   int      c;
-  char    *optionString = "l:hV";
+  char    *optionString = "j:l:hV";
   while ((c = getopt_long(argc, argv, optionString, options, NULL)) != -1) {
     if (c == (int) 'h') {
       printf("%s", helpString);
@@ -93,6 +101,10 @@ static int processDumpArgs(int argc, char *argv[], char **filename)
       exit(0);
     }
 
+    if (c == (int) 'j') {
+      journalDevice = optarg;
+    }
+
     if (c == (int) 'l') {
       char *endptr;
       errno = 0;
@@ -181,7 +193,7 @@ int main(int argc, char *argv[])
 
   openLogger();
 
-  result = makeVDOFromFile(filename, true, &vdo);
+  result = makeVDOFromFiles(filename, journalDevice, true, &vdo);
   if (result != VDO_SUCCESS) {
     errx(1, "Could not load VDO from '%s': %s",
          filename, stringError(result, errBuf, ERRBUF_SIZE));
@@ -34,14 +34,15 @@
 
 #include "vdoVolumeUtils.h"
 
-static const char usageString[] = "[--help] vdoBacking";
+static const char usageString[]
+  = "[--help] [--journal-device=<device>] vdoBacking";
 
 static const char helpString[] =
   "vdodumpconfig - dump the configuration of a VDO volume from its backing\n"
   "                store.\n"
   "\n"
   "SYNOPSIS\n"
-  "  vdodumpconfig <vdoBacking>\n"
+  "  vdodumpconfig [--journal-device=<device>] <vdoBacking>\n"
   "\n"
   "DESCRIPTION\n"
   "  vdodumpconfig dumps the configuration of a VDO volume, whether or not\n"
@@ -50,16 +51,23 @@ static const char helpString[] =
   "    --help\n"
   "       Print this help message and exit.\n"
   "\n"
+  "    --journal-device=<device>\n"
+  "       Name the device holding the recovery journal of a VDO which was\n"
+  "       formatted with an external journal device.\n"
+  "\n"
   "    --version\n"
   "       Show the version of vdodmeventd.\n"
   "\n";
 
 static struct option options[] = {
   { "help",            no_argument,       NULL, 'h' },
+  { "journal-device",  required_argument, NULL, 'j' },
   { "version",         no_argument,       NULL, 'V' },
   { NULL,              0,                 NULL,  0  },
 };
 
+static char *journalDevice = NULL;
+
 /**
  * Explain how this command-line tool is used.
  *
@@ -82,13 +90,17 @@ static void usage(const char *progname)
 static const char *processArgs(int argc, char *argv[])
 {
   int   c;
-  char *optionString = "h";
+  char *optionString = "hj:";
   while ((c = getopt_long(argc, argv, optionString, options, NULL)) != -1) {
     switch (c) {
     case 'h':
       printf("%s", helpString);
       exit(0);
 
+    case 'j':
+      journalDevice = optarg;
+      break;
+
     case 'V':
       fprintf(stdout, "vdodumpconfig version is: %s\n", CURRENT_VERSION);
       exit(0);
@@ -114,7 +126,7 @@ static void readVDOConfig(const char     *vdoBacking,
                           VolumeGeometry *geometryPtr)
 {
   VDO *vdo;
-  int result = makeVDOFromFile(vdoBacking, true, &vdo);
+  int result = makeVDOFromFiles(vdoBacking, journalDevice, true, &vdo);
   if (result != VDO_SUCCESS) {
     errx(1, "Could not load VDO from '%s'", vdoBacking);
   }
@@ -48,15 +48,15 @@ enum {
 };
 
 static const char usageString[]
-  = "[--help] [--no-block-map] [--lbn=<lbn>] [--version] vdoBacking"
-    " outputFile";
+  = "[--help] [--journal-device=<device>] [--no-block-map] [--lbn=<lbn>]"
+    " [--version] vdoBacking outputFile";
 
 static const char helpString[] =
   "vdodumpmetadata - dump the metadata regions from a VDO device\n"
   "\n"
   "SYNOPSIS\n"
-  "  vdodumpmetadata [--no-block-map] [--lbn=<lbn>] <vdoBacking>"
-  "    <outputFile>\n"
+  "  vdodumpmetadata [--journal-device=<device>] [--no-block-map]"
+  "    [--lbn=<lbn>] <vdoBacking> <outputFile>\n"
   "\n"
   "DESCRIPTION\n"
   "  vdodumpmetadata dumps the metadata regions of a VDO device to\n"
@@ -73,10 +73,14 @@ static const char helpString[] =
   "  --lbn implies --no-block-map, and saves the block map page associated\n"
   "  with the specified LBN in the output file. This option may be\n"
   "  specified up to 255 times.\n"
+  "\n"
+  "  --journal-device names the device holding the recovery journal of a\n"
+  "  VDO which was formatted with an external journal device.\n"
   "\n";
 
 static struct option options[] = {
   { "help",            no_argument,       NULL, 'h' },
+  { "journal-device",  required_argument, NULL, 'j' },
   { "lbn",             required_argument, NULL, 'l' },
   { "no-block-map",    no_argument,       NULL, 'b' },
   { "version",         no_argument,       NULL, 'V' },
@@ -84,6 +88,7 @@ static struct option options[] = {
 };
 
 static char                *vdoBacking     = NULL;
+static char                *journalDevice  = NULL;
 static VDO                 *vdo            = NULL;
 
 static char                *outputFilename = NULL;
@@ -126,7 +131,7 @@ static void freeAllocations(void)
 static void processArgs(int argc, char *argv[])
 {
   int   c;
-  char *optionString = "hbl:V";
+  char *optionString = "hbj:l:V";
   while ((c = getopt_long(argc, argv, optionString, options, NULL)) != -1) {
     switch (c) {
     case 'h':
@@ -137,6 +142,10 @@ static void processArgs(int argc, char *argv[])
       noBlockMap = true;
       break;
 
+    case 'j':
+      journalDevice = optarg;
+      break;
+
     case 'l':
       // lbnCount is a uint8_t, so we need to check that we don't
       // overflow it by performing this equality check before incrementing.
@@ -219,7 +228,7 @@ static int copyPage(BlockMapSlot        slot __attribute__((unused)),
                     PhysicalBlockNumber pbn,
                     BlockMappingState   state)
 {
-  if ((height == 0) || !isValidDataBlock(vdo->depot, pbn)
+  if ((height == 0) || !isValidTreePage(vdo, pbn)
       || (state == MAPPING_STATE_UNMAPPED)) {
     // Nothing to add to the dump.
     return VDO_SUCCESS;
@@ -357,7 +366,7 @@ int main(int argc, char *argv[])
   processArgs(argc, argv);
 
   // Read input VDO.
-  result = makeVDOFromFile(vdoBacking, true, &vdo);
+  result = makeVDOFromFiles(vdoBacking, journalDevice, true, &vdo);
   if (result != VDO_SUCCESS) {
     errx(1, "Could not load VDO from '%s'", vdoBacking);
   }
@@ -74,13 +74,30 @@ static const char helpString[] =
   "  vdoformat can also modify some of the formatting parameters.\n"
   "\n"
   "OPTIONS\n"
+  "    --block-map-tier-size=<size>\n"
+  "       Reserve <size> of the journal device for block map tree pages,\n"
+  "       which are then allocated there rather than from the slabs until\n"
+  "       the reserved space is used up. A size suffix of K for kilobytes,\n"
+  "       M for megabytes, G for gigabytes, T for terabytes, or P for\n"
+  "       petabytes is optional. The default unit is megabytes. Requires\n"
+  "       --journal-device.\n"
+  "\n"
   "    --force\n"
   "       Format the block device, even if there is already a VDO formatted\n"
   "       thereupon.\n"
   "\n"
+  "    --external-slab-summary\n"
+  "       Place the slab summary on the journal device along with the\n"
+  "       recovery journal. Requires --journal-device.\n"
+  "\n"
   "    --help\n"
   "       Print this help message and exit.\n"
   "\n"
+  "    --journal-device=<device>\n"
+  "       Place the recovery journal on a separate, faster block device or\n"
+  "       file instead of on the VDO device. The journal device must be\n"
+  "       specified whenever the VDO is loaded or examined.\n"
+  "\n"
   "    --logical-size=<size>\n"
   "       Set the logical (provisioned) size of the VDO device to <size>.\n"
   "       A size suffix of K for kilobytes, M for megabytes, G for\n"
@@ -122,8 +139,11 @@ static const char helpString[] =
 
 // N.B. the option array must be in sync with the option string.
 static struct option options[] = {
+  { "block-map-tier-size",      required_argument, NULL, 'b' },
+  { "external-slab-summary",    no_argument,       NULL, 'e' },
   { "force",                    no_argument,       NULL, 'f' },
   { "help",                     no_argument,       NULL, 'h' },
+  { "journal-device",           required_argument, NULL, 'j' },
   { "logical-size",             required_argument, NULL, 'l' },
   { "slab-bits",                required_argument, NULL, 'S' },
   { "uds-checkpoint-frequency", required_argument, NULL, 'c' },
@@ -133,7 +153,7 @@ static struct option options[] = {
   { "version",                  no_argument,       NULL, 'V' },
   { NULL,                       0,                 NULL,  0  },
 };
-static char optionString[] = "fhil:S:c:m:svV";
+static char optionString[] = "b:efhij:l:S:c:m:svV";
 
 static void usage(const char *progname, const char *usageOptionsString)
 {
@@ -426,8 +446,27 @@ int main(int argc, char *argv[])
   static bool verbose = false;
   static bool force   = false;
 
+  const char             *journalDevice = NULL;
+  ExternalMetadataConfig  external      = {
+    .blockCount         = 0,
+    .slabSummary        = false,
+    .blockMapTierBlocks = 0,
+  };
+
   while ((c = getopt_long(argc, argv, optionString, options, NULL)) != -1) {
     switch (c) {
+    case 'b':
+      result = parseSize(optarg, true, &sizeArg);
+      if (result != VDO_SUCCESS) {
+        usage(argv[0], usageString);
+      }
+      external.blockMapTierBlocks = sizeArg / VDO_BLOCK_SIZE;
+      break;
+
+    case 'e':
+      external.slabSummary = true;
+      break;
+
     case 'f':
       force = true;
       break;
@@ -437,6 +476,10 @@ int main(int argc, char *argv[])
       exit(0);
       break;
 
+    case 'j':
+      journalDevice = optarg;
+      break;
+
     case 'l':
       result = parseSize(optarg, true, &sizeArg);
       if (result != VDO_SUCCESS) {
@@ -485,6 +528,16 @@ int main(int argc, char *argv[])
     usage(argv[0], usageString);
   }
 
+  if (external.slabSummary && (journalDevice == NULL)) {
+    warnx("--external-slab-summary requires --journal-device");
+    usage(argv[0], usageString);
+  }
+
+  if ((external.blockMapTierBlocks > 0) && (journalDevice == NULL)) {
+    warnx("--block-map-tier-size requires --journal-device");
+    usage(argv[0], usageString);
+  }
+
   char *filename = argv[optind];
 
   openLogger();
@@ -556,6 +609,15 @@ int main(int argc, char *argv[])
     errx(result, "makeFileLayer failed on '%s'", filename);
   }
 
+  if (journalDevice != NULL) {
+    result = attachExternalMetadataFile(layer, journalDevice);
+    if (result != VDO_SUCCESS) {
+      errx(result, "unable to attach journal device '%s'", journalDevice);
+    }
+
+    external.blockCount = getExternalMetadataBlockCount(layer);
+  }
+
   // Check whether there's already something on this device already...
   result = checkForSignaturesUsingBlkid(filename, force);
   if (result != VDO_SUCCESS) {
@@ -595,7 +657,8 @@ int main(int argc, char *argv[])
     }
   }
 
-  result = formatVDO(&config, &indexConfig, layer);
+  result = formatVDOWithExternalMetadata(&config, &indexConfig, layer,
+                                         &external);
   if (result != VDO_SUCCESS) {
     const char *extraHelp = "";
     if (result == VDO_TOO_MANY_SLABS) {
@@ -52,6 +52,10 @@ static const char helpString[] =
   "    --help\n"
   "       Print this help message and exit.\n"
   "\n"
+  "    --journal-device=<device>\n"
+  "      Names the device holding the recovery journal of a VDO which was\n"
+  "      formatted with an external journal device.\n"
+  "\n"
   "    --uuid=<uuid>\n"
   "      Sets the uuid value that is stored in the VDO device. If not\n"
   "      specified, the uuid is randomly generated.\n"
@@ -63,11 +67,12 @@ static const char helpString[] =
 // N.B. the option array must be in sync with the option string.
 static struct option options[] = {
   { "help",                     no_argument,       NULL, 'h' },
+  { "journal-device",           required_argument, NULL, 'j' },
   { "uuid",                     required_argument, NULL, 'u' },
   { "version",                  no_argument,       NULL, 'V' },
   { NULL,                       0,                 NULL,  0  },
 };
-static char optionString[] = "h:u";
+static char optionString[] = "h:j:u";
 
 static void usage(const char *progname, const char *usageOptionsString)
 {
@@ -76,6 +81,8 @@ static void usage(const char *progname, const char *usageOptionsString)
 
 uuid_t uuid;
 
+static char *journalDevice = NULL;
+
 /**
  * Parse the arguments passed; print command usage if arguments are wrong.
  *
@@ -93,6 +100,10 @@ static const char *processArgs(int argc, char *argv[])
       printf("%s", helpString);
       exit(0);
 
+    case 'j':
+      journalDevice = optarg;
+      break;
+
     case 'u':
       result = uuid_parse(optarg, uuid);
       if (result != VDO_SUCCESS) {
@@ -140,7 +151,7 @@ int main(int argc, char *argv[])
   openLogger();
 
   VDO *vdo;
-  result = makeVDOFromFile(vdoBacking, false, &vdo);
+  result = makeVDOFromFiles(vdoBacking, journalDevice, false, &vdo);
   if (result != VDO_SUCCESS) {
     errx(1, "Could not load VDO from '%s'", vdoBacking);
   }
@@ -64,7 +64,9 @@ class Field(object):
     """
     derivation = self.fieldNames.sub(r'parent.getSampleValue(stats, "\1")',
                                      string)
-    return lambda stats, parent: eval(derivation)
+    # Compile once so that repeated sampling does not re-parse the string.
+    code = compile(derivation, self.name, 'eval')
+    return lambda stats, parent: eval(code)
 
   def __init__(self, name, cType, **kwargs):
     """
@@ -96,7 +98,10 @@ class Field(object):
     self.label     = (kwargs.pop('label', self._decamel(self.name))
                       if self.display else None)
 
-    self.available = self._generateLambda(kwargs.pop('available', "True"))
+    available            = kwargs.pop('available', None)
+    self.alwaysAvailable = (available is None)
+    self.available       = self._generateLambda(available if available
+                                                else "True")
 
     # While all stats have C types, not all stats are present in the
     # struct returned via the ioctl.
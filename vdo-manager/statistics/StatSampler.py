@@ -0,0 +1,256 @@
+#
+# Copyright (c) 2020 Red Hat, Inc.
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 2
+# of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+# 02110-1301, USA.
+#
+
+"""
+  StatSampler - repeatedly sample VDO statistics and export them as text
+
+  $Id: //eng/vdo-releases/aluminum/src/python/vdo/statistics/StatSampler.py#1 $
+"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+import os
+import re
+import tempfile
+import threading
+import time
+
+from .Field import NotAvailable
+
+try:
+  from http.server import BaseHTTPRequestHandler, HTTPServer
+except ImportError:
+  from BaseHTTPServer import BaseHTTPRequestHandler, HTTPServer
+
+class DeviceSampler(object):
+  """
+  The open statistics files, C structures, and previous values for sampling
+  one VDO device.
+  """
+  def __init__(self, assays, device):
+    """
+    Open the statistics of a device for repeated sampling.
+
+    :param assays: The types of samples to take
+    :param device: The device to sample (a dictionary containing the
+                   user-supplied name and the name to use for sampling)
+    """
+    self.device  = device["user"]
+    self.name    = os.path.basename(device["sample"])
+    self.files   = []
+    self.stats   = []
+    self.metrics = []
+    for assay in assays:
+      # Take one ordinary sample so that the statistics version is checked.
+      assay.sample(self.name)
+      self.files.append(assay.open(self.name))
+      self.stats.append(assay.cType())
+      self.metrics.append([(StatSampler.metricName(label), accessor)
+                           for (label, accessor) in assay.getMetrics()])
+    self.assays   = assays
+    self.values   = [None] * sum(len(m) for m in self.metrics)
+    self.previous = None
+    self.sampled  = None
+    self.interval = None
+
+  def close(self):
+    """
+    Close the statistics files of this device.
+    """
+    for fd in self.files:
+      fd.close()
+    self.files = []
+
+  def sample(self):
+    """
+    Read the current statistics into the existing structures and save the
+    values of the previous sample so that rates can be computed.
+    """
+    self.previous, self.values = self.values, (self.previous
+                                               or [None] * len(self.values))
+    index = 0
+    for (assay, fd, stats, metrics) in zip(self.assays, self.files,
+                                           self.stats, self.metrics):
+      assay.readInto(fd, stats)
+      for (name, accessor) in metrics:
+        self.values[index] = accessor(stats)
+        index += 1
+    self.interval = (None if self.sampled is None
+                     else (time.time() - self.sampled))
+    self.sampled  = time.time()
+
+  def format(self, lines):
+    """
+    Append the text representation of the most recent sample to a list.
+
+    :param lines: The list of output lines to extend
+    """
+    device = 'device="{0}"'.format(self.device)
+    names  = (name for metrics in self.metrics for (name, accessor) in metrics)
+    for (name, value, previous) in zip(names, self.values, self.previous):
+      if isinstance(value, bytes):
+        value = value.decode("ASCII")
+      if isinstance(value, str):
+        lines.append('{0}{{{1},value="{2}"}} 1'.format(name, device, value))
+        continue
+
+      if isinstance(value, NotAvailable):
+        lines.append("{0}{{{1}}} NaN".format(name, device))
+        continue
+
+      lines.append("{0}{{{1}}} {2}".format(name, device, value))
+      if ((self.interval is None) or (self.interval <= 0)
+          or isinstance(value, float) or not isinstance(previous, int)
+          or isinstance(previous, NotAvailable)):
+        continue
+      lines.append("{0}_rate{{{1}}} {2:.3f}"
+                   .format(name, device,
+                           (value - previous) / self.interval))
+
+class StatSampler(object):
+  """
+  A long-running sampler which keeps the statistics files of a set of VDO
+  devices open, samples them at a fixed interval, and publishes the values,
+  and the rate of change of each integer value, as text in which each line
+  is 'name{device="device"} value'. The text may be written to a file, served
+  over HTTP on the local host, or both.
+  """
+  metricNameRE = re.compile(r'[^a-z0-9]+')
+
+  @classmethod
+  def metricName(cls, label):
+    """
+    Convert a statistic label to a metric name, so 'slab summary blocks
+    written' becomes 'vdo_slab_summary_blocks_written'.
+
+    :param label: The label of the statistic
+
+    :return: The metric name
+    """
+    return "vdo_" + cls.metricNameRE.sub("_", label.lower()).strip("_")
+
+  def __init__(self, assays, devices, metricsFile = None, metricsPort = None):
+    """
+    Create a sampler.
+
+    :param assays:      The types of samples to take
+    :param devices:     The devices to sample (a list of sampling
+                        dictionaries)
+    :param metricsFile: The file to which each sample is written, if any
+    :param metricsPort: The local port on which to serve samples, if any
+    """
+    self.samplers    = [DeviceSampler(assays, device) for device in devices]
+    self.metricsFile = metricsFile
+    self.text        = ""
+    self.server      = None
+    if metricsPort is not None:
+      self.server = HTTPServer(("127.0.0.1", metricsPort),
+                               self._makeHandler())
+      thread = threading.Thread(target = self.server.serve_forever)
+      thread.daemon = True
+      thread.start()
+
+  def _makeHandler(self):
+    """
+    Make the request handler class for serving the latest sample.
+
+    :return: The handler class
+    """
+    sampler = self
+
+    class MetricsHandler(BaseHTTPRequestHandler):
+      def do_GET(self):
+        body = sampler.text.encode("ASCII")
+        self.send_response(200)
+        self.send_header("Content-Type", "text/plain; version=0.0.4")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+      def log_message(self, format, *args):
+        pass
+
+    return MetricsHandler
+
+  def close(self):
+    """
+    Stop serving samples and close all of the statistics files.
+    """
+    if self.server is not None:
+      self.server.shutdown()
+      self.server.server_close()
+      self.server = None
+    for sampler in self.samplers:
+      sampler.close()
+
+  def sample(self):
+    """
+    Sample every device and publish the results.
+
+    :return: The text of the sample
+    """
+    lines = []
+    for sampler in self.samplers:
+      sampler.sample()
+      sampler.format(lines)
+    lines.append("")
+    self.text = "\n".join(lines)
+    if self.metricsFile is not None:
+      self._writeFile()
+    return self.text
+
+  def _writeFile(self):
+    """
+    Replace the metrics file with the latest sample so that readers never see
+    a partially written sample.
+    """
+    directory = os.path.dirname(os.path.abspath(self.metricsFile))
+    (fd, path) = tempfile.mkstemp(dir = directory, prefix = ".vdostats")
+    try:
+      with os.fdopen(fd, "w") as f:
+        f.write(self.text)
+      os.chmod(path, 0o644)
+      os.rename(path, self.metricsFile)
+    except Exception:
+      os.unlink(path)
+      raise
+
+  def run(self, interval, count = 0, output = None):
+    """
+    Sample at a fixed interval.
+
+    :param interval: The number of seconds between samples
+    :param count:    The number of samples to take, or 0 to sample until
+                     interrupted
+    :param output:   A function to call with the text of each sample, if any
+    """
+    taken = 0
+    deadline = time.time()
+    while (count == 0) or (taken < count):
+      text = self.sample()
+      if output is not None:
+        output(text)
+      taken += 1
+      if (count != 0) and (taken >= count):
+        break
+      # Sample on a fixed schedule rather than drifting by the sampling time.
+      deadline += interval
+      time.sleep(max(0, deadline - time.time()))
@@ -30,6 +30,7 @@ from __future__ import unicode_literals
 from ctypes import *
 import collections
 import fcntl
+import operator
 import os
 import sys
 
@@ -263,6 +264,74 @@ class StatStruct(Field):
       fd.readinto(stats)
     return self._extract(stats)
 
+  def open(self, name):
+    """
+    Open the proc file from which this structure is sampled so that it can be
+    read repeatedly with readInto().
+
+    :param name: The name of the proc directory from which to read
+
+    :return: The open, unbuffered file
+    """
+    procPath = os.path.join("/proc", self.procRoot, name, self.procFile)
+    return open(procPath, 'rb', buffering=0)
+
+  def readInto(self, fd, stats):
+    """
+    Re-read a sample into an existing C structure from a file returned by
+    open(), without allocating a new structure.
+
+    :param fd:    The open proc file
+    :param stats: The C structure (an instance of cType) to fill
+    """
+    fd.seek(0)
+    fd.readinto(stats)
+
+  def getMetrics(self, path = (), prefix = ''):
+    """
+    Get an accessor for each displayed value in this structure which reads
+    the value directly from the C structure. This allows a sampler to read
+    each value repeatedly without building a Sample for every read.
+
+    :param path:   The names of the enclosing structures, from the top level
+                   C structure down to this one
+    :param prefix: The prefix for the labels
+
+    :return: A list of (label, accessor) pairs where each accessor takes the
+             top level C structure and returns the value of one field
+    """
+    prefix += self.labelPrefix
+    metrics = []
+    for field in self.fields:
+      if not field.display:
+        continue
+
+      if isinstance(field, StatStruct):
+        metrics.extend(field.getMetrics(path + (field.name,), prefix))
+        continue
+
+      if field.inStruct and field.alwaysAvailable and (field.length == 1):
+        accessor = operator.attrgetter(".".join(path + (field.name,)))
+      else:
+        accessor = self._makeAccessor(field, path)
+      metrics.append((prefix + field.label, accessor))
+    return metrics
+
+  def _makeAccessor(self, field, path):
+    """
+    Make an accessor for a field whose value must be derived or checked for
+    availability.
+
+    :param field: The field
+    :param path:  The names of the enclosing structures of the field
+
+    :return: A function which takes the top level C structure and returns the
+             value of the field
+    """
+    getParent = (operator.attrgetter(".".join(path)) if path
+                 else (lambda stats: stats))
+    return lambda stats: field.extractSample(getParent(stats), self)
+
   def _extract(self, stats):
     """
     Extract the sampled values from the return of an ioctl call.
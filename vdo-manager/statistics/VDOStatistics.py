@@ -34,6 +34,12 @@ class BlockAllocatorStatistics(StatStruct):
       Uint64Field("slabsOpened"),
       # The number of times since loading that a slab has been re-opened
       Uint64Field("slabsReopened"),
+      # Number of metadata VIO requests which waited for the VIO pool
+      Uint64Field("vioPoolWaits"),
+      # Number of VIOs added to the VIO pool while it was exhausted
+      Uint64Field("vioPoolGrowths"),
+      # Current number of VIOs in the VIO pool
+      Uint64Field("vioPoolSize"),
     ], procRoot="vdo", **kwargs)
 
 # Counters for tracking the number of items written (blocks, requests, etc.)
@@ -78,6 +84,20 @@ class PackerStatistics(StatStruct):
       Uint64Field("compressedBlocksWritten"),
       # Number of VIOs that are pending in the packer
       Uint64Field("compressedFragmentsInPacker"),
+      # Number of fragments which waited in an input bin for under 1 ms
+      Uint64Field("residencyUnder1ms", label = "residency < 1ms"),
+      # Number of fragments which waited in an input bin for 1 ms to 10 ms
+      Uint64Field("residencyUnder10ms", label = "residency < 10ms"),
+      # Number of fragments which waited in an input bin for 10 ms to 100 ms
+      Uint64Field("residencyUnder100ms", label = "residency < 100ms"),
+      # Number of fragments which waited in an input bin for 100 ms to 1 s
+      Uint64Field("residencyUnder1s", label = "residency < 1s"),
+      # Number of fragments which waited in an input bin for 1 s or more
+      Uint64Field("residencyOver1s", label = "residency >= 1s"),
+      # Number of input bins written because a fragment exceeded the maximum residency
+      Uint64Field("residencyTimeouts"),
+      # Number of fragments packed after the preceding block of their sequential run
+      Uint64Field("runFragmentsPacked"),
     ], procRoot="vdo", **kwargs)
 
 # The statistics for the slab journals.
@@ -94,6 +114,18 @@ class SlabJournalStatistics(StatStruct):
       Uint64Field("blocksWritten"),
       # Number of times we had to wait for the tail to write
       Uint64Field("tailBusyCount"),
+      # Number of tail blocks written less than 25% full
+      Uint64Field("committedBlocksUnder25Percent", label = "committed blocks < 25%"),
+      # Number of tail blocks written at least 25% but less than 50% full
+      Uint64Field("committedBlocksUnder50Percent", label = "committed blocks < 50%"),
+      # Number of tail blocks written at least 50% but less than 75% full
+      Uint64Field("committedBlocksUnder75Percent", label = "committed blocks < 75%"),
+      # Number of tail blocks written at least 75% full but not full
+      Uint64Field("committedBlocksUnder100Percent", label = "committed blocks < 100%"),
+      # Number of tail blocks written full
+      Uint64Field("committedFullBlocks"),
+      # Number of entries not made because they cancelled out
+      Uint64Field("entriesCoalesced"),
     ], labelPrefix="slab journal", procRoot="vdo", **kwargs)
 
 # The statistics for the slab summary.
@@ -102,6 +134,10 @@ class SlabSummaryStatistics(StatStruct):
     super(SlabSummaryStatistics, self).__init__(name, [
       # Number of blocks written
       Uint64Field("blocksWritten"),
+      # Number of flushes issued before writing blocks
+      Uint64Field("flushes"),
+      # Number of block writes which shared a flush with another write
+      Uint64Field("flushesSaved"),
     ], labelPrefix="slab summary", procRoot="vdo", **kwargs)
 
 # The statistics for the reference counts.
@@ -156,6 +192,12 @@ class BlockMapStatistics(StatStruct):
       Uint64Field("pagesSaved"),
       # the number of flushes issued
       Uint64Field("flushCount"),
+      # number of tree page requests which waited for the VIO pool
+      Uint64Field("vioPoolWaits"),
+      # number of VIOs added to the VIO pool while it was exhausted
+      Uint64Field("vioPoolGrowths"),
+      # current number of VIOs in the VIO pool
+      Uint64Field("vioPoolSize"),
     ], labelPrefix="block map", procRoot="vdo", **kwargs)
 
 # The dedupe statistics from hash locks
@@ -170,8 +212,36 @@ class HashLockStatistics(StatStruct):
       Uint64Field("concurrentDataMatches"),
       # Number of writes whose hash collided with an in-flight write
       Uint64Field("concurrentHashCollisions"),
+      # Number of UDS queries skipped for regions which do not deduplicate
+      Uint64Field("dedupeQueriesBypassed"),
+      # Number of UDS queries sampled from regions which do not deduplicate
+      Uint64Field("dedupeQueriesSampled"),
+      # Number of UDS requests for data unlikely to dedupe which posted
+      Uint64Field("indexPostsSampled"),
+      # Number of UDS requests for data unlikely to dedupe which did not post
+      Uint64Field("indexPostsSkipped"),
+      # Number of dedupe verifications made against recently written data
+      Uint64Field("dedupeVerificationsCached"),
     ], procRoot="vdo", **kwargs)
 
+# The classification of writes by the logical zone stream detectors
+class StreamStatistics(StatStruct):
+  def __init__(self, name="StreamStatistics", **kwargs):
+    super(StreamStatistics, self).__init__(name, [
+      # Number of writes classified
+      Uint64Field("writesClassified"),
+      # Number of writes to regions written sequentially
+      Uint64Field("sequentialWrites"),
+      # Number of writes to regions written randomly
+      Uint64Field("randomWrites"),
+      # Number of writes to regions being overwritten frequently
+      Uint64Field("hotWrites"),
+      # Number of writes to regions whose data does not compress
+      Uint64Field("incompressibleWrites"),
+      # Number of writes to regions whose data does not deduplicate
+      Uint64Field("nonDuplicateWrites"),
+    ], labelPrefix="stream", procRoot="vdo", **kwargs)
+
 # Counts of error conditions in VDO.
 class ErrorStatistics(StatStruct):
   def __init__(self, name="ErrorStatistics", **kwargs):
@@ -238,11 +308,13 @@ class VDOStatistics(StatStruct):
       BlockMapStatistics("blockMap"),
       # The dedupe statistics from hash locks
       HashLockStatistics("hashLock"),
+      # The classification of writes by region
+      StreamStatistics("streams"),
       # Counts of error conditions
       ErrorStatistics("errors"),
     ], procFile="dedupe_stats", procRoot="vdo", **kwargs)
 
-  statisticsVersion = 31
+  statisticsVersion = 41
 
   def sample(self, device):
     sample = super(VDOStatistics, self).sample(device)
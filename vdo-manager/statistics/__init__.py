@@ -30,6 +30,7 @@ from .Field import *
 from .KernelStatistics import *
 from .LabeledValue import LabeledValue
 from .StatFormatter import *
+from .StatSampler import StatSampler
 from .StatStruct import StatStruct
 from .VDOReleaseVersions import *
 from .VDOStatistics import VDOStatistics
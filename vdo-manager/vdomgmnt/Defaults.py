@@ -92,6 +92,9 @@ class Defaults(object):
   maxDiscardSize = SizeString("4K")
   maxDiscardSizeMaxPlusOne = SizeString("4G");
   maxDiscardSizeMin = SizeString("4K");
+  maxParallel = 4
+  maxParallelMax = 100
+  maxParallelMin = 1
   mdRaid5Mode = 'on'
   physicalThreadOverheadMB = 10  # MB
   physicalThreads = 1
@@ -274,6 +277,24 @@ class Defaults(object):
           .format(Defaults.maxDiscardSizeMin,
                   Defaults.maxDiscardSizeMaxPlusOne))
     return ss
+
+  ######################################################################
+  @staticmethod
+  def checkMaxParallel(value):
+    """Checks that an option is a valid number of volumes to operate on
+    concurrently.
+
+    Arguments:
+      value (str): Value provided as an argument to the option.
+    Returns:
+      The value converted to an integer.
+    Raises:
+      ArgumentError
+
+    """
+    return Defaults._rangeCheck(Defaults.maxParallelMin,
+                                Defaults.maxParallelMax,
+                                value)
   
   ######################################################################
   @staticmethod
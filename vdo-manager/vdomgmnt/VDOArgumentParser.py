@@ -445,6 +445,7 @@ suffix is optional""").format(options
       "start",
       parents = [self.__namingOptions,
                  self._forceRebuildOptionParser(),
+                 self._maxParallelOptionParser(),
                  self.__commonOptions],
       help = highLevelHelp,
       description = description)
@@ -479,6 +480,7 @@ suffix is optional""").format(options
       "stop",
       parents = [self.__namingOptions,
                  self._forceOptionParser(),
+                 self._maxParallelOptionParser(),
                  self.__commonOptions],
       help = highLevelHelp,
       description = description)
@@ -765,6 +767,26 @@ suffix is optional""").format(options
 
     return parser
 
+  ####################################################################
+  def _maxParallelOptionParser(self):
+    parser = argparse.ArgumentParser(add_help = False)
+    parser.add_argument("--maxParallel",
+                        type = self.__optionCheck(Defaults.checkMaxParallel),
+                        default = Defaults.maxParallel,
+                        metavar = "<count>",
+                        help = _("""
+      Specifies the maximum number of VDO volumes to operate on at the same
+      time when used with --all. A volume stored on another VDO volume is
+      always started after, and stopped before, the volume beneath it. The
+      value must be at least {min} and less than or equal to {max}. The
+      default is {default}.
+                                 """)
+      .format(min = Defaults.maxParallelMin,
+              max = Defaults.maxParallelMax,
+              default = Defaults.maxParallel))
+
+    return parser
+
   ####################################################################
   def _nameOptionParser(self):
     parser = argparse.ArgumentParser(add_help = False)
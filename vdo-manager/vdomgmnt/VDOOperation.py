@@ -45,6 +45,8 @@ import __main__ as main
 import os
 import re
 import sys
+import threading
+import time
 import yaml
 
 vdoOperations = dict()
@@ -158,6 +160,104 @@ class VDOOperation(object):
       #pylint: disable=E0702
       raise exception
 
+  ######################################################################
+  def applyToVDOsInParallel(self, args, method, verb, stacking, check=None,
+                            **kwargs):
+    """Apply a method to all specified VDOs, running up to args.maxParallel
+    of them at once. A VDO stored on another VDO being operated on is
+    ordered with respect to it as directed by the 'stacking' argument. The
+    time taken for each VDO is logged, and printed when there is more than
+    one. Otherwise, this behaves like applyToVDOs().
+
+    Arguments:
+      args (dict):       The command line arguments
+      method (callable): The method to call on each VDO; will be called as
+                         method(args, vdo) from a separate thread
+      verb (str):        The past tense of the operation, for reporting
+      stacking (str):    'lowerFirst' if a VDO must wait for any VDO it is
+                         stored on, 'upperFirst' if a VDO must wait for any
+                         VDO stored on it
+      check (callable):  If not None, called as check(args, vdos) with the
+                         list of all the VDOs before any of them is operated
+                         on, to validate what the VDOs need together
+      kwargs:            Keyword args controlling what gets returned
+                          and to use when making the Configuration
+    """
+    if kwargs.get('readonly', True):
+      conf = Configuration(self.confFile, **kwargs)
+    else:
+      conf = Configuration.modifiableSingleton(self.confFile)
+
+    vdos = self.getVdoServices(args, conf)
+    if check is not None:
+      check(args, vdos)
+    prerequisites = self._getStackingPrerequisites(vdos, stacking)
+    parallelism = getattr(args, 'maxParallel', 1)
+    waiting = list(vdos)
+    active = set()
+    finished = set()
+    failures = {}
+    condition = threading.Condition()
+
+    def runMethod(vdo):
+      startTime = time.time()
+      exception = None
+      try:
+        method(args, vdo)
+      except Exception as ex:
+        exception = ex
+      elapsed = time.time() - startTime
+      if exception is None:
+        message = _("VDO {0} {1} in {2:.1f} seconds").format(vdo.getName(),
+                                                             verb, elapsed)
+      else:
+        message = _("VDO {0} failed after {1:.1f} seconds").format(
+                    vdo.getName(), elapsed)
+      self.log.info(message)
+      if len(vdos) > 1:
+        print(message)
+      with condition:
+        if exception is not None:
+          failures[vdo.getName()] = exception
+        active.discard(vdo.getName())
+        finished.add(vdo.getName())
+        condition.notify()
+
+    with condition:
+      while (len(waiting) > 0) or (len(active) > 0):
+        ready = [vdo for vdo in waiting
+                 if prerequisites[vdo.getName()] <= finished]
+        if (len(ready) == 0) and (len(active) == 0):
+          # Only a dependency cycle can leave nothing to do.
+          ready = waiting[:1]
+        if (len(ready) == 0) or (len(active) >= parallelism):
+          condition.wait()
+          continue
+
+        vdo = ready[0]
+        waiting.remove(vdo)
+        failed = [name for name in prerequisites[vdo.getName()]
+                  if name in failures]
+        if len(failed) > 0:
+          msg = _("VDO volume {0} not {1} because {2} failed").format(
+                  vdo.getName(), verb, ", ".join(sorted(failed)))
+          self.log.error(msg)
+          failures[vdo.getName()] = OperationError(
+                                      msg, exitStatus = StateExitStatus)
+          finished.add(vdo.getName())
+          continue
+
+        active.add(vdo.getName())
+        thread = threading.Thread(target = runMethod, args = (vdo,))
+        thread.start()
+
+    if not kwargs.get('readonly', True):
+      conf.persist()
+    for vdo in reversed(vdos):
+      if vdo.getName() in failures:
+        #pylint: disable=E0702
+        raise failures[vdo.getName()]
+
   ######################################################################
   def execute(self, unused_args):
     """Execute this operation. This method should be overridden by operation
@@ -230,6 +330,38 @@ class VDOOperation(object):
 
   ######################################################################
   # Protected methods
+  ######################################################################
+  def _getStackingPrerequisites(self, vdos, stacking):
+    """Find, for each of a list of VDOs, the other VDOs in the list which
+    must be finished before it may be operated on, because one of them is
+    stored on the other.
+
+    Arguments:
+      vdos (list):    The VDOServices to be operated on
+      stacking (str): 'lowerFirst' or 'upperFirst', as for
+                      applyToVDOsInParallel()
+    Returns:
+      A dictionary mapping each VDO name to a set of VDO names
+    """
+    paths = {}
+    for vdo in vdos:
+      byIdPath = os.path.join("/dev/disk/by-id", "dm-name-" + vdo.getName())
+      for path in [vdo.getPath(), byIdPath]:
+        paths[path] = vdo.getName()
+        paths[os.path.realpath(path)] = vdo.getName()
+
+    prerequisites = dict((vdo.getName(), set()) for vdo in vdos)
+    for vdo in vdos:
+      for path in set([vdo.device, os.path.realpath(vdo.device)]):
+        lower = paths.get(path)
+        if (lower is None) or (lower == vdo.getName()):
+          continue
+        if stacking == 'lowerFirst':
+          prerequisites[vdo.getName()].add(lower)
+        else:
+          prerequisites[lower].add(vdo.getName())
+    return prerequisites
+
   ######################################################################
   def _checkForName(self, args):
     """Check that the args contain a non-None name.
@@ -542,10 +674,24 @@ class StartOperation(VDOOperation):
   ######################################################################
   @exclusivelock
   def execute(self, args):
-    self.applyToVDOs(args, self._startVDO, readonly=False)
+    self.applyToVDOsInParallel(args, self._startVDO, _("started"),
+                               'lowerFirst', check=self._checkMemory,
+                               readonly=False)
 
   ######################################################################
   # Protected methods
+  ######################################################################
+  def _checkMemory(self, unused_args, vdos):
+    # Each VDO checks for its own index memory as it starts, but VDOs
+    # starting at the same time could each pass that check, so check for
+    # the memory all of them need together first.
+    starting = [vdo for vdo in vdos
+                if vdo.activated
+                   and (Command.noRunMode() or not vdo.running())]
+    if len(starting) > 1:
+      VDOService.validateAvailableMemory(sum(float(vdo.indexMemory)
+                                             for vdo in starting))
+
   ######################################################################
   @transactional
   def _startVDO(self, args, vdo):
@@ -627,7 +773,8 @@ class StopOperation(VDOOperation):
   ######################################################################
   @exclusivelock
   def execute(self, args):
-    self.applyToVDOs(args, self._stopVDO, readonly=False)
+    self.applyToVDOsInParallel(args, self._stopVDO, _("stopped"),
+                               'upperFirst', readonly=False)
 
   ######################################################################
   # Protected methods
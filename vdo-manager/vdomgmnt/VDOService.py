@@ -49,6 +49,7 @@ import re
 from socket import gethostbyname
 import stat
 import textwrap
+import threading
 import time
 import yaml
 
@@ -148,6 +149,10 @@ class VDOService(Service):
   """
   log = logging.getLogger('vdo.vdomgmnt.Service.VDOService')
   yaml_tag = "!VDOService"
+
+  # Serializes updates of the shared Configuration by VDOs which are being
+  # started or stopped in parallel.
+  _configurationLock = threading.Lock()
   
   # Key values to use accessing a dictionary created via yaml-loading the
   # output of vdo status.
@@ -228,6 +233,41 @@ class VDOService(Service):
       
   ######################################################################
   # Public methods
+  ######################################################################
+  @classmethod
+  def validateAvailableMemory(cls, indexMemory):
+    """Validates whether there is likely enough kernel memory to at least
+    create the index. If there is an error getting the info, don't
+    fail the create, just let the real check be done in vdoformat.
+
+    Arguments:
+      indexMemory - the amount of memory requested or default.
+
+    Raises:
+      ArgumentError
+    """
+    # SizeString respects locale, so convert to localized representation
+    memoryNeeded = SizeString("{0}g".format(locale.str(float(indexMemory))))
+    memoryAvailable = None
+    try:
+      result = runCommand(['grep', 'MemAvailable', '/proc/meminfo'])
+      for line in result.splitlines():
+        memory = re.match(r"MemAvailable:\s*(\d+)", line)
+        if memory is not None:
+          available = memory.group(1)
+          memoryAvailable = SizeString("{0}k".format(available))
+    except Exception:
+      pass
+
+    if memoryAvailable is None:
+      cls.log.info("Unable to validate available memory")
+      return;
+
+    if (memoryNeeded.toBytes() >= memoryAvailable.toBytes()):
+      raise ArgumentError(_("Not enough available memory in system"
+                            " for index requirement of {needed}".format(
+                              needed = memoryNeeded)));
+
   ######################################################################
   @classmethod
   def validateModifiableOptions(cls, args):
@@ -653,7 +693,7 @@ class VDOService(Service):
       return
 
     # Check that we have enough kernel memory to at least create the index.
-    self._validateAvailableMemory(self.indexMemory);
+    self.validateAvailableMemory(self.indexMemory);
 
     self._installKernelModule()
     self._checkConfiguration()
@@ -2174,8 +2214,9 @@ class VDOService(Service):
   def _setOperationState(self, state, persist=True):
     self._operationState = state
     if persist:
-      self.config.addVdo(self.getName(), self, replace = True)
-      self.config.persist()
+      with VDOService._configurationLock:
+        self.config.addVdo(self.getName(), self, replace = True)
+        self.config.persist()
 
   #####################################################################
   def _setStableName(self):
@@ -2303,40 +2344,6 @@ class VDOService(Service):
     runCommand(["dmsetup", "message", self.getName(), "0",
                 "compression", "on" if enable else "off"])
 
-  ######################################################################
-  def _validateAvailableMemory(self, indexMemory):
-    """Validates whether there is likely enough kernel memory to at least
-    create the index. If there is an error getting the info, don't
-    fail the create, just let the real check be done in vdoformat.
-
-    Arguments:
-      indexMemory - the amount of memory requested or default.
-
-    Raises:
-      ArgumentError
-    """
-    # SizeString respects locale, so convert to localized representation
-    memoryNeeded = SizeString("{0}g".format(locale.str(float(indexMemory))))
-    memoryAvailable = None
-    try:
-      result = runCommand(['grep', 'MemAvailable', '/proc/meminfo'])
-      for line in result.splitlines():
-        memory = re.match(r"MemAvailable:\s*(\d+)", line)
-        if memory is not None:
-          available = memory.group(1)
-          memoryAvailable = SizeString("{0}k".format(available))
-    except Exception:
-      pass
-
-    if memoryAvailable is None:
-      self.log.info("Unable to validate available memory")
-      return;
-
-    if (memoryNeeded.toBytes() >= memoryAvailable.toBytes()):
-      raise ArgumentError(_("Not enough available memory in system"
-                            " for index requirement of {needed}".format(
-                              needed = memoryNeeded)));
-
   ######################################################################
   def _validateModifiableThreadCounts(self, hashZone, logical, physical):
     """Validates that the hash zone, logical and physical thread counts
@@ -2365,7 +2372,7 @@ class VDOService(Service):
   ######################################################################
   def _validateParameters(self):    
     # Check that we have enough kernel memory to at least create the index.
-    self._validateAvailableMemory(self.indexMemory);
+    self.validateAvailableMemory(self.indexMemory);
 
     # Check that the hash zone, logical and physical threads are consistent.
     self._validateModifiableThreadCounts(self.hashZoneThreads,
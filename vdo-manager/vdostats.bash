@@ -24,7 +24,8 @@ _vdostats()
     local opts cur
     _init_completion || return
     COMPREPLY=()
-    opts="--help --all --human-readable --si --verbose --version"
+    opts="--help --all --count --human-readable --interval --metrics-file
+          --metrics-port --si --verbose --version"
     cur="${COMP_WORDS[COMP_CWORD]}"
     case "${cur}" in
         *)